@@ -0,0 +1,472 @@
+//
+// Created by wangsy on 2026/10/18.
+//
+
+// 训练与预测的基准测试
+// 使用合成的数据集(行数、属性数、每个属性的取值个数、结果的种类、结果的噪声均可调整)，
+// 测量 fit、generate_gain、KILC_method、transform、编译后的预测以及随机森林与梯度提升树的吞吐量与每一项的峰值内存，
+// 每一项结果输出为一行JSON，便于与之前的结果进行比较
+// 峰值内存只统计每一项测试运行期间：peak_rss_kb 为这段时间内的峰值常驻内存，rss_before_kb 为开始时的常驻内存，
+// peak_rss_delta_kb 为两者之差，即这一项测试额外使用的内存
+//
+// 用法: DesitionTreeBench [--rows N] [--attributes N] [--cardinality N] [--classes N] [--noise P]
+//                         [--threads N] [--repeat N] [--seed N] [--output FILE]
+// 不给出 --rows 时依次运行一组默认的规模
+
+#include "../src/decision_tree.h"
+#include "../src/decision_methods.h"
+#include "../src/random_forest.h"
+#include "../src/gradient_boosting.h"
+#include "../src/hoeffding_tree.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// 一组基准测试的参数
+struct BenchConfig {
+    size_t rows = 100000;
+    size_t attributes = 16;
+    size_t cardinality = 8;
+    size_t classes = 3;
+    double noise = 0.1; // 结果被替换为随机值的比例
+    size_t threads = 1;
+    size_t repeat = 3; // 每一项重复的次数，取最快的一次
+    unsigned seed = 42;
+};
+
+// 合成的数据集
+struct SyntheticData {
+    vector<string> names;
+    map<string, vector<int>> columns;
+    vector<int> labels;
+};
+
+/**
+ * 生成合成的数据集，每个属性在[0, cardinality)中均匀取值，
+ * 结果由前三个属性决定，再以noise的比例替换为随机的结果
+ * @param _config 数据集的参数
+ * @return 生成的数据集
+ */
+SyntheticData generate_data(const BenchConfig& _config) {
+    SyntheticData data;
+    mt19937 random(_config.seed);
+    for(size_t j = 0; j < _config.attributes; ++ j) {
+        data.names.push_back("a" + to_string(j));
+        vector<int>& column = data.columns[data.names.back()];
+        column.resize(_config.rows);
+        for(int& value: column) {
+            value = (int)(random() % _config.cardinality);
+        }
+    }
+    uniform_real_distribution<double> uniform(0.0, 1.0);
+    data.labels.resize(_config.rows);
+    for(size_t i = 0; i < _config.rows; ++ i) {
+        size_t signal = 0;
+        for(size_t j = 0; j < min<size_t>(3, _config.attributes); ++ j) {
+            signal = signal * 7 + (size_t)data.columns[data.names[j]][i];
+        }
+        data.labels[i] = (int)(uniform(random) < _config.noise ? random() % _config.classes : signal % _config.classes);
+    }
+    return data;
+}
+
+// 一项测试的测量结果
+struct Measurement {
+    double seconds = 0; // 最快的一次所用的秒数
+    long rss_before_kb = -1; // 开始时的常驻内存，无法读取时为-1
+    long peak_rss_kb = -1; // 运行期间的峰值常驻内存，无法读取时为-1
+};
+
+/**
+ * 从 /proc/self/status 中读取一项以KB为单位的内存统计
+ * @param _key 统计的名字，例如 VmRSS、VmHWM
+ * @return 统计的KB数，无法读取时返回-1
+ */
+long status_kb(const string& _key) {
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line)) {
+        if (line.compare(0, _key.size() + 1, _key + ":") == 0) {
+            return strtol(line.c_str() + _key.size() + 1, nullptr, 10);
+        }
+    }
+    return -1;
+}
+
+/**
+ * 测量一段时间内的峰值常驻内存
+ * 开始时通过 /proc/self/clear_refs 将进程的峰值(VmHWM)重置为当前的常驻内存，结束时读取新的峰值；
+ * 不支持重置时在后台线程中每毫秒采样一次当前的常驻内存，采样可能错过持续时间很短的峰值
+ */
+class PeakRssProbe {
+private:
+    long _before_kb; // 开始时的常驻内存
+    bool _reset; // 是否成功重置了进程的峰值
+    atomic<bool> _running; // 采样线程是否需要继续
+    atomic<long> _sampled_kb; // 采样得到的峰值
+    thread _sampler; // 采样线程，仅在不能重置峰值时使用
+
+public:
+    PeakRssProbe(): _running(true) {
+        this->_before_kb = status_kb("VmRSS");
+        ofstream clear_refs("/proc/self/clear_refs");
+        clear_refs << "5";
+        clear_refs.flush();
+        this->_reset = (bool)clear_refs && status_kb("VmHWM") >= 0;
+        this->_sampled_kb = this->_before_kb;
+        if (!this->_reset) {
+            this->_sampler = thread([this]() {
+                while (this->_running) {
+                    long rss = status_kb("VmRSS");
+                    if (rss > this->_sampled_kb) {
+                        this->_sampled_kb = rss;
+                    }
+                    this_thread::sleep_for(chrono::milliseconds(1));
+                }
+            });
+        }
+    }
+
+    ~PeakRssProbe() {
+        this->_running = false;
+        if (this->_sampler.joinable()) {
+            this->_sampler.join();
+        }
+    }
+
+    long before_kb() const {
+        return this->_before_kb;
+    }
+
+    /**
+     * 获取开始以来的峰值常驻内存
+     * @return 峰值常驻内存的KB数，无法读取时返回-1
+     */
+    long peak_kb() const {
+        if (this->_reset) {
+            return status_kb("VmHWM");
+        }
+        return max(this->_sampled_kb.load(), status_kb("VmRSS"));
+    }
+};
+
+/**
+ * 重复运行一项测试，记录最快的一次所用的秒数，以及所有重复期间的峰值常驻内存
+ * @param _repeat 重复的次数
+ * @param _body 需要测量的代码
+ * @return 测量结果
+ */
+template<class Body>
+Measurement measure(size_t _repeat, Body _body) {
+    Measurement result;
+    result.seconds = 1e300;
+    PeakRssProbe probe;
+    for(size_t i = 0; i < max<size_t>(1, _repeat); ++ i) {
+        auto begin = chrono::steady_clock::now();
+        _body();
+        result.seconds = min(result.seconds, chrono::duration<double>(chrono::steady_clock::now() - begin).count());
+    }
+    result.rss_before_kb = probe.before_kb();
+    result.peak_rss_kb = probe.peak_kb();
+    return result;
+}
+
+/**
+ * 输出一项结果
+ * @param _out 输出流
+ * @param _name 测试的名称
+ * @param _config 数据集的参数
+ * @param _measured 测量结果
+ * @param _items 一次测试处理的行数
+ * @param _extra 附加的字段，已经格式化为 ,"key":value 的形式
+ */
+void report(ostream& _out, const string& _name, const BenchConfig& _config, const Measurement& _measured,
+            size_t _items, const string& _extra = "") {
+    const double seconds = _measured.seconds;
+    const long delta = _measured.peak_rss_kb >= 0 && _measured.rss_before_kb >= 0
+            ? max(0L, _measured.peak_rss_kb - _measured.rss_before_kb) : -1;
+    _out << "{\"benchmark\":\"" << _name << "\",\"rows\":" << _config.rows << ",\"attributes\":" << _config.attributes
+         << ",\"cardinality\":" << _config.cardinality << ",\"classes\":" << _config.classes
+         << ",\"noise\":" << _config.noise << ",\"threads\":" << _config.threads
+         << ",\"seconds\":" << seconds << ",\"rows_per_second\":" << (seconds > 0 ? _items / seconds : 0)
+         << ",\"rss_before_kb\":" << _measured.rss_before_kb << ",\"peak_rss_kb\":" << _measured.peak_rss_kb
+         << ",\"peak_rss_delta_kb\":" << delta << _extra << "}" << endl;
+}
+
+/**
+ * 在一个数据集上运行所有的测试
+ * @param _config 数据集的参数
+ * @param _out 输出流
+ */
+void run(const BenchConfig& _config, ostream& _out) {
+    SyntheticData data = generate_data(_config);
+    const size_t repeat = _config.repeat;
+
+    // 条件熵：对每一个属性计算一次
+    Measurement measured = measure(repeat, [&]() {
+        volatile float sink = 0;
+        for(const string& name: data.names) {
+            sink = sink + _decision_methods_self_use::generate_gain<int, int>(data.columns[name], data.labels);
+        }
+    });
+    report(_out, "generate_gain", _config, measured, _config.rows * _config.attributes);
+
+    // 属性选择：原始数据上的接口，以及编码后的数据集上的接口
+    measured = measure(repeat, [&]() {
+        volatile size_t sink = KILC_method(data.columns, data.labels, data.names).size();
+        (void)sink;
+    });
+    report(_out, "KILC_method", _config, measured, _config.rows * _config.attributes);
+
+    Dataset<int, int> dataset(data.columns, data.labels, data.names);
+    vector<uint32_t> rows(dataset.row_count());
+    vector<size_t> attribute_index_list(dataset.attribute_count());
+    for(size_t i = 0; i < rows.size(); ++ i) {
+        rows[i] = (uint32_t)i;
+    }
+    for(size_t j = 0; j < attribute_index_list.size(); ++ j) {
+        attribute_index_list[j] = j;
+    }
+    measured = measure(repeat, [&]() {
+        volatile size_t sink = KILC_method(dataset, rows.data(), rows.size(), attribute_index_list);
+        (void)sink;
+    });
+    report(_out, "KILC_method_dataset", _config, measured, _config.rows * _config.attributes);
+
+    // 训练：包括对原始数据进行编码
+    DecisionTree<int, int> tree;
+    tree.set_thread_count(_config.threads);
+    measured = measure(repeat, [&]() {
+        tree.fit(data.columns, data.labels, data.names);
+    });
+    CompiledTree<int> compiled = tree.compile();
+    string fit_extra = ",\"nodes\":" + to_string(compiled.node_count());
+#ifdef DESITIONTREE_ENABLE_STATS
+    // 最后一次训练的各阶段统计
+    const TrainStats& stats = tree.stats();
+    ostringstream stats_extra;
+    stats_extra << ",\"vocabulary_seconds\":" << stats.vocabulary_seconds
+                << ",\"histogram_seconds\":" << stats.histogram_seconds
+                << ",\"criterion_seconds\":" << stats.criterion_seconds
+                << ",\"partition_seconds\":" << stats.partition_seconds
+                << ",\"rows_scanned\":" << stats.rows_scanned << ",\"bytes_copied\":" << stats.bytes_copied
+                << ",\"leaves\":" << stats.leaf_count << ",\"max_depth\":" << stats.max_depth
+                << ",\"tree_bytes\":" << stats.tree_bytes;
+    fit_extra += stats_extra.str();
+#endif
+    report(_out, "fit", _config, measured, _config.rows, fit_extra);
+
+    measured = measure(repeat, [&]() {
+        tree.fit(dataset, InformationGain());
+    });
+    report(_out, "fit_dataset", _config, measured, _config.rows);
+
+    // 预剪枝：限制深度与结果节点的最少行数，噪声数据上深处的小节点不再划分
+    DecisionTree<int, int> pruned;
+    pruned.set_thread_count(_config.threads);
+    pruned.set_max_depth(8);
+    pruned.set_min_child_rows(20);
+    measured = measure(repeat, [&]() {
+        pruned.fit(dataset, InformationGain());
+    });
+    report(_out, "fit_pruned", _config, measured, _config.rows,
+           ",\"nodes\":" + to_string(pruned.compile().node_count()));
+
+    // 预测：逐行的 transform，按照列下标编码后的逐行预测，以及编译后的批量预测
+    const size_t predict_rows = min<size_t>(_config.rows, 100000);
+    vector<map<string, int>> inputs(predict_rows);
+    for(size_t i = 0; i < predict_rows; ++ i) {
+        for(const string& name: data.names) {
+            inputs[i][name] = data.columns[name][i];
+        }
+    }
+    size_t correct = 0;
+    measured = measure(repeat, [&]() {
+        correct = 0;
+        vector<int> result;
+        for(size_t i = 0; i < predict_rows; ++ i) {
+            result.clear();
+            tree.transform(inputs[i], result);
+            correct += !result.empty() && result[0] == data.labels[i];
+        }
+    });
+    ostringstream accuracy;
+    accuracy << ",\"train_accuracy\":" << (double)correct / predict_rows;
+    report(_out, "transform", _config, measured, predict_rows, accuracy.str());
+
+    vector<vector<uint32_t>> encoded;
+    map<string, vector<int>> prefix;
+    for(const string& name: data.names) {
+        prefix[name].assign(data.columns[name].begin(), data.columns[name].begin() + predict_rows);
+    }
+    tree.encode(prefix, encoded);
+    vector<uint32_t> row(data.names.size());
+    measured = measure(repeat, [&]() {
+        volatile int sink = 0;
+        int result;
+        for(size_t i = 0; i < predict_rows; ++ i) {
+            for(size_t j = 0; j < row.size(); ++ j) {
+                row[j] = encoded[j][i];
+            }
+            if (tree.predict(row.data(), result)) {
+                sink = sink + result;
+            }
+        }
+    });
+    report(_out, "predict_encoded", _config, measured, predict_rows);
+
+    vector<const uint32_t*> column_pointers;
+    for(const vector<uint32_t>& column: encoded) {
+        column_pointers.push_back(column.data());
+    }
+    vector<uint32_t> results(predict_rows);
+    measured = measure(repeat, [&]() {
+        compiled.predict(column_pointers.data(), predict_rows, results.data());
+    });
+    report(_out, "compiled_predict_batch", _config, measured, predict_rows);
+
+    // 随机森林：各棵树在线程池中并行训练，共用同一个数据集
+    RandomForest<int, int> forest;
+    forest.set_tree_count(32);
+    forest.set_seed(_config.seed);
+    forest.set_thread_count(_config.threads);
+    measured = measure(repeat, [&]() {
+        forest.fit(dataset, InformationGain());
+    });
+    report(_out, "forest_fit", _config, measured, _config.rows, ",\"trees\":" + to_string(forest.size()));
+
+    // 随机森林的预测：逐行遍历所有的树，以及按照树的顺序的批量预测
+    measured = measure(repeat, [&]() {
+        volatile int sink = 0;
+        int result;
+        for(size_t i = 0; i < predict_rows; ++ i) {
+            for(size_t j = 0; j < row.size(); ++ j) {
+                row[j] = encoded[j][i];
+            }
+            if (forest.predict(row.data(), result)) {
+                sink = sink + result;
+            }
+        }
+    });
+    report(_out, "forest_predict_rows", _config, measured, predict_rows);
+    measured = measure(repeat, [&]() {
+        forest.predict(column_pointers.data(), predict_rows, results.data());
+    });
+    report(_out, "forest_predict_batch", _config, measured, predict_rows);
+
+    // 梯度提升树：以结果作为回归的目标，生长较浅的二叉树
+    GradientBoosting<int, int> boosting;
+    boosting.set_thread_count(_config.threads);
+    measured = measure(repeat, [&]() {
+        boosting.fit(dataset);
+    });
+    report(_out, "boosting_fit", _config, measured, _config.rows,
+           ",\"trees\":" + to_string(boosting.size()) + ",\"nodes\":" + to_string(boosting.node_count()));
+    vector<double> scores(predict_rows);
+    measured = measure(repeat, [&]() {
+        boosting.predict(column_pointers.data(), predict_rows, scores.data());
+    });
+    report(_out, "boosting_predict_batch", _config, measured, predict_rows);
+
+    // 在线决策树：数据按照每批10000行依次到达，只更新计数
+    const size_t batch_rows = 10000;
+    vector<map<string, vector<int>>> batch_x;
+    vector<vector<int>> batch_y;
+    for(size_t begin = 0; begin < _config.rows; begin += batch_rows) {
+        size_t end = min(begin + batch_rows, _config.rows);
+        batch_x.emplace_back();
+        for(const string& name: data.names) {
+            batch_x.back()[name].assign(data.columns[name].begin() + begin, data.columns[name].begin() + end);
+        }
+        batch_y.emplace_back(data.labels.begin() + begin, data.labels.begin() + end);
+    }
+    size_t hoeffding_leaves = 0, hoeffding_bytes = 0;
+    measured = measure(repeat, [&]() {
+        HoeffdingTree<int, int> hoeffding(data.names);
+        for(size_t batch = 0; batch < batch_x.size(); ++ batch) {
+            hoeffding.partial_fit(batch_x[batch], batch_y[batch]);
+        }
+        hoeffding_leaves = hoeffding.leaf_count();
+        hoeffding_bytes = hoeffding.memory_bytes();
+    });
+    report(_out, "hoeffding_partial_fit", _config, measured, _config.rows,
+           ",\"leaves\":" + to_string(hoeffding_leaves) + ",\"model_bytes\":" + to_string(hoeffding_bytes));
+}
+
+int main(int argc, char** argv) {
+    BenchConfig config;
+    bool single = false;
+    string output;
+    for(int i = 1; i < argc; ++ i) {
+        string option = argv[i];
+        if (i + 1 >= argc) {
+            cerr << "missing value for " << option << endl;
+            return 1;
+        }
+        string value = argv[++ i];
+        if (option == "--rows") {
+            config.rows = strtoull(value.c_str(), nullptr, 10);
+            single = true;
+        } else if (option == "--attributes") {
+            config.attributes = strtoull(value.c_str(), nullptr, 10);
+        } else if (option == "--cardinality") {
+            config.cardinality = strtoull(value.c_str(), nullptr, 10);
+        } else if (option == "--classes") {
+            config.classes = strtoull(value.c_str(), nullptr, 10);
+        } else if (option == "--noise") {
+            config.noise = strtod(value.c_str(), nullptr);
+        } else if (option == "--threads") {
+            config.threads = strtoull(value.c_str(), nullptr, 10);
+        } else if (option == "--repeat") {
+            config.repeat = strtoull(value.c_str(), nullptr, 10);
+        } else if (option == "--seed") {
+            config.seed = (unsigned)strtoul(value.c_str(), nullptr, 10);
+        } else if (option == "--output") {
+            output = value;
+        } else {
+            cerr << "unknown option " << option << endl;
+            return 1;
+        }
+    }
+    if (config.rows == 0 || config.attributes == 0 || config.cardinality == 0 || config.classes == 0) {
+        cerr << "rows, attributes, cardinality and classes must be positive" << endl;
+        return 1;
+    }
+    ofstream file;
+    if (!output.empty()) {
+        file.open(output);
+        if (!file) {
+            cerr << "cannot write " << output << endl;
+            return 1;
+        }
+    }
+    ostream& out = output.empty() ? cout : file;
+    if (single) {
+        run(config, out);
+        return 0;
+    }
+    // 默认的规模：行数、取值个数、结果种类各自变化
+    const size_t default_rows[] = {10000, 100000, 1000000};
+    for(size_t rows: default_rows) {
+        BenchConfig sized = config;
+        sized.rows = rows;
+        run(sized, out);
+    }
+    BenchConfig wide = config;
+    wide.cardinality = 64;
+    wide.classes = 10;
+    run(wide, out);
+    return 0;
+}
@@ -0,0 +1,288 @@
+//
+// Created by wangsy on 2026/10/18.
+//
+
+#ifndef DESITIONTREE_CODE_GENERATOR_H
+#define DESITIONTREE_CODE_GENERATOR_H
+
+#include "compiled_tree.h"
+#include "tree_model.h"
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace _code_generator_self_use {
+
+    /**
+     * 值在生成的代码中的写法，默认支持整数、浮点数、bool 以及 std::string
+     * 其他类型可以特化该模板，提供 type_name() 返回类型在代码中的名称，以及 write(输出流, 值) 写出一个表达式
+     */
+    template<class ValueType, class = void>
+    struct CodeLiteral;
+
+    template<class ValueType>
+    struct TypeName;
+
+#define DESITIONTREE_CODE_TYPE_NAME(type) \
+    template<> \
+    struct TypeName<type> { \
+        static const char* name() { return #type; } \
+    };
+
+    DESITIONTREE_CODE_TYPE_NAME(bool)
+    DESITIONTREE_CODE_TYPE_NAME(char)
+    DESITIONTREE_CODE_TYPE_NAME(signed char)
+    DESITIONTREE_CODE_TYPE_NAME(unsigned char)
+    DESITIONTREE_CODE_TYPE_NAME(short)
+    DESITIONTREE_CODE_TYPE_NAME(unsigned short)
+    DESITIONTREE_CODE_TYPE_NAME(int)
+    DESITIONTREE_CODE_TYPE_NAME(unsigned int)
+    DESITIONTREE_CODE_TYPE_NAME(long)
+    DESITIONTREE_CODE_TYPE_NAME(unsigned long)
+    DESITIONTREE_CODE_TYPE_NAME(long long)
+    DESITIONTREE_CODE_TYPE_NAME(unsigned long long)
+    DESITIONTREE_CODE_TYPE_NAME(float)
+    DESITIONTREE_CODE_TYPE_NAME(double)
+    DESITIONTREE_CODE_TYPE_NAME(long double)
+
+#undef DESITIONTREE_CODE_TYPE_NAME
+
+    /**
+     * 整数与bool：写为带有类型转换的十进制整数，可以用作 switch 的 case 标签
+     */
+    template<class ValueType>
+    struct CodeLiteral<ValueType, typename std::enable_if<std::is_integral<ValueType>::value>::type> {
+        static const bool integral = true; // 可以使用 switch 进行决策
+
+        static const char* type_name() {
+            return TypeName<ValueType>::name();
+        }
+
+        static void write(std::ostream& _out, const ValueType& _value) {
+            _out << "static_cast<" << type_name() << ">(";
+            if (std::is_signed<ValueType>::value && _value < 0) {
+                // 写为 (-(n - 1) - 1)，使最小值也是合法的字面量
+                _out << "-" << (unsigned long long)(-((long long)_value + 1)) << "LL - 1";
+            } else {
+                _out << (unsigned long long)_value << "ULL";
+            }
+            _out << ")";
+        }
+    };
+
+    /**
+     * 浮点数：写为足够精确的十进制小数，读回后与原来的值完全相同
+     */
+    template<class ValueType>
+    struct CodeLiteral<ValueType, typename std::enable_if<std::is_floating_point<ValueType>::value>::type> {
+        static const bool integral = false;
+
+        static const char* type_name() {
+            return TypeName<ValueType>::name();
+        }
+
+        static void write(std::ostream& _out, const ValueType& _value) {
+            if (std::isnan(_value)) {
+                _out << "std::numeric_limits<" << type_name() << ">::quiet_NaN()";
+            } else if (std::isinf(_value)) {
+                _out << (_value < 0 ? "-" : "") << "std::numeric_limits<" << type_name() << ">::infinity()";
+            } else {
+                std::ostringstream literal;
+                literal << std::setprecision(std::numeric_limits<ValueType>::max_digits10) << _value;
+                std::string text = literal.str();
+                if (text.find_first_of(".e") == std::string::npos) { // 整数值也写为浮点数字面量
+                    text += ".0";
+                }
+                // 按照类型选择后缀，字面量直接舍入到目标类型，不会经过其他精度
+                const char* suffix = std::is_same<ValueType, float>::value ? "f"
+                        : std::is_same<ValueType, long double>::value ? "L" : "";
+                _out << "static_cast<" << type_name() << ">(" << text << suffix << ")";
+            }
+        }
+    };
+
+    /**
+     * 写出一个C风格的字符串字面量，所有不可打印的字节都写为八进制转义
+     * @param _out 输出流
+     * @param _value 字符串
+     */
+    inline void write_string_literal(std::ostream& _out, const std::string& _value) {
+        _out << '"';
+        for(char c: _value) {
+            unsigned char byte = (unsigned char)c;
+            if (c == '"' || c == '\\') {
+                _out << '\\' << c;
+            } else if (byte >= 0x20 && byte < 0x7F && c != '?') { // '?' 会与之后的字符组成三字符组
+                _out << c;
+            } else {
+                _out << '\\' << (char)('0' + (byte >> 6)) << (char)('0' + ((byte >> 3) & 7))
+                     << (char)('0' + (byte & 7));
+            }
+        }
+        _out << '"';
+    }
+
+    /**
+     * 字符串：写为带有长度的 std::string 构造，字符串中可以包含 '\0'
+     */
+    template<>
+    struct CodeLiteral<std::string> {
+        static const bool integral = false;
+
+        static const char* type_name() {
+            return "std::string";
+        }
+
+        static void write(std::ostream& _out, const std::string& _value) {
+            _out << "std::string(";
+            write_string_literal(_out, _value);
+            _out << ", " << _value.size() << ")";
+        }
+    };
+
+    /**
+     * 判断一个字符串是否是合法的C++标识符
+     * @param _name 需要判断的字符串
+     * @return 合法时返回true
+     */
+    inline bool is_identifier(const std::string& _name) {
+        if (_name.empty() || std::isdigit((unsigned char)_name[0])) {
+            return false;
+        }
+        for(char c: _name) {
+            if (!std::isalnum((unsigned char)c) && c != '_') {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * 写出以某个节点为根的子树对应的语句
+     * @param _model 模型
+     * @param _arrays 编译后的决策树的节点数组
+     * @param _node 子树的根节点的下标
+     * @param _depth 当前的缩进层数
+     * @param _out 输出流
+     */
+    template<class AttributeType, class ResultType>
+    void write_node(const TreeModel<AttributeType, ResultType>& _model,
+                    const typename CompiledTree<ResultType>::Arrays& _arrays,
+                    uint32_t _node, size_t _depth, std::ostream& _out) {
+        typedef CodeLiteral<AttributeType> AttributeLiteral;
+        const uint32_t npos = CompiledTree<ResultType>::npos;
+        const std::string indent(_depth * 4, ' ');
+        if (_node == npos) { // 训练时没有对应的选择
+            _out << indent << "return false;\n";
+            return;
+        }
+        const uint32_t feature = _arrays.feature[_node];
+        if (feature == npos) { // 结果节点
+            _out << indent << "_result = ";
+            CodeLiteral<ResultType>::write(_out, _model.tree().result(_arrays.offset[_node]));
+            _out << ";\n" << indent << "return true;\n";
+            return;
+        }
+        const Vocabulary<AttributeType>& vocabulary = _model.vocabulary(feature);
+        const uint32_t* children = _arrays.children + _arrays.offset[_node];
+        if (_arrays.threshold[_node] != npos) { // 阈值决策节点，与 ThresholdNode 相同，不大于阈值时选择左子节点
+            _out << indent << "if (";
+            AttributeLiteral::write(_out, vocabulary.value(_arrays.threshold[_node]));
+            _out << " < _row[" << feature << "]) {\n";
+            write_node(_model, _arrays, children[1], _depth + 1, _out);
+            _out << indent << "} else {\n";
+            write_node(_model, _arrays, children[0], _depth + 1, _out);
+            _out << indent << "}\n";
+            return;
+        }
+        if (AttributeLiteral::integral) { // 整数可以使用 switch，由编译器选择跳转表或二分查找
+            _out << indent << "switch (_row[" << feature << "]) {\n";
+            for(uint32_t code = 0; code < _arrays.child_count[_node]; ++ code) {
+                if (children[code] == npos) {
+                    continue;
+                }
+                _out << indent << "case ";
+                AttributeLiteral::write(_out, vocabulary.value(code));
+                _out << ": {\n";
+                write_node(_model, _arrays, children[code], _depth + 1, _out);
+                _out << indent << "}\n";
+            }
+            _out << indent << "default:\n" << indent << "    return false;\n" << indent << "}\n";
+            return;
+        }
+        for(uint32_t code = 0; code < _arrays.child_count[_node]; ++ code) {
+            if (children[code] == npos) {
+                continue;
+            }
+            _out << indent << "if (_row[" << feature << "] == ";
+            AttributeLiteral::write(_out, vocabulary.value(code));
+            _out << ") {\n";
+            write_node(_model, _arrays, children[code], _depth + 1, _out);
+            _out << indent << "}\n";
+        }
+        _out << indent << "return false;\n";
+    }
+}
+
+/**
+ * 将模型生成为一个独立的C++头文件，决策树被展开为嵌套的 switch / if 语句，不包含任何运行时的模型结构
+ * 生成的头文件只依赖标准库，可以直接编译进服务中，由编译器对整棵树进行优化
+ *
+ * <p>生成的头文件包含以下内容(name为_function_name)</p>
+ * <ul>
+ *  <li>name_attribute_count: 属性的数量</li>
+ *  <li>name_attribute_names: 按照列下标排列的属性名，没有属性时只包含一个空指针(C++不允许长度为0的数组)</li>
+ *  <li>bool name(const AttributeType* _row, ResultType& _result): 对一行原始的属性值进行预测，
+ *  _row 按照列下标排列，数值型的属性与阈值直接比较，其余属性与训练时出现过的值进行比较，
+ *  训练时没有出现过的属性值返回false，预测结果与 TreeModel::predict 相同</li>
+ * </ul>
+ * 属性值与结果的类型需要有 CodeLiteral 的特化，默认支持整数、浮点数、bool 以及 std::string
+ * @param _model 需要生成的模型，可以通过 DecisionTree::export_model 或 TreeModel::load 得到
+ * @param _function_name 生成的函数名，必须是合法的C++标识符，否则抛出std::invalid_argument
+ * @param _out 输出流
+ */
+template<class AttributeType, class ResultType>
+void generate_code(const TreeModel<AttributeType, ResultType>& _model, const std::string& _function_name,
+                   std::ostream& _out) {
+    using namespace _code_generator_self_use;
+    if (!is_identifier(_function_name)) {
+        throw std::invalid_argument("generate_code: '" + _function_name + "' is not a valid identifier");
+    }
+    std::string guard;
+    for(char c: _function_name) {
+        guard.push_back((char)std::toupper((unsigned char)c));
+    }
+    guard += "_GENERATED_H";
+    _out << "// Generated from a trained decision tree, do not edit.\n\n"
+         << "#ifndef " << guard << "\n#define " << guard << "\n\n"
+         << "#include <cstddef>\n#include <limits>\n#include <string>\n\n";
+    _out << "static const std::size_t " << _function_name << "_attribute_count = " << _model.attribute_count() << ";\n\n";
+    _out << "static const char* const " << _function_name << "_attribute_names[] = {\n";
+    for(size_t index = 0; index < _model.attribute_count(); ++ index) {
+        _out << "    ";
+        write_string_literal(_out, _model.attribute_name(index));
+        _out << ",\n";
+    }
+    if (_model.attribute_count() == 0) {
+        _out << "    nullptr,\n";
+    }
+    _out << "};\n\n";
+    _out << "inline bool " << _function_name << "(const " << CodeLiteral<AttributeType>::type_name() << "* _row, "
+         << CodeLiteral<ResultType>::type_name() << "& _result) {\n";
+    const typename CompiledTree<ResultType>::Arrays arrays = _model.tree().arrays();
+    if (arrays.node_count == 0) {
+        _out << "    (void)_row;\n    (void)_result;\n    return false;\n";
+    } else {
+        write_node(_model, arrays, 0, 1, _out);
+    }
+    _out << "}\n\n#endif // " << guard << "\n";
+}
+
+#endif //DESITIONTREE_CODE_GENERATOR_H
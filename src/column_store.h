@@ -0,0 +1,545 @@
+//
+// Created by wangsy on 2026/10/18.
+//
+
+#ifndef DESITIONTREE_COLUMN_STORE_H
+#define DESITIONTREE_COLUMN_STORE_H
+
+#include "mapped_file.h"
+#include "tree_model.h"
+#include "vocabulary.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * 存放在磁盘上的列式编码数据集，用于训练超过内存大小的数据
+ * 一个目录中包含以下文件，编码与 Dataset 相同，都是从0开始按照第一次出现的顺序分配的整数
+ * <ul>
+ *  <li>columns.meta: 文本格式的描述，依次为版本、行数、结果的数量、列数，以及每一列的字典大小与属性名</li>
+ *  <li>i.col: 第i列的编码数组，每一行一个 uint32_t，使用本机的字节序</li>
+ *  <li>labels.col: 结果的编码数组，格式与列相同</li>
+ *  <li>vocabularies.bin: 魔数 "DTVOCAB\0" 与字典的数量(uint64)，之后依次是每一列的字典以及结果的字典，
+ *  每一个之前是它的字节数(uint64)并且按照8字节对齐，值的编码方式与模型文件相同(见 tree_model.h 的 ValueCodec)；
+ *  版本1的目录没有这个文件</li>
+ * </ul>
+ * 所有的编码文件都通过内存映射进行访问，常驻内存的大小由访问方式决定，可以通过 release_rows 主动移出已经处理过的部分
+ * 目录可以通过 ColumnStoreWriter 分批写入，字典与编码保存在同一个目录中，其他进程或机器可以只凭这个目录进行训练
+ */
+class ColumnStore {
+private:
+    std::string _directory; // 数据集所在的目录
+    size_t _row_count; // 数据的行数
+    size_t _class_count; // 不同结果的数量
+    std::vector<std::string> _attribute_names; // 每一列的属性名
+    std::vector<size_t> _cardinalities; // 每一列的字典大小
+    std::vector<MappedFile> _columns; // 每一列的编码文件
+    MappedFile _labels; // 结果的编码文件
+    MappedFile _vocabulary_file; // 字典文件，版本1的目录没有字典文件
+    bool _has_vocabularies; // 是否有字典文件
+
+    /**
+     * 在字典文件中找到第_index个字典，列的字典在前，结果的字典在最后，文件缺失或损坏时抛出std::runtime_error
+     * @param _index 字典的下标
+     * @param _data 该字典的起点
+     * @param _size 该字典的字节数
+     */
+    void _vocabulary_entry(size_t _index, const char*& _data, size_t& _size) const;
+
+public:
+    /**
+     * 打开一个目录中的编码数据集，文件缺失或与描述不一致时抛出std::runtime_error
+     * @param _directory 数据集所在的目录
+     */
+    explicit ColumnStore(const std::string& _directory);
+
+    size_t row_count() const;
+
+    size_t attribute_count() const;
+
+    const std::string& attribute_name(size_t _attribute_index) const;
+
+    /**
+     * 获取某一列不同属性值的数量，该列的编码一定小于这个值
+     * @param _attribute_index 列下标
+     * @return 该列的字典大小
+     */
+    size_t cardinality(size_t _attribute_index) const;
+
+    size_t class_count() const;
+
+    /**
+     * 判断某一列是否为数值型的列，编码文件中只有普通的列
+     * @return 总是返回false
+     */
+    bool is_numeric(size_t) const;
+
+    /**
+     * 获取某一列的编码数组，数组直接映射自文件
+     * @param _attribute_index 列下标
+     * @return 一个指向长度为 row_count() 的连续编码数组的指针
+     */
+    const uint32_t* column(size_t _attribute_index) const;
+
+    /**
+     * 获取结果的编码数组，数组直接映射自文件
+     * @return 一个指向长度为 row_count() 的连续编码数组的指针
+     */
+    const uint32_t* labels() const;
+
+    /**
+     * 将[_begin, _end)行在所有列以及结果上对应的页移出常驻内存
+     * @param _begin 起始行
+     * @param _end 结束行(不包含)
+     */
+    void release_rows(size_t _begin, size_t _end) const;
+
+    /**
+     * 检查[_begin, _end)行的编码都小于对应的字典大小，结果的编码都小于结果的数量，否则抛出std::runtime_error
+     * 编码文件直接映射自磁盘，训练在第一次读取每一个区间时进行检查，损坏的文件不会导致直方图越界
+     * @param _begin 起始行
+     * @param _end 结束行(不包含)
+     */
+    void check_rows(size_t _begin, size_t _end) const;
+
+    /**
+     * 读取写入时保存的每一列的字典，字典文件缺失、损坏或大小与描述不一致时抛出std::runtime_error
+     * @param AttributeType 写入时的属性值类型
+     * @return 每一列的字典，下标为列下标
+     */
+    template<class AttributeType>
+    std::vector<Vocabulary<AttributeType>> vocabularies() const;
+
+    /**
+     * 读取写入时保存的结果的字典，字典文件缺失、损坏或大小与描述不一致时抛出std::runtime_error
+     * @param ResultType 写入时的结果类型
+     * @return 结果的字典
+     */
+    template<class ResultType>
+    Vocabulary<ResultType> result_vocabulary() const;
+};
+
+/**
+ * 分批写入列式编码数据集，写入的同时维护每一列以及结果的字典
+ * 所有数据写入后调用 close 写出描述文件，之后可以使用 ColumnStore 打开该目录进行训练，
+ * 训练以及预测时使用的字典通过 vocabularies 与 result_vocabulary 获取
+ */
+template<class AttributeType, class ResultType>
+class ColumnStoreWriter {
+private:
+    std::string _directory; // 数据集所在的目录
+    std::vector<std::string> _attribute_names; // 每一列的属性名
+    std::vector<Vocabulary<AttributeType>> _vocabularies; // 每一列的字典
+    Vocabulary<ResultType> _result_vocabulary; // 结果的字典
+    std::vector<std::unique_ptr<std::ofstream>> _columns; // 每一列的编码文件
+    std::ofstream _labels; // 结果的编码文件
+    size_t _row_count; // 已经写入的行数
+    bool _closed; // 是否已经写出描述文件
+
+    /**
+     * 将一批编码追加到文件的末尾
+     * @param _file 编码文件
+     * @param _codes 编码数组
+     */
+    static void _write(std::ofstream& _file, const std::vector<uint32_t>& _codes);
+
+public:
+    /**
+     * 在一个已经存在的目录中创建编码数据集，目录中已有的同名文件会被覆盖
+     * @param _directory 数据集所在的目录
+     * @param _attribute_name_list 每一列的属性名，列下标即为该数组中的下标
+     */
+    ColumnStoreWriter(const std::string& _directory, const std::vector<std::string>& _attribute_name_list);
+
+    /**
+     * 析构时如果还没有写出描述文件，会自动调用 close
+     */
+    ~ColumnStoreWriter();
+
+    /**
+     * 追加一批数据，每一列的长度必须与_batch_y相同，否则会抛出std::invalid_argument
+     * @param _batch_x 一个map<string, vector<AttributeType>>，string代表属性的名字，相同下标的代表同一个数据
+     * @param _batch_y 一个一维数组，表示_batch_x的每一行的结果
+     */
+    void append(const std::map<std::string, std::vector<AttributeType>>& _batch_x, const std::vector<ResultType>& _batch_y);
+
+    /**
+     * 写出字典文件与描述文件并关闭所有编码文件，之后不能再追加数据
+     */
+    void close();
+
+    size_t row_count() const;
+
+    /**
+     * 获取每一列的字典，下标为列下标
+     * @return 每一列的字典
+     */
+    const std::vector<Vocabulary<AttributeType>>& vocabularies() const;
+
+    /**
+     * 获取结果的字典
+     * @return 结果的字典
+     */
+    const Vocabulary<ResultType>& result_vocabulary() const;
+};
+
+/**
+ * 打开一个目录中的编码数据集，文件缺失或与描述不一致时抛出std::runtime_error
+ * @param _directory 数据集所在的目录
+ */
+inline ColumnStore::ColumnStore(const std::string &_directory) {
+    this->_directory = _directory;
+    std::ifstream meta(_directory + "/columns.meta");
+    std::string magic;
+    int version = 0;
+    size_t attribute_count = 0;
+    std::string key;
+    if (!(meta >> magic >> version) || magic != "DTCOLUMNS" || (version != 1 && version != 2)) {
+        throw std::runtime_error("ColumnStore: '" + _directory + "/columns.meta' is missing or not supported");
+    }
+    if (!(meta >> key >> this->_row_count) || !(meta >> key >> this->_class_count) || !(meta >> key >> attribute_count)) {
+        throw std::runtime_error("ColumnStore: '" + _directory + "/columns.meta' is corrupted");
+    }
+    for(size_t index = 0; index < attribute_count; ++ index) {
+        size_t cardinality;
+        std::string name;
+        if (!(meta >> cardinality) || !std::getline(meta >> std::ws, name)) {
+            throw std::runtime_error("ColumnStore: '" + _directory + "/columns.meta' is corrupted");
+        }
+        this->_cardinalities.push_back(cardinality);
+        this->_attribute_names.push_back(name);
+        this->_columns.emplace_back(_directory + "/" + std::to_string(index) + ".col");
+    }
+    this->_labels = MappedFile(_directory + "/labels.col");
+    const size_t bytes = this->_row_count * sizeof(uint32_t);
+    for(const MappedFile& column: this->_columns) {
+        if (column.size() != bytes) {
+            throw std::runtime_error("ColumnStore: a column file in '" + _directory + "' has a wrong length");
+        }
+    }
+    if (this->_labels.size() != bytes) {
+        throw std::runtime_error("ColumnStore: '" + _directory + "/labels.col' has a wrong length");
+    }
+    this->_has_vocabularies = version >= 2;
+    if (this->_has_vocabularies) {
+        this->_vocabulary_file = MappedFile(_directory + "/vocabularies.bin");
+    }
+}
+
+inline size_t ColumnStore::row_count() const {
+    return this->_row_count;
+}
+
+inline size_t ColumnStore::attribute_count() const {
+    return this->_attribute_names.size();
+}
+
+inline const std::string &ColumnStore::attribute_name(size_t _attribute_index) const {
+    return this->_attribute_names[_attribute_index];
+}
+
+inline size_t ColumnStore::cardinality(size_t _attribute_index) const {
+    return this->_cardinalities[_attribute_index];
+}
+
+inline size_t ColumnStore::class_count() const {
+    return this->_class_count;
+}
+
+inline bool ColumnStore::is_numeric(size_t) const {
+    return false;
+}
+
+inline const uint32_t *ColumnStore::column(size_t _attribute_index) const {
+    return (const uint32_t*)this->_columns[_attribute_index].data();
+}
+
+inline const uint32_t *ColumnStore::labels() const {
+    return (const uint32_t*)this->_labels.data();
+}
+
+/**
+ * 将[_begin, _end)行在所有列以及结果上对应的页移出常驻内存
+ * @param _begin 起始行
+ * @param _end 结束行(不包含)
+ */
+inline void ColumnStore::release_rows(size_t _begin, size_t _end) const {
+    const size_t offset = _begin * sizeof(uint32_t);
+    const size_t length = (_end - _begin) * sizeof(uint32_t);
+    for(const MappedFile& column: this->_columns) {
+        column.release(offset, length);
+    }
+    this->_labels.release(offset, length);
+}
+
+/**
+ * 检查[_begin, _end)行的编码都小于对应的字典大小，结果的编码都小于结果的数量，否则抛出std::runtime_error
+ * @param _begin 起始行
+ * @param _end 结束行(不包含)
+ */
+inline void ColumnStore::check_rows(size_t _begin, size_t _end) const {
+    for(size_t index = 0; index <= this->_columns.size(); ++ index) {
+        const bool is_label = index == this->_columns.size();
+        const uint32_t* codes = is_label ? this->labels() : this->column(index);
+        const size_t limit = is_label ? this->_class_count : this->_cardinalities[index];
+        uint32_t largest = 0;
+        for(size_t row = _begin; row < _end; ++ row) {
+            largest = std::max(largest, codes[row]);
+        }
+        if (_end > _begin && largest >= limit) {
+            throw std::runtime_error("ColumnStore: '" + this->_directory + "/"
+                                     + (is_label ? std::string("labels") : std::to_string(index))
+                                     + ".col' contains a code out of range");
+        }
+    }
+}
+
+/**
+ * 在字典文件中找到第_index个字典，列的字典在前，结果的字典在最后，文件缺失或损坏时抛出std::runtime_error
+ * @param _index 字典的下标
+ * @param _data 该字典的起点
+ * @param _size 该字典的字节数
+ */
+inline void ColumnStore::_vocabulary_entry(size_t _index, const char *&_data, size_t &_size) const {
+    using namespace _tree_model_self_use;
+    const std::string path = this->_directory + "/vocabularies.bin";
+    if (!this->_has_vocabularies) {
+        throw std::runtime_error("ColumnStore: '" + this->_directory + "' was written without vocabularies");
+    }
+    const char* begin = (const char*)this->_vocabulary_file.data();
+    const size_t size = this->_vocabulary_file.size();
+    const size_t header = 8 + sizeof(uint64_t);
+    if (size < header || std::memcmp(begin, "DTVOCAB", 8) != 0
+        || get<uint64_t>(begin + 8) != this->_columns.size() + 1) {
+        throw std::runtime_error("ColumnStore: '" + path + "' is corrupted");
+    }
+    size_t position = header;
+    for(size_t index = 0; ; ++ index) {
+        position = (position + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t);
+        if (position > size || size - position < sizeof(uint64_t)) {
+            throw std::runtime_error("ColumnStore: '" + path + "' is corrupted");
+        }
+        uint64_t length = get<uint64_t>(begin + position);
+        position += sizeof(uint64_t);
+        if (length > size - position) {
+            throw std::runtime_error("ColumnStore: '" + path + "' is corrupted");
+        }
+        if (index == _index) {
+            _data = begin + position;
+            _size = (size_t)length;
+            return;
+        }
+        position += (size_t)length;
+    }
+}
+
+/**
+ * 读取写入时保存的每一列的字典，字典文件缺失、损坏或大小与描述不一致时抛出std::runtime_error
+ * @param AttributeType 写入时的属性值类型
+ * @return 每一列的字典，下标为列下标
+ */
+template<class AttributeType>
+std::vector<Vocabulary<AttributeType>> ColumnStore::vocabularies() const {
+    std::vector<Vocabulary<AttributeType>> vocabularies(this->_columns.size());
+    for(size_t index = 0; index < vocabularies.size(); ++ index) {
+        const char* data = nullptr;
+        size_t size = 0;
+        this->_vocabulary_entry(index, data, size);
+        std::vector<AttributeType> values;
+        if (!_tree_model_self_use::ValueCodec<AttributeType>::read(data, size, values)) {
+            throw std::runtime_error("ColumnStore: '" + this->_directory + "/vocabularies.bin' is corrupted");
+        }
+        for(const AttributeType& value: values) {
+            vocabularies[index].insert(value);
+        }
+        if (vocabularies[index].size() != this->_cardinalities[index] || values.size() != this->_cardinalities[index]) {
+            throw std::runtime_error("ColumnStore: '" + this->_directory + "/vocabularies.bin' does not match the columns");
+        }
+    }
+    return vocabularies;
+}
+
+/**
+ * 读取写入时保存的结果的字典，字典文件缺失、损坏或大小与描述不一致时抛出std::runtime_error
+ * @param ResultType 写入时的结果类型
+ * @return 结果的字典
+ */
+template<class ResultType>
+Vocabulary<ResultType> ColumnStore::result_vocabulary() const {
+    const char* data = nullptr;
+    size_t size = 0;
+    this->_vocabulary_entry(this->_columns.size(), data, size);
+    std::vector<ResultType> values;
+    if (!_tree_model_self_use::ValueCodec<ResultType>::read(data, size, values)) {
+        throw std::runtime_error("ColumnStore: '" + this->_directory + "/vocabularies.bin' is corrupted");
+    }
+    Vocabulary<ResultType> vocabulary;
+    for(const ResultType& value: values) {
+        vocabulary.insert(value);
+    }
+    if (vocabulary.size() != this->_class_count || values.size() != this->_class_count) {
+        throw std::runtime_error("ColumnStore: '" + this->_directory + "/vocabularies.bin' does not match the labels");
+    }
+    return vocabulary;
+}
+
+/**
+ * 在一个已经存在的目录中创建编码数据集，目录中已有的同名文件会被覆盖
+ * 无法创建文件时抛出std::runtime_error
+ * @param _directory 数据集所在的目录
+ * @param _attribute_name_list 每一列的属性名，列下标即为该数组中的下标
+ */
+template<class AttributeType, class ResultType>
+ColumnStoreWriter<AttributeType, ResultType>::ColumnStoreWriter(const std::string &_directory,
+                                                                const std::vector<std::string> &_attribute_name_list) {
+    this->_directory = _directory;
+    this->_attribute_names = _attribute_name_list;
+    this->_vocabularies.resize(_attribute_name_list.size());
+    this->_row_count = 0;
+    this->_closed = false;
+    for(size_t index = 0; index < _attribute_name_list.size(); ++ index) {
+        std::string path = _directory + "/" + std::to_string(index) + ".col";
+        this->_columns.emplace_back(new std::ofstream(path, std::ios::binary | std::ios::trunc));
+        if (!*this->_columns.back()) {
+            throw std::runtime_error("ColumnStoreWriter: cannot create '" + path + "'");
+        }
+    }
+    this->_labels.open(_directory + "/labels.col", std::ios::binary | std::ios::trunc);
+    if (!this->_labels) {
+        throw std::runtime_error("ColumnStoreWriter: cannot create '" + _directory + "/labels.col'");
+    }
+}
+
+/**
+ * 析构时如果还没有写出描述文件，会自动调用 close
+ */
+template<class AttributeType, class ResultType>
+ColumnStoreWriter<AttributeType, ResultType>::~ColumnStoreWriter() {
+    if (!this->_closed) {
+        try {
+            this->close();
+        } catch (...) { // 析构函数中不能抛出异常
+        }
+    }
+}
+
+/**
+ * 将一批编码追加到文件的末尾
+ * @param _file 编码文件
+ * @param _codes 编码数组
+ */
+template<class AttributeType, class ResultType>
+void ColumnStoreWriter<AttributeType, ResultType>::_write(std::ofstream &_file, const std::vector<uint32_t> &_codes) {
+    _file.write((const char*)_codes.data(), (std::streamsize)(_codes.size() * sizeof(uint32_t)));
+    if (!_file) {
+        throw std::runtime_error("ColumnStoreWriter: write failed");
+    }
+}
+
+/**
+ * 追加一批数据，每一列的长度必须与_batch_y相同，否则会抛出std::invalid_argument
+ * 每一批数据编码后立即写入文件，内存中只保留字典
+ * @param _batch_x 一个map<string, vector<AttributeType>>，string代表属性的名字，相同下标的代表同一个数据
+ * @param _batch_y 一个一维数组，表示_batch_x的每一行的结果
+ */
+template<class AttributeType, class ResultType>
+void ColumnStoreWriter<AttributeType, ResultType>::append(const std::map<std::string, std::vector<AttributeType>> &_batch_x,
+                                                          const std::vector<ResultType> &_batch_y) {
+    if (this->_closed) {
+        throw std::logic_error("ColumnStoreWriter: append after close");
+    }
+    std::vector<const std::vector<AttributeType>*> sources;
+    for(const std::string& name: this->_attribute_names) {
+        auto found = _batch_x.find(name);
+        if (found == _batch_x.end() || found->second.size() != _batch_y.size()) {
+            throw std::invalid_argument("ColumnStoreWriter: column '" + name + "' is missing or has a wrong length");
+        }
+        sources.push_back(&found->second);
+    }
+    std::vector<uint32_t> codes(_batch_y.size());
+    for(size_t index = 0; index < sources.size(); ++ index) {
+        for(size_t row = 0; row < codes.size(); ++ row) {
+            codes[row] = this->_vocabularies[index].insert((*sources[index])[row]);
+        }
+        _write(*this->_columns[index], codes);
+    }
+    for(size_t row = 0; row < codes.size(); ++ row) {
+        codes[row] = this->_result_vocabulary.insert(_batch_y[row]);
+    }
+    _write(this->_labels, codes);
+    this->_row_count += _batch_y.size();
+}
+
+/**
+ * 写出字典文件与描述文件并关闭所有编码文件，之后不能再追加数据
+ * 描述文件最后写出，只有描述文件存在时目录才是完整的
+ */
+template<class AttributeType, class ResultType>
+void ColumnStoreWriter<AttributeType, ResultType>::close() {
+    if (this->_closed) {
+        return;
+    }
+    this->_closed = true;
+    for(std::unique_ptr<std::ofstream>& column: this->_columns) {
+        column->close();
+    }
+    this->_labels.close();
+    {
+        using namespace _tree_model_self_use;
+        std::string body;
+        body.append("DTVOCAB", 8); // 包含结尾的 '\0'
+        put<uint64_t>(body, this->_vocabularies.size() + 1);
+        auto append = [&body](const std::string& _payload) {
+            pad(body, sizeof(uint64_t));
+            put<uint64_t>(body, _payload.size());
+            body.append(_payload);
+        };
+        for(const Vocabulary<AttributeType>& vocabulary: this->_vocabularies) {
+            std::string payload;
+            ValueCodec<AttributeType>::write(payload, vocabulary.values());
+            append(payload);
+        }
+        std::string payload;
+        ValueCodec<ResultType>::write(payload, this->_result_vocabulary.values());
+        append(payload);
+        std::ofstream file(this->_directory + "/vocabularies.bin", std::ios::binary | std::ios::trunc);
+        file.write(body.data(), (std::streamsize)body.size());
+        if (!file) {
+            throw std::runtime_error("ColumnStoreWriter: cannot write '" + this->_directory + "/vocabularies.bin'");
+        }
+    }
+    std::ofstream meta(this->_directory + "/columns.meta", std::ios::trunc);
+    meta << "DTCOLUMNS 2\n";
+    meta << "rows " << this->_row_count << "\n";
+    meta << "classes " << this->_result_vocabulary.size() << "\n";
+    meta << "columns " << this->_attribute_names.size() << "\n";
+    for(size_t index = 0; index < this->_attribute_names.size(); ++ index) {
+        meta << this->_vocabularies[index].size() << " " << this->_attribute_names[index] << "\n";
+    }
+    if (!meta) {
+        throw std::runtime_error("ColumnStoreWriter: cannot write '" + this->_directory + "/columns.meta'");
+    }
+}
+
+template<class AttributeType, class ResultType>
+size_t ColumnStoreWriter<AttributeType, ResultType>::row_count() const {
+    return this->_row_count;
+}
+
+template<class AttributeType, class ResultType>
+const std::vector<Vocabulary<AttributeType>> &ColumnStoreWriter<AttributeType, ResultType>::vocabularies() const {
+    return this->_vocabularies;
+}
+
+template<class AttributeType, class ResultType>
+const Vocabulary<ResultType> &ColumnStoreWriter<AttributeType, ResultType>::result_vocabulary() const {
+    return this->_result_vocabulary;
+}
+
+#endif //DESITIONTREE_COLUMN_STORE_H
@@ -0,0 +1,354 @@
+//
+// Created by wangsy on 2026/10/18.
+//
+
+#ifndef DESITIONTREE_COMPILED_TREE_H
+#define DESITIONTREE_COMPILED_TREE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * 编译后的决策树，由训练得到的决策树通过 DecisionTree::compile() 生成，只用于预测
+ * 所有节点按照深度优先的顺序存放在连续的数组中，节点之间通过整数下标进行关联，预测时不需要访问任何指针
+ * 输入与输出都是字典编码后的整数，编码与训练时使用的数据集(Dataset)一致
+ *
+ * <p>每个节点的信息分别存放在以下数组中(下标相同的代表同一个节点，根节点的下标为0)</p>
+ * <ul>
+ *  <li>_feature: 决策节点决策的列下标，结果节点为 npos</li>
+ *  <li>_offset: 决策节点的子节点表在 _children 中的起点，结果节点的结果编码</li>
+ *  <li>_child_count: 决策节点的子节点表的长度，子节点表的下标即为属性值的编码</li>
+ *  <li>_threshold: 阈值决策节点的阈值(分箱编码)，其余节点为 npos；阈值决策节点的子节点表长度为2，
+ *  分箱编码不大于阈值时选择下标0，否则选择下标1</li>
+ * </ul>
+ * 子节点表统一存放在 _children 中，结果编码对应的原始结果存放在 _leaf_values 中
+ *
+ * <p>节点数组既可以由编译过程写入自己持有的数组，也可以通过 attach 直接使用外部的内存(例如内存映射的模型文件，见 TreeModel)，
+ * 预测时只通过 arrays() 访问节点数组，两种方式没有区别</p>
+ */
+template<class ResultType>
+class CompiledTree {
+private:
+    std::vector<uint32_t> _feature; // 每个节点决策的列下标，结果节点为 npos
+    std::vector<uint32_t> _offset; // 决策节点的子节点表的起点，结果节点的结果编码
+    std::vector<uint32_t> _child_count; // 决策节点的子节点表的长度
+    std::vector<uint32_t> _threshold; // 阈值决策节点的阈值，其余节点为 npos
+    std::vector<uint32_t> _children; // 所有决策节点的子节点表，值为子节点的下标，没有子节点时为 npos
+    std::vector<ResultType> _leaf_values; // 结果的字典，下标为结果编码
+
+public:
+    /**
+     * 所有节点数组的起点以及长度
+     */
+    struct Arrays {
+        const uint32_t* feature;
+        const uint32_t* offset;
+        const uint32_t* child_count;
+        const uint32_t* threshold;
+        const uint32_t* children;
+        size_t node_count; // feature、offset、child_count、threshold 的长度
+        size_t children_count; // children 的长度
+    };
+
+private:
+    Arrays _external {}; // 外部的节点数组，仅在 _owner 不为空时有效
+    std::shared_ptr<const void> _owner; // 持有外部的节点数组所在的内存，为空时使用自己持有的数组
+
+public:
+    /**
+     * 表示不存在的节点、未知的属性值以及无法给出的预测结果
+     */
+    static const uint32_t npos = 0xFFFFFFFFu;
+
+    /**
+     * 批量预测时每一组的行数
+     */
+    static const size_t BLOCK_SIZE = 256;
+
+    /**
+     * 添加一个结果节点
+     * @param _result_code 该节点的结果编码
+     * @return 新节点的下标
+     */
+    uint32_t add_leaf(uint32_t _result_code);
+
+    /**
+     * 添加一个决策节点，它的所有子节点初始都为 npos
+     * @param _feature 该节点决策的列下标
+     * @param _child_count 子节点表的长度，即该列的字典大小
+     * @return 新节点的下标
+     */
+    uint32_t add_decision(uint32_t _feature, uint32_t _child_count);
+
+    /**
+     * 添加一个阈值决策节点，它的两个子节点初始都为 npos
+     * @param _feature 该节点决策的列下标，必须是数值型的列
+     * @param _threshold 阈值(分箱编码)，分箱编码不大于该值时选择子节点0，否则选择子节点1
+     * @return 新节点的下标
+     */
+    uint32_t add_threshold(uint32_t _feature, uint32_t _threshold);
+
+    /**
+     * 设置决策节点的一个子节点
+     * @param _node 决策节点的下标
+     * @param _code 属性值的编码
+     * @param _child 子节点的下标
+     */
+    void set_child(uint32_t _node, uint32_t _code, uint32_t _child);
+
+    /**
+     * 设置结果的字典
+     * @param _leaf_values 下标为结果编码，值为原始结果
+     */
+    void set_leaf_values(const std::vector<ResultType>& _leaf_values);
+
+    /**
+     * 直接使用外部的节点数组，不进行复制，之前添加的节点会被丢弃，之后不能再添加节点
+     * @param _arrays 外部的节点数组，在_owner被释放之前必须一直有效
+     * @param _owner 持有外部节点数组所在的内存，会随着编译后的决策树一起被复制
+     */
+    void attach(const Arrays& _arrays, std::shared_ptr<const void> _owner);
+
+    /**
+     * 获取所有节点数组，用于预测以及保存
+     * @return 节点数组的起点以及长度
+     */
+    Arrays arrays() const;
+
+    /**
+     * 获取结果的字典
+     * @return 下标为结果编码，值为原始结果
+     */
+    const std::vector<ResultType>& leaf_values() const;
+
+    /**
+     * 获取节点的数量
+     * @return 节点的数量
+     */
+    size_t node_count() const;
+
+    /**
+     * 对编码后的一行数据进行预测
+     * @param _row 按照列下标排列的属性值编码，未知的属性值使用 npos 表示
+     * @return 预测的结果编码，无法给出预测时(树为空、属性值未知)返回 npos
+     */
+    uint32_t predict(const uint32_t* _row) const;
+
+    /**
+     * 对编码后的一批数据进行预测，数据按列存放
+     * 数据按照 BLOCK_SIZE 行一组进行处理，同一组中的所有行同时逐层向下走，每一层对组内所有行各前进一步，
+     * 不同行的访存相互独立，可以被处理器同时发出，组内用到的节点与数据也都能留在缓存中
+     * @param _columns 按照列下标排列的列指针，_columns[feature][row] 为第row行在该列上的属性值编码
+     * @param _row_count 数据的行数
+     * @param _results 调用者提供的长度为_row_count的数组，写入每一行的预测结果编码，无法给出预测时为 npos
+     */
+    void predict(const uint32_t* const* _columns, size_t _row_count, uint32_t* _results) const;
+
+    /**
+     * 获取结果编码对应的原始结果
+     * @param _result_code 结果编码，必须是 predict 返回的有效编码
+     * @return 原始结果
+     */
+    const ResultType& result(uint32_t _result_code) const;
+};
+
+template<class ResultType>
+const uint32_t CompiledTree<ResultType>::npos;
+
+template<class ResultType>
+const size_t CompiledTree<ResultType>::BLOCK_SIZE;
+
+/**
+ * 添加一个结果节点
+ * @param _result_code 该节点的结果编码
+ * @return 新节点的下标
+ */
+template<class ResultType>
+uint32_t CompiledTree<ResultType>::add_leaf(uint32_t _result_code) {
+    this->_feature.push_back(npos);
+    this->_offset.push_back(_result_code);
+    this->_child_count.push_back(0);
+    this->_threshold.push_back(npos);
+    return (uint32_t)(this->_feature.size() - 1);
+}
+
+/**
+ * 添加一个决策节点，它的所有子节点初始都为 npos
+ * @param _feature 该节点决策的列下标
+ * @param _child_count 子节点表的长度，即该列的字典大小
+ * @return 新节点的下标
+ */
+template<class ResultType>
+uint32_t CompiledTree<ResultType>::add_decision(uint32_t _feature, uint32_t _child_count) {
+    this->_feature.push_back(_feature);
+    this->_offset.push_back((uint32_t)this->_children.size());
+    this->_child_count.push_back(_child_count);
+    this->_threshold.push_back(npos);
+    this->_children.resize(this->_children.size() + _child_count, npos);
+    return (uint32_t)(this->_feature.size() - 1);
+}
+
+/**
+ * 添加一个阈值决策节点，它的两个子节点初始都为 npos
+ * @param _feature 该节点决策的列下标，必须是数值型的列
+ * @param _threshold 阈值(分箱编码)，分箱编码不大于该值时选择子节点0，否则选择子节点1
+ * @return 新节点的下标
+ */
+template<class ResultType>
+uint32_t CompiledTree<ResultType>::add_threshold(uint32_t _feature, uint32_t _threshold) {
+    uint32_t index = this->add_decision(_feature, 2);
+    this->_threshold[index] = _threshold;
+    return index;
+}
+
+/**
+ * 设置决策节点的一个子节点
+ * @param _node 决策节点的下标
+ * @param _code 属性值的编码
+ * @param _child 子节点的下标
+ */
+template<class ResultType>
+void CompiledTree<ResultType>::set_child(uint32_t _node, uint32_t _code, uint32_t _child) {
+    this->_children[this->_offset[_node] + _code] = _child;
+}
+
+template<class ResultType>
+void CompiledTree<ResultType>::set_leaf_values(const std::vector<ResultType> &_leaf_values) {
+    this->_leaf_values = _leaf_values;
+}
+
+/**
+ * 直接使用外部的节点数组，不进行复制，之前添加的节点会被丢弃，之后不能再添加节点
+ * @param _arrays 外部的节点数组，在_owner被释放之前必须一直有效
+ * @param _owner 持有外部节点数组所在的内存，会随着编译后的决策树一起被复制
+ */
+template<class ResultType>
+void CompiledTree<ResultType>::attach(const Arrays &_arrays, std::shared_ptr<const void> _owner) {
+    this->_feature.clear();
+    this->_offset.clear();
+    this->_child_count.clear();
+    this->_threshold.clear();
+    this->_children.clear();
+    this->_external = _arrays;
+    this->_owner = std::move(_owner);
+}
+
+/**
+ * 获取所有节点数组，用于预测以及保存
+ * @return 节点数组的起点以及长度
+ */
+template<class ResultType>
+typename CompiledTree<ResultType>::Arrays CompiledTree<ResultType>::arrays() const {
+    if (this->_owner) {
+        return this->_external;
+    }
+    return Arrays {this->_feature.data(), this->_offset.data(), this->_child_count.data(), this->_threshold.data(),
+                   this->_children.data(), this->_feature.size(), this->_children.size()};
+}
+
+template<class ResultType>
+const std::vector<ResultType> &CompiledTree<ResultType>::leaf_values() const {
+    return this->_leaf_values;
+}
+
+template<class ResultType>
+size_t CompiledTree<ResultType>::node_count() const {
+    return this->arrays().node_count;
+}
+
+/**
+ * 对编码后的一行数据进行预测
+ * 从根节点开始，每一层只需要读取当前节点的列下标与子节点表，通过整数下标跳转到下一个节点
+ * @param _row 按照列下标排列的属性值编码，未知的属性值使用 npos 表示
+ * @return 预测的结果编码，无法给出预测时(树为空、属性值未知)返回 npos
+ */
+template<class ResultType>
+uint32_t CompiledTree<ResultType>::predict(const uint32_t *_row) const {
+    const Arrays arrays = this->arrays();
+    if (arrays.node_count == 0) {
+        return npos;
+    }
+    const uint32_t* feature = arrays.feature;
+    const uint32_t* offset = arrays.offset;
+    const uint32_t* child_count = arrays.child_count;
+    const uint32_t* children = arrays.children;
+    const uint32_t* threshold = arrays.threshold;
+    uint32_t node = 0;
+    while (feature[node] != npos) {
+        uint32_t code = _row[feature[node]];
+        if (threshold[node] != npos && code != npos) { // 阈值决策节点，转换为子节点表的下标
+            code = code > threshold[node];
+        }
+        if (code >= child_count[node]) { // 训练时没有出现过的属性值
+            return npos;
+        }
+        node = children[offset[node] + code];
+        if (node == npos) {
+            return npos;
+        }
+    }
+    return offset[node];
+}
+
+/**
+ * 对编码后的一批数据进行预测，数据按列存放
+ * 数据按照 BLOCK_SIZE 行一组进行处理，同一组中的所有行同时逐层向下走，每一层对组内所有行各前进一步，
+ * 到达结果节点的行会被移出当前组，直到组内所有行都得到结果
+ * @param _columns 按照列下标排列的列指针，_columns[feature][row] 为第row行在该列上的属性值编码
+ * @param _row_count 数据的行数
+ * @param _results 调用者提供的长度为_row_count的数组，写入每一行的预测结果编码，无法给出预测时为 npos
+ */
+template<class ResultType>
+void CompiledTree<ResultType>::predict(const uint32_t *const *_columns, size_t _row_count, uint32_t *_results) const {
+    const Arrays arrays = this->arrays();
+    if (arrays.node_count == 0) {
+        std::fill(_results, _results + _row_count, npos);
+        return;
+    }
+    const uint32_t* feature = arrays.feature;
+    const uint32_t* offset = arrays.offset;
+    const uint32_t* child_count = arrays.child_count;
+    const uint32_t* children = arrays.children;
+    const uint32_t* threshold = arrays.threshold;
+    uint32_t nodes[BLOCK_SIZE]; // 组内每一行当前所在的节点
+    uint32_t active[BLOCK_SIZE]; // 组内还没有得到结果的行
+    for(size_t begin = 0; begin < _row_count; begin += BLOCK_SIZE) {
+        size_t active_count = std::min(BLOCK_SIZE, _row_count - begin);
+        for(size_t i = 0; i < active_count; ++ i) {
+            nodes[i] = 0;
+            active[i] = (uint32_t)i;
+        }
+        while (active_count > 0) {
+            size_t next_count = 0;
+            for(size_t i = 0; i < active_count; ++ i) {
+                const uint32_t slot = active[i];
+                const uint32_t node = nodes[slot];
+                if (feature[node] == npos) { // 到达结果节点
+                    _results[begin + slot] = offset[node];
+                    continue;
+                }
+                uint32_t code = _columns[feature[node]][begin + slot];
+                if (threshold[node] != npos && code != npos) { // 阈值决策节点，转换为子节点表的下标
+                    code = code > threshold[node];
+                }
+                const uint32_t child = code < child_count[node] ? children[offset[node] + code] : npos;
+                if (child == npos) { // 训练时没有出现过的属性值
+                    _results[begin + slot] = npos;
+                    continue;
+                }
+                nodes[slot] = child;
+                active[next_count ++] = slot;
+            }
+            active_count = next_count;
+        }
+    }
+}
+
+template<class ResultType>
+const ResultType &CompiledTree<ResultType>::result(uint32_t _result_code) const {
+    return this->_leaf_values[_result_code];
+}
+
+#endif //DESITIONTREE_COMPILED_TREE_H
@@ -0,0 +1,478 @@
+//
+// Created by wangsy on 2026/10/18.
+//
+
+#ifndef DESITIONTREE_DATASET_H
+#define DESITIONTREE_DATASET_H
+
+#include "thread_pool.h"
+#include "vocabulary.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace _dataset_self_use {
+
+    /**
+     * 查找一个数值所属的分箱，分箱的上界按照从小到大排列，返回第一个上界不小于该值的分箱，
+     * 大于所有上界的值属于最后一个分箱。NaN 与任何上界比较都不成立，因此属于第一个分箱(编码0)
+     * @param _upper_bounds 每个分箱的上界(包含)
+     * @param _value 需要查找的值
+     * @return 分箱的编码
+     */
+    template<class ValueType>
+    uint32_t find_bin(const std::vector<ValueType>& _upper_bounds, const ValueType& _value) {
+        size_t bin = std::lower_bound(_upper_bounds.begin(), _upper_bounds.end(), _value) - _upper_bounds.begin();
+        return (uint32_t)std::min(bin, _upper_bounds.size() - 1);
+    }
+
+    template<class ValueType>
+    bool is_nan(const ValueType& _value, std::true_type) {
+        return std::isnan(_value);
+    }
+
+    template<class ValueType>
+    bool is_nan(const ValueType&, std::false_type) {
+        return false;
+    }
+
+    /**
+     * 判断一个值是否为 NaN，只有浮点类型的值可能为 NaN
+     * @param _value 需要判断的值
+     * @return 是否为 NaN
+     */
+    template<class ValueType>
+    bool is_nan(const ValueType& _value) {
+        return is_nan(_value, std::is_floating_point<ValueType>());
+    }
+}
+
+/**
+ * 列式编码数据集，训练过程中使用的数据表示
+ * 在构造时会对每一列属性以及结果进行一次字典编码，将原始的 AttributeType / ResultType 的值映射为从0开始的连续整数编码，
+ * 编码按照值第一次出现的顺序进行分配，之后的训练过程只需要访问这些紧凑的整数数组即可
+ *
+ * <p>数据集中主要包含以下数据成员</p>
+ * <ul>
+ *  <li>每一列的属性名，列通过下标进行访问，不再需要在训练过程中使用字符串进行查找</li>
+ *  <li>每一列的编码数组，一个连续的 uint32_t 数组，下标相同的代表同一个数据</li>
+ *  <li>每一列的字典(Vocabulary)，记录编码到原始值的映射(code -> value)以及原始值到编码的映射(value -> code)</li>
+ *  <li>结果的编码数组以及结果的字典</li>
+ * </ul>
+ *
+ * <p>数值型的列(例如传感器读数、价格)不会为每一个不同的值分配编码，而是在构造时按照分位数划分为至多 MAX_BIN_COUNT 个分箱，
+ * 每一行存放所属分箱的 uint8_t 编码，该列的字典记录每个分箱的上界(包含)，分箱的编码越大上界越大。
+ * 训练时数值型的列使用二分的阈值测试 x <= t 进行划分，t 为某一个分箱的上界</p>
+ */
+template<class AttributeType, class ResultType>
+class Dataset {
+private:
+    size_t _row_count; // 数据的行数
+    std::vector<std::string> _attribute_names; // 每一列的属性名
+    std::map<std::string, size_t> _attribute_name2index; // 属性名到列下标的映射
+    std::vector<Vocabulary<AttributeType>> _vocabularies; // 每一列的字典
+    Vocabulary<ResultType> _result_vocabulary; // 结果的字典
+    std::vector<std::vector<uint32_t>> _columns; // 每一列的编码数组，数值型的列为空
+    std::vector<std::vector<uint8_t>> _bin_columns; // 数值型的列的分箱编码数组，其余的列为空
+    std::vector<bool> _numeric; // 标记每一列是否为数值型
+    std::vector<uint32_t> _labels; // 结果的编码数组
+
+    /**
+     * 对一列数值按照分位数进行分箱，写入该列的字典(分箱的上界)以及分箱编码数组
+     * @param _source 该列的原始数据
+     * @param _max_bin_count 分箱数量的上限
+     * @param _vocabulary 输出每个分箱的上界
+     * @param _bins 输出每一行的分箱编码
+     */
+    static void _quantize(const std::vector<AttributeType>& _source, size_t _max_bin_count,
+                          Vocabulary<AttributeType>& _vocabulary, std::vector<uint8_t>& _bins);
+
+public:
+    /**
+     * 数值型的列的分箱数量的上限，分箱编码使用一个字节存放
+     */
+    static const size_t MAX_BIN_COUNT = 255;
+
+    /**
+     * 构造一个空的数据集
+     */
+    Dataset();
+
+    /**
+     * 根据训练数据构造数据集，会对每一列以及结果进行字典编码
+     * @param _train_x 一个map<string, vector<AttributeType>>，表示训练数据集，string代表属性的名字，相同下标的代表同一个数据
+     * @param _train_y 一个一维数组，表示_train_x的每一行的结果
+     * @param _attribute_name_list 一个一维数组，表示_train_x的每一列所属的属性名，列下标即为该数组中的下标
+     * @param _thread_pool 用于并行地对各列进行编码的线程池，为空时在当前线程中依次编码
+     */
+    Dataset(const std::map<std::string, std::vector<AttributeType>>& _train_x, const std::vector<ResultType>& _train_y,
+            const std::vector<std::string>& _attribute_name_list, ThreadPool* _thread_pool = nullptr);
+
+    /**
+     * 根据训练数据构造数据集，_numeric_attribute_names 中给出的列按照分位数进行分箱，其余的列以及结果进行字典编码
+     * @param _train_x 一个map<string, vector<AttributeType>>，表示训练数据集，string代表属性的名字，相同下标的代表同一个数据
+     * @param _train_y 一个一维数组，表示_train_x的每一行的结果
+     * @param _attribute_name_list 一个一维数组，表示_train_x的每一列所属的属性名，列下标即为该数组中的下标
+     * @param _numeric_attribute_names 数值型的列的属性名，AttributeType 必须重载小于比较符
+     * @param _thread_pool 用于并行地对各列进行编码的线程池，为空时在当前线程中依次编码
+     * @param _max_bin_count 每一个数值型的列的分箱数量的上限，不能超过 MAX_BIN_COUNT
+     */
+    Dataset(const std::map<std::string, std::vector<AttributeType>>& _train_x, const std::vector<ResultType>& _train_y,
+            const std::vector<std::string>& _attribute_name_list, const std::set<std::string>& _numeric_attribute_names,
+            ThreadPool* _thread_pool = nullptr, size_t _max_bin_count = MAX_BIN_COUNT);
+
+    /**
+     * 获取数据的行数
+     * @return 数据集中数据的行数
+     */
+    size_t row_count() const;
+
+    /**
+     * 获取属性的列数
+     * @return 数据集中属性的列数
+     */
+    size_t attribute_count() const;
+
+    /**
+     * 获取某一列的属性名
+     * @param _attribute_index 列下标
+     * @return 该列的属性名
+     */
+    const std::string& attribute_name(size_t _attribute_index) const;
+
+    /**
+     * 根据属性名查找列下标
+     * @param _attribute_name 属性名
+     * @return 该属性所在的列下标，如果不存在则返回 -1
+     */
+    long attribute_index(const std::string& _attribute_name) const;
+
+    /**
+     * 判断某一列是否为数值型的列
+     * @param _attribute_index 列下标
+     * @return 数值型的列返回true
+     */
+    bool is_numeric(size_t _attribute_index) const;
+
+    /**
+     * 获取某一列的编码数组
+     * @param _attribute_index 列下标，必须不是数值型的列
+     * @return 一个指向长度为 row_count() 的连续编码数组的指针
+     */
+    const uint32_t* column(size_t _attribute_index) const;
+
+    /**
+     * 获取数值型的列的分箱编码数组
+     * @param _attribute_index 列下标，必须是数值型的列
+     * @return 一个指向长度为 row_count() 的连续分箱编码数组的指针
+     */
+    const uint8_t* bin_column(size_t _attribute_index) const;
+
+    /**
+     * 获取结果的编码数组
+     * @return 一个指向长度为 row_count() 的连续编码数组的指针
+     */
+    const uint32_t* labels() const;
+
+    /**
+     * 获取某一列不同属性值的数量(数值型的列为分箱的数量)，该列的编码一定小于这个值
+     * @param _attribute_index 列下标
+     * @return 该列的字典大小
+     */
+    size_t cardinality(size_t _attribute_index) const;
+
+    /**
+     * 获取不同结果的数量，结果的编码一定小于这个值
+     * @return 结果字典的大小
+     */
+    size_t class_count() const;
+
+    /**
+     * 获取某一列的字典，下标为编码，值为原始属性值，数值型的列的值为每个分箱的上界
+     * @param _attribute_index 列下标
+     * @return 该列的字典
+     */
+    const std::vector<AttributeType>& attribute_values(size_t _attribute_index) const;
+
+    /**
+     * 获取结果的字典，下标为编码，值为原始结果
+     * @return 结果的字典
+     */
+    const std::vector<ResultType>& result_values() const;
+
+    /**
+     * 获取某一列的字典，可以用于在预测时对输入进行编码
+     * @param _attribute_index 列下标
+     * @return 该列的字典
+     */
+    const Vocabulary<AttributeType>& vocabulary(size_t _attribute_index) const;
+
+    /**
+     * 获取结果的字典
+     * @return 结果的字典
+     */
+    const Vocabulary<ResultType>& result_vocabulary() const;
+
+    /**
+     * 将某一列的原始属性值转换为编码，数值型的列转换为所属分箱的编码
+     * @param _attribute_index 列下标
+     * @param _attribute 原始属性值
+     * @param _code 转换得到的编码，仅在返回true时有效
+     * @return 如果该值在训练数据中出现过(数值型的列总是)则返回true，否则返回false
+     */
+    bool encode_attribute(size_t _attribute_index, const AttributeType& _attribute, uint32_t& _code) const;
+};
+
+template<class AttributeType, class ResultType>
+const size_t Dataset<AttributeType, ResultType>::MAX_BIN_COUNT;
+
+/**
+ * 构造一个空的数据集
+ */
+template<class AttributeType, class ResultType>
+Dataset<AttributeType, ResultType>::Dataset() {
+    this->_row_count = 0;
+}
+
+/**
+ * 根据训练数据构造数据集，会对每一列以及结果进行字典编码
+ * 每一列以及结果的编码相互独立，会作为不同的任务在线程池中并行执行，每一行只需要一次哈希查找
+ * 每一列的长度必须与_train_y相同，否则会抛出std::invalid_argument
+ * @param _train_x 一个map<string, vector<AttributeType>>，表示训练数据集，string代表属性的名字，相同下标的代表同一个数据
+ * @param _train_y 一个一维数组，表示_train_x的每一行的结果
+ * @param _attribute_name_list 一个一维数组，表示_train_x的每一列所属的属性名，列下标即为该数组中的下标
+ * @param _thread_pool 用于并行地对各列进行编码的线程池，为空时在当前线程中依次编码
+ */
+template<class AttributeType, class ResultType>
+Dataset<AttributeType, ResultType>::Dataset(const std::map<std::string, std::vector<AttributeType>> &_train_x,
+                                            const std::vector<ResultType> &_train_y,
+                                            const std::vector<std::string> &_attribute_name_list,
+                                            ThreadPool* _thread_pool)
+        : Dataset(_train_x, _train_y, _attribute_name_list, std::set<std::string>(), _thread_pool) {
+}
+
+/**
+ * 根据训练数据构造数据集，_numeric_attribute_names 中给出的列按照分位数进行分箱，其余的列以及结果进行字典编码
+ * 每一列的分箱或编码相互独立，会作为不同的任务在线程池中并行执行
+ * 每一列的长度必须与_train_y相同，属性名不能重复，分箱数量的上限必须在[1, MAX_BIN_COUNT]中，数值型的列中不能有 NaN，
+ * 否则会抛出std::invalid_argument
+ * @param _train_x 一个map<string, vector<AttributeType>>，表示训练数据集，string代表属性的名字，相同下标的代表同一个数据
+ * @param _train_y 一个一维数组，表示_train_x的每一行的结果
+ * @param _attribute_name_list 一个一维数组，表示_train_x的每一列所属的属性名，列下标即为该数组中的下标
+ * @param _numeric_attribute_names 数值型的列的属性名，AttributeType 必须重载小于比较符
+ * @param _thread_pool 用于并行地对各列进行编码的线程池，为空时在当前线程中依次编码
+ * @param _max_bin_count 每一个数值型的列的分箱数量的上限，不能超过 MAX_BIN_COUNT
+ */
+template<class AttributeType, class ResultType>
+Dataset<AttributeType, ResultType>::Dataset(const std::map<std::string, std::vector<AttributeType>> &_train_x,
+                                            const std::vector<ResultType> &_train_y,
+                                            const std::vector<std::string> &_attribute_name_list,
+                                            const std::set<std::string> &_numeric_attribute_names,
+                                            ThreadPool* _thread_pool, size_t _max_bin_count) {
+    if (_max_bin_count == 0 || _max_bin_count > MAX_BIN_COUNT) {
+        throw std::invalid_argument("Dataset: the number of bins must be in [1, 255]");
+    }
+    this->_row_count = _train_y.size();
+    this->_attribute_names = _attribute_name_list;
+    this->_vocabularies.resize(_attribute_name_list.size());
+    this->_columns.resize(_attribute_name_list.size());
+    this->_bin_columns.resize(_attribute_name_list.size());
+    this->_numeric.resize(_attribute_name_list.size());
+    // 先在当前线程中找到每一列的数据，检查长度是否正确
+    std::vector<const std::vector<AttributeType>*> sources;
+    for(size_t index = 0; index < _attribute_name_list.size(); ++ index) {
+        const std::string& name = _attribute_name_list[index];
+        if (!this->_attribute_name2index.insert(std::make_pair(name, index)).second) {
+            throw std::invalid_argument("Dataset: duplicate attribute '" + name + "'");
+        }
+        auto found = _train_x.find(name);
+        if (found == _train_x.end() || found->second.size() != this->_row_count) {
+            throw std::invalid_argument("Dataset: column '" + name + "' is missing or has a wrong length");
+        }
+        sources.push_back(&found->second);
+        this->_numeric[index] = _numeric_attribute_names.count(name) > 0;
+    }
+    // 下标为 attribute_count() 的任务对结果进行编码，其余任务各自对一列进行编码
+    auto encode = [&](size_t index) {
+        if (index == sources.size()) {
+            this->_labels.resize(this->_row_count);
+            for(size_t row = 0; row < this->_row_count; ++ row) {
+                this->_labels[row] = this->_result_vocabulary.insert(_train_y[row]);
+            }
+            return;
+        }
+        const std::vector<AttributeType>& source = *sources[index];
+        Vocabulary<AttributeType>& vocabulary = this->_vocabularies[index];
+        if (this->_numeric[index]) {
+            _quantize(source, _max_bin_count, vocabulary, this->_bin_columns[index]);
+            return;
+        }
+        std::vector<uint32_t>& codes = this->_columns[index];
+        codes.resize(this->_row_count);
+        for(size_t row = 0; row < this->_row_count; ++ row) {
+            codes[row] = vocabulary.insert(source[row]);
+        }
+    };
+    if (_thread_pool != nullptr) {
+        _thread_pool->parallel_for(0, sources.size() + 1, encode);
+    } else {
+        for(size_t index = 0; index <= sources.size(); ++ index) {
+            encode(index);
+        }
+    }
+}
+
+/**
+ * 对一列数值按照分位数进行分箱，写入该列的字典(分箱的上界)以及分箱编码数组
+ * 先对数值进行排序，再从小到大依次合并相同的值，累计的行数达到下一个分位点时结束当前分箱，
+ * 相同的值一定落在同一个分箱中，不同的值不超过_max_bin_count个时每一个值各自成为一个分箱
+ * NaN 无法与其他值比较大小，排序的结果没有意义，因此含有 NaN 的列会抛出std::invalid_argument
+ * @param _source 该列的原始数据
+ * @param _max_bin_count 分箱数量的上限
+ * @param _vocabulary 输出每个分箱的上界
+ * @param _bins 输出每一行的分箱编码
+ */
+template<class AttributeType, class ResultType>
+void Dataset<AttributeType, ResultType>::_quantize(const std::vector<AttributeType> &_source, size_t _max_bin_count,
+                                                   Vocabulary<AttributeType> &_vocabulary, std::vector<uint8_t> &_bins) {
+    _bins.assign(_source.size(), 0);
+    if (_source.empty()) {
+        return;
+    }
+    for(const AttributeType& value: _source) {
+        if (_dataset_self_use::is_nan(value)) {
+            throw std::invalid_argument("Dataset: a numeric column contains NaN");
+        }
+    }
+    std::vector<AttributeType> sorted(_source);
+    std::sort(sorted.begin(), sorted.end());
+    size_t distinct_count = 1;
+    for(size_t i = 1; i < sorted.size(); ++ i) {
+        distinct_count += sorted[i - 1] < sorted[i];
+    }
+    std::vector<AttributeType> upper_bounds;
+    size_t bin_count = std::min(distinct_count, _max_bin_count);
+    for(size_t end = 0; end < sorted.size(); ) {
+        // [begin, end) 为同一个值的所有行
+        size_t begin = end;
+        while (end < sorted.size() && !(sorted[begin] < sorted[end])) {
+            ++ end;
+        }
+        // 累计的行数达到下一个分位点，或者剩余的不同值需要各自成为一个分箱时，结束当前分箱
+        size_t remaining_distinct = -- distinct_count;
+        size_t target = (upper_bounds.size() + 1) * sorted.size() / bin_count;
+        if (end >= target || remaining_distinct < bin_count - upper_bounds.size() || end == sorted.size()) {
+            upper_bounds.push_back(sorted[begin]);
+        }
+    }
+    for(const AttributeType& upper_bound: upper_bounds) {
+        _vocabulary.insert(upper_bound);
+    }
+    for(size_t row = 0; row < _source.size(); ++ row) {
+        _bins[row] = (uint8_t)_dataset_self_use::find_bin(upper_bounds, _source[row]);
+    }
+}
+
+template<class AttributeType, class ResultType>
+size_t Dataset<AttributeType, ResultType>::row_count() const {
+    return this->_row_count;
+}
+
+template<class AttributeType, class ResultType>
+size_t Dataset<AttributeType, ResultType>::attribute_count() const {
+    return this->_attribute_names.size();
+}
+
+template<class AttributeType, class ResultType>
+const std::string &Dataset<AttributeType, ResultType>::attribute_name(size_t _attribute_index) const {
+    return this->_attribute_names[_attribute_index];
+}
+
+template<class AttributeType, class ResultType>
+long Dataset<AttributeType, ResultType>::attribute_index(const std::string &_attribute_name) const {
+    auto it = this->_attribute_name2index.find(_attribute_name);
+    if (it == this->_attribute_name2index.end()) {
+        return -1;
+    }
+    return (long)it->second;
+}
+
+template<class AttributeType, class ResultType>
+bool Dataset<AttributeType, ResultType>::is_numeric(size_t _attribute_index) const {
+    return this->_numeric[_attribute_index];
+}
+
+template<class AttributeType, class ResultType>
+const uint32_t *Dataset<AttributeType, ResultType>::column(size_t _attribute_index) const {
+    return this->_columns[_attribute_index].data();
+}
+
+template<class AttributeType, class ResultType>
+const uint8_t *Dataset<AttributeType, ResultType>::bin_column(size_t _attribute_index) const {
+    return this->_bin_columns[_attribute_index].data();
+}
+
+template<class AttributeType, class ResultType>
+const uint32_t *Dataset<AttributeType, ResultType>::labels() const {
+    return this->_labels.data();
+}
+
+template<class AttributeType, class ResultType>
+size_t Dataset<AttributeType, ResultType>::cardinality(size_t _attribute_index) const {
+    return this->_vocabularies[_attribute_index].size();
+}
+
+template<class AttributeType, class ResultType>
+size_t Dataset<AttributeType, ResultType>::class_count() const {
+    return this->_result_vocabulary.size();
+}
+
+template<class AttributeType, class ResultType>
+const std::vector<AttributeType> &Dataset<AttributeType, ResultType>::attribute_values(size_t _attribute_index) const {
+    return this->_vocabularies[_attribute_index].values();
+}
+
+template<class AttributeType, class ResultType>
+const std::vector<ResultType> &Dataset<AttributeType, ResultType>::result_values() const {
+    return this->_result_vocabulary.values();
+}
+
+template<class AttributeType, class ResultType>
+const Vocabulary<AttributeType> &Dataset<AttributeType, ResultType>::vocabulary(size_t _attribute_index) const {
+    return this->_vocabularies[_attribute_index];
+}
+
+template<class AttributeType, class ResultType>
+const Vocabulary<ResultType> &Dataset<AttributeType, ResultType>::result_vocabulary() const {
+    return this->_result_vocabulary;
+}
+
+/**
+ * 将某一列的原始属性值转换为编码，数值型的列转换为所属分箱的编码
+ * @param _attribute_index 列下标
+ * @param _attribute 原始属性值
+ * @param _code 转换得到的编码，仅在返回true时有效
+ * @return 如果该值在训练数据中出现过(数值型的列总是)则返回true，否则返回false
+ */
+template<class AttributeType, class ResultType>
+bool Dataset<AttributeType, ResultType>::encode_attribute(size_t _attribute_index, const AttributeType &_attribute,
+                                                          uint32_t &_code) const {
+    if (this->_numeric[_attribute_index]) {
+        const std::vector<AttributeType>& upper_bounds = this->_vocabularies[_attribute_index].values();
+        if (upper_bounds.empty()) {
+            return false;
+        }
+        _code = _dataset_self_use::find_bin(upper_bounds, _attribute);
+        return true;
+    }
+    return this->_vocabularies[_attribute_index].find(_attribute, _code);
+}
+
+#endif //DESITIONTREE_DATASET_H
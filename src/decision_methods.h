@@ -10,6 +10,11 @@
 #include <map>
 #include <vector>
 #include <cmath>
+#include <limits>
+#include "dataset.h"
+#include "histogram.h"
+#include "split_criterion.h"
+#include "thread_pool.h"
 
 /**
  * úϣ ⲻż
@@ -25,27 +30,18 @@ namespace _decision_methods_self_use {
     template<class AttributeType, class ResultType>
     float generate_gain(std::vector<AttributeType>& _train_x,
                         std::vector<ResultType> &_train_y) {
-        std::map<AttributeType, std::map<ResultType, float>> attribute_counter; // ¼ͬԵĲͬ𰸵
-        // ͳÿԼÿеϢأмȨƽԼǰȷʱϢ
-        for(int index= 0; index < _train_y.size(); ++ index) {
-            attribute_counter[_train_x[index]][_train_y[index]] ++;
+        // ȽΪֱͼϼ
+        std::map<AttributeType, uint32_t> attribute_codes;
+        std::map<ResultType, uint32_t> result_codes;
+        std::vector<uint32_t> column(_train_y.size());
+        std::vector<uint32_t> labels(_train_y.size());
+        for(size_t index = 0; index < _train_y.size(); ++ index) {
+            column[index] = attribute_codes.insert(std::make_pair(_train_x[index], (uint32_t)attribute_codes.size())).first->second;
+            labels[index] = result_codes.insert(std::make_pair(_train_y[index], (uint32_t)result_codes.size())).first->second;
         }
-        float res = 0.0;
-        // ѭ¼ÿȷ£ͬ𰸵ĵصļȨƽ
-        // ȻٶÿȷؽмȨƽ
-        for(auto& iter: attribute_counter) {
-            float total_count = 0.0;
-            for(std::pair<ResultType, float> _result_pair: attribute_counter[iter.first]) {
-                total_count += _result_pair.second;
-            }
-            float ent_cur = 0.0;
-            for(std::pair<ResultType, float> _result_pair: attribute_counter[iter.first]) {
-                float cur_p = _result_pair.second / total_count;
-                ent_cur -= cur_p * log(cur_p) / log(10.0);
-            }
-            res += ent_cur * total_count / _train_y.size();
-        }
-        return res;
+        Histogram histogram(attribute_codes.size(), result_codes.size());
+        histogram.build(column.data(), labels.data(), labels.size());
+        return (float)histogram.conditional_entropy();
     }
 
 };
@@ -80,4 +76,261 @@ std::string KILC_method(std::map<std::string, std::vector<AttributeType>> &_trai
     return min_attribute_name;
 }
 
+/**
+ * ڱݼѡĻ
+ * ͨаÿһֳֵһӽڵ㣬ֵ͵аֵ bin <= threshold Ϊӽڵ
+ */
+struct Split {
+    size_t attribute_index; // Ե±
+    uint32_t threshold; // ֵ͵еֵ()ӽڵΪ벻ڸֵУ
+    bool degenerate; // ûЧĻֵ֣͵ежͬһУκλֶӽڵ
+    double score; // ֵ֣ԽСԽ
+};
+
+namespace _decision_methods_self_use {
+
+    /**
+     * ڷֱͼγÿһֵҳСĶֻ
+     * ʹһֻеֱͼʾֵ֣ÿһֻҪһļҲƶ
+     * @param Criterion ׼
+     * @param _bins ֱͼֵΪ
+     * @param _binary ڱʾֱֵֻͼᱻ
+     * @param _threshold СֵڷصЧĻʱ
+     * @param _degenerate ûκЧĻ(жͬһ)ʱΪtrue
+     * @param _min_child_rows ӵеκһڸֵֵᱻѡ
+     * @return С֣ûЧĻʱΪֵ֣_min_child_rows 1ûЧĻʱΪ
+     */
+    template<class Criterion>
+    double threshold_search(const Histogram& _bins, Histogram& _binary, uint32_t& _threshold, bool& _degenerate,
+                            size_t _min_child_rows = 1) {
+        _binary.reset(2, _bins.class_count());
+        for(size_t bin = 0; bin < _bins.value_count(); ++ bin) {
+            _binary.add(1, _bins.row(bin));
+        }
+        _degenerate = true;
+        _threshold = 0;
+        double best = 0.0;
+        for(size_t bin = 0; bin + 1 < _bins.value_count(); ++ bin) {
+            if (_bins.value_total(bin) == 0) {
+                continue;
+            }
+            _binary.move(1, 0, _bins.row(bin));
+            if (_binary.value_total(1) < std::max<size_t>(1, _min_child_rows)) { // ҲֻԽԽ
+                break;
+            }
+            if (_binary.value_total(0) < _min_child_rows) {
+                continue;
+            }
+            double score = Criterion::score(_binary);
+            if (_degenerate || score < best) {
+                best = score;
+                _threshold = (uint32_t)bin;
+                _degenerate = false;
+            }
+        }
+        if (_degenerate && _min_child_rows > 1) {
+            return std::numeric_limits<double>::infinity();
+        }
+        return _degenerate ? Criterion::score(_bins) : best;
+    }
+
+    /**
+     * жͨеĶ·Ƿûݵֵݵӽڵ㣬
+     * @param _histogram еֱͼ
+     * @param _min_child_rows ÿݵӽڵӵе
+     * @return ʱtrue
+     */
+    inline bool enough_child_rows(const Histogram& _histogram, size_t _min_child_rows) {
+        for(size_t value = 0; value < _histogram.value_count(); ++ value) {
+            uint32_t value_total = _histogram.value_total(value);
+            if (value_total != 0 && value_total < _min_child_rows) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+/**
+ * ͳƵǰڵÿһϵֱͼֵ͵ͳÿļ
+ * @param _dataset ѵݼ
+ * @param _rows ǰڵӵеݵ±
+ * @param _row_count ǰڵӵеݵ
+ * @param _attribute_index_list ǰӵеԵ±ļ
+ * @param _histograms ֱͼ_attribute_index_listһһӦ
+ * @param _thread_pool ڲͳÿԵֱͼ̳߳أΪʱڵǰ߳ͳ
+ */
+template<class AttributeType, class ResultType>
+void build_histograms(const Dataset<AttributeType, ResultType>& _dataset,
+                      const uint32_t* _rows, size_t _row_count,
+                      const std::vector<size_t>& _attribute_index_list,
+                      std::vector<Histogram>& _histograms,
+                      ThreadPool* _thread_pool = nullptr) {
+    _histograms.resize(_attribute_index_list.size());
+    auto build = [&](size_t index) {
+        size_t attribute_index = _attribute_index_list[index];
+        Histogram& histogram = _histograms[index];
+        histogram.reset(_dataset.cardinality(attribute_index), _dataset.class_count());
+        if (_dataset.is_numeric(attribute_index)) {
+            histogram.build(_dataset.bin_column(attribute_index), _dataset.labels(), _rows, _row_count);
+        } else {
+            histogram.build(_dataset.column(attribute_index), _dataset.labels(), _rows, _row_count);
+        }
+    };
+    if (_thread_pool != nullptr) {
+        _thread_pool->parallel_for(0, _histograms.size(), build);
+    } else {
+        for(size_t index = 0; index < _histograms.size(); ++ index) {
+            build(index);
+        }
+    }
+}
+
+/**
+ * ʹøĻ׼Ѿͳƺõֱͼѡ񻮷
+ * @param Criterion ׼򣬼 split_criterion.h
+ * @param DatasetType ṩ is_numeric(±) ݼͣ Dataset  ColumnStore
+ * @param _dataset ѵݼ
+ * @param _histograms ǰڵÿһϵֱͼ_attribute_index_listһһӦ
+ * @param _attribute_index_list ǰӵеԵ±ļ
+ * @param _thread_pool ڲмÿԵֵ̳߳أΪʱڵǰ߳μ
+ * @param _min_child_rows ÿݵӽڵӵеĻΪлֶʱصĻΪ degenerate
+ * @return ѡĻ֣ͬʱѡ_attribute_index_listпǰԣǷ޹
+ */
+template<class Criterion, class DatasetType>
+Split find_split(const DatasetType& _dataset,
+                 const std::vector<Histogram>& _histograms,
+                 const std::vector<size_t>& _attribute_index_list,
+                 ThreadPool* _thread_pool = nullptr, size_t _min_child_rows = 1) {
+    std::vector<double> values(_attribute_index_list.size());
+    std::vector<Split> splits(_attribute_index_list.size());
+    auto score = [&](size_t index) {
+        thread_local Histogram binary; // ֵ͵еĶֻ֣ÿ̹߳һ
+        Split& split = splits[index];
+        split.attribute_index = _attribute_index_list[index];
+        split.threshold = 0;
+        split.degenerate = false;
+        if (_dataset.is_numeric(split.attribute_index)) {
+            values[index] = _decision_methods_self_use::threshold_search<Criterion>(
+                    _histograms[index], binary, split.threshold, split.degenerate, _min_child_rows);
+        } else if (_min_child_rows > 1
+                   && !_decision_methods_self_use::enough_child_rows(_histograms[index], _min_child_rows)) {
+            values[index] = std::numeric_limits<double>::infinity();
+            split.degenerate = true;
+        } else {
+            values[index] = Criterion::score(_histograms[index]);
+        }
+    };
+    if (_thread_pool != nullptr) {
+        _thread_pool->parallel_for(0, values.size(), score);
+    } else {
+        for(size_t index = 0; index < values.size(); ++ index) {
+            score(index);
+        }
+    }
+    size_t min_index = 0;
+    for(size_t index = 1; index < values.size(); ++ index) {
+        if(values[index] < values[min_index]) {
+            min_index = index;
+        }
+    }
+    splits[min_index].score = values[min_index];
+    return splits[min_index];
+}
+
+/**
+ * ʹøĻ׼ѡ񻮷֣ڱݼϽм
+ * ÿԵֱͼ໥ȷֱٰԵ˳ѡС
+ * ֵ͵ڷֱͼѰŵֵΪŵĶֵֻ
+ * @param Criterion ׼򣬼 split_criterion.h
+ * @param _dataset ѵݼ
+ * @param _rows ǰڵӵеݵ±
+ * @param _row_count ǰڵӵеݵ
+ * @param _attribute_index_list ǰӵеԵ±ļ
+ * @param _thread_pool ڲмÿԵֵ̳߳أΪʱڵǰ߳μ
+ * @param _min_child_rows ÿݵӽڵӵеĻΪлֶʱصĻΪ degenerate
+ * @return ѡĻ֣ͬʱѡ_attribute_index_listпǰԣǷ޹
+ */
+template<class Criterion, class AttributeType, class ResultType>
+Split find_split(const Dataset<AttributeType, ResultType>& _dataset,
+                 const uint32_t* _rows, size_t _row_count,
+                 const std::vector<size_t>& _attribute_index_list,
+                 ThreadPool* _thread_pool = nullptr, size_t _min_child_rows = 1) {
+    std::vector<double> values(_attribute_index_list.size());
+    std::vector<Split> splits(_attribute_index_list.size());
+    auto score = [&](size_t index) {
+        thread_local Histogram histogram; // ÿ̹߳һֱͼֻڵһʹʱڴ
+        thread_local Histogram binary; // ֵ͵еĶֻ
+        size_t attribute_index = _attribute_index_list[index];
+        Split& split = splits[index];
+        split.attribute_index = attribute_index;
+        split.threshold = 0;
+        split.degenerate = false;
+        histogram.reset(_dataset.cardinality(attribute_index), _dataset.class_count());
+        if (_dataset.is_numeric(attribute_index)) {
+            histogram.build(_dataset.bin_column(attribute_index), _dataset.labels(), _rows, _row_count);
+            values[index] = _decision_methods_self_use::threshold_search<Criterion>(
+                    histogram, binary, split.threshold, split.degenerate, _min_child_rows);
+            return;
+        }
+        histogram.build(_dataset.column(attribute_index), _dataset.labels(), _rows, _row_count);
+        if (_min_child_rows > 1 && !_decision_methods_self_use::enough_child_rows(histogram, _min_child_rows)) {
+            values[index] = std::numeric_limits<double>::infinity();
+            split.degenerate = true;
+            return;
+        }
+        values[index] = Criterion::score(histogram);
+    };
+    if (_thread_pool != nullptr) {
+        _thread_pool->parallel_for(0, values.size(), score);
+    } else {
+        for(size_t index = 0; index < values.size(); ++ index) {
+            score(index);
+        }
+    }
+    size_t min_index = 0;
+    for(size_t index = 1; index < values.size(); ++ index) {
+        if(values[index] < values[min_index]) {
+            min_index = index;
+        }
+    }
+    splits[min_index].score = values[min_index];
+    return splits[min_index];
+}
+
+/**
+ * ʹøĻ׼ѡԣڱݼϽм
+ * @param Criterion ׼򣬼 split_criterion.h
+ * @param _dataset ѵݼ
+ * @param _rows ǰڵӵеݵ±
+ * @param _row_count ǰڵӵеݵ
+ * @param _attribute_index_list ǰӵеԵ±ļ
+ * @param _thread_pool ڲмÿԵֵ̳߳أΪʱڵǰ߳μ
+ * @return ѡھߵԵ±꣬ͬʱѡ_attribute_index_listпǰԣǷ޹
+ */
+template<class Criterion, class AttributeType, class ResultType>
+size_t criterion_method(const Dataset<AttributeType, ResultType>& _dataset,
+                        const uint32_t* _rows, size_t _row_count,
+                        const std::vector<size_t>& _attribute_index_list,
+                        ThreadPool* _thread_pool = nullptr) {
+    return find_split<Criterion>(_dataset, _rows, _row_count, _attribute_index_list, _thread_pool).attribute_index;
+}
+
+/**
+ * ʹϢѡԣڱݼϽм
+ * @param _dataset ѵݼ
+ * @param _rows ǰڵӵеݵ±
+ * @param _row_count ǰڵӵеݵ
+ * @param _attribute_index_list ǰӵеԵ±ļ
+ * @param _thread_pool ڲмÿԵص̳߳أΪʱڵǰ߳μ
+ * @return ѡھߵԵ±꣬ͬʱѡ_attribute_index_listпǰԣǷ޹
+ */
+template<class AttributeType, class ResultType>
+size_t KILC_method(const Dataset<AttributeType, ResultType>& _dataset,
+                   const uint32_t* _rows, size_t _row_count,
+                   const std::vector<size_t>& _attribute_index_list,
+                   ThreadPool* _thread_pool = nullptr) {
+    return criterion_method<InformationGain>(_dataset, _rows, _row_count, _attribute_index_list, _thread_pool);
+}
+
 #endif //DESITIONTREE_DECISION_METHODS_H
@@ -7,103 +7,150 @@
 
 #include "node_base.h"
 #include "result_node.h"
+#include "vocabulary.h"
+#include <cstdint>
 #include <cstring>
+#include <string>
 #include <vector>
 #include <map>
 
 /**
- * 决策点，会记录当前决策位置的属性名(如：色泽等)以及不同属性对应的选择(如：黄色->下一个)
+ * 决策点，会记录当前决策位置的属性(如：色泽等)以及不同属性对应的选择(如：黄色->下一个)
  * 继承于NodeBase类，是决策树中非常关键的节点类型
  *
  * <p>决策节点的主要作用是进行选择，因此决策节点中主要包含以下数据成员</p>
  * <ul>
- *  <li>当前节点的的属性名称， 一个String类型的变量</li>
- *  <li>当前节点不同属性对应的选择， 是一个Map类型的映射表，值得注意的是：该属性完全由用户进行定义，
- *  如果用户想要使用自定义的类型，则必须重载该类型的小于比较符与等于比较符，这非常重要，否则会导致红黑树运行时的错误。</li>
+ *  <li>当前节点的属性在数据集中的列下标，属性名由决策树按照列下标保存，节点本身不需要析构</li>
+ *  <li>当前列的字典，由决策树持有，用于将属性值转换为训练时的编码</li>
+ *  <li>当前节点不同属性对应的选择， 是一个以属性值编码为下标的子节点表，长度为字典的大小，
+ *  子节点表由决策树的内存池(NodeArena)分配。一次决策只需要在字典中查找一次编码，再按照下标读取一次子节点表</li>
  * </ul>
  */
 template<class AttributeType>
 class DecisionNode: NodeBase {
 private:
-    std::string _attribute_name; // 属性名
+    size_t _attribute_index; // 属性的列下标
+    const Vocabulary<AttributeType>* _vocabulary; // 当前列的字典
+    NodeBase** _children; // 子节点表，下标为属性值的编码，没有对应选择的为空指针
+    uint32_t _child_count; // 子节点表的长度
 public:
-
-    std::map<AttributeType, NodeBase*> _attribute_map; // 记录不同属性的映射关系
     /**
      * 决策树节点的构造函数，用于构造一个决策数的决策节点
-     * @param _attribute_name 字符串类型， 表示属性名称
+     * @param _attribute_index 属性的列下标
+     * @param _vocabulary 当前列的字典，在节点被释放之前必须一直有效
+     * @param _children 子节点表，长度为字典的大小，所有元素初始为空指针
      */
-    explicit DecisionNode(const std::string& _attribute_name);
+    DecisionNode(size_t _attribute_index, const Vocabulary<AttributeType>* _vocabulary, NodeBase** _children);
 
     /**
      * 向当前的决策节点中添加决策关系
-     * @param _attribute 属性的值
+     * @param _attribute 属性的值，不在字典中的值会被忽略
+     * @param _decision 当前属性取相应值时，所作出的选择
+     */
+    void insert_decision(const AttributeType& _attribute, NodeBase* _decision);
+
+    /**
+     * 按照属性值的编码设置决策关系
+     * @param _code 属性值的编码，必须小于字典的大小
      * @param _decision 当前属性取相应值时，所作出的选择
      */
-    void insert_decision(AttributeType _attribute, NodeBase* _decision);
+    void set_child(uint32_t _code, NodeBase* _decision);
 
     /**
      * 用于进行一次决策，需要给出当前属性的值，将返回相应的决策结果
      * @param _attribute 当前属性的值
      * @return 决策的结果，一个节点类型的指针，指向下一个节点
      */
-    NodeBase* do_decision(AttributeType _attribute);
+    NodeBase* do_decision(const AttributeType& _attribute) const;
 
     /**
-     * 获取当前节点管理的属性名
-     * @return 一个string类型的变量，表示当前节点管理的属性的名称
+     * 按照属性值的编码进行一次决策
+     * @param _code 属性值的编码
+     * @return 决策的结果，编码超出子节点表时返回空指针
      */
-    std::string get_attribute_name();
+    NodeBase* get_child(uint32_t _code) const;
 
-    ~DecisionNode() override;
+    /**
+     * 获取子节点表的长度，即当前列的字典大小
+     * @return 子节点表的长度
+     */
+    uint32_t child_count() const;
+
+    /**
+     * 获取当前节点管理的属性的列下标，预测时通过列下标直接读取编码后的一行数据，属性名通过决策树按照列下标获取
+     * @return 属性的列下标
+     */
+    size_t get_attribute_index() const;
 };
 
 /**
  * 决策树节点的构造函数，用于构造一个决策数的决策节点
- * @param _attribute_name 字符串类型， 表示属性名称
+ * @param _attribute_index 属性的列下标
+ * @param _vocabulary 当前列的字典，在节点被释放之前必须一直有效
+ * @param _children 子节点表，长度为字典的大小，所有元素初始为空指针
  */
 template<class AttributeType>
-DecisionNode<AttributeType>::DecisionNode(const std::string &_attribute_name) {
+DecisionNode<AttributeType>::DecisionNode(size_t _attribute_index, const Vocabulary<AttributeType> *_vocabulary,
+                                          NodeBase **_children) {
     this->_is_result = false;
-    this->_attribute_name = _attribute_name;
+    this->_attribute_index = _attribute_index;
+    this->_vocabulary = _vocabulary;
+    this->_children = _children;
+    this->_child_count = (uint32_t)_vocabulary->size();
 }
 
 /**
  * 用于进行一次决策，需要给出当前属性的值，将返回相应的决策结果
+ * 在字典中查找一次编码，再直接读取子节点表
  * @param _attribute 当前属性的值
  * @return 决策的结果，一个节点类型的指针，指向下一个节点
  */
 template<class AttributeType>
-NodeBase *DecisionNode<AttributeType>::do_decision(AttributeType _attribute) {
-    if(this->_attribute_map.find(_attribute) == this->_attribute_map.end()) {
+NodeBase *DecisionNode<AttributeType>::do_decision(const AttributeType &_attribute) const {
+    uint32_t code;
+    if (!this->_vocabulary->find(_attribute, code)) {
         // 如果在当前记录的关系中没有找到相应的关系，那么就返回null
         return nullptr;
     } // 否则就直接返回相应的下一个节点的指针
-    return this->_attribute_map[_attribute];
+    return this->get_child(code);
+}
+
+template<class AttributeType>
+NodeBase *DecisionNode<AttributeType>::get_child(uint32_t _code) const {
+    return _code < this->_child_count ? this->_children[_code] : nullptr;
 }
 
-/**
- * 获取当前节点管理的属性名
- * @return 一个string类型的变量，表示当前节点管理的属性的名称
- */
 template<class AttributeType>
-std::string DecisionNode<AttributeType>::get_attribute_name() {
-    return this->_attribute_name;
+uint32_t DecisionNode<AttributeType>::child_count() const {
+    return this->_child_count;
+}
+
+template<class AttributeType>
+size_t DecisionNode<AttributeType>::get_attribute_index() const {
+    return this->_attribute_index;
 }
 
 /**
  * 向当前的决策节点中添加决策关系
- * @param _attribute 属性的值
+ * @param _attribute 属性的值，不在字典中的值会被忽略
  * @param _decision 当前属性取相应值时，所作出的选择
  */
 template<class AttributeType>
-void DecisionNode<AttributeType>::insert_decision(AttributeType _attribute, NodeBase *_decision) {
-    this->_attribute_map[_attribute] = _decision;
+void DecisionNode<AttributeType>::insert_decision(const AttributeType& _attribute, NodeBase *_decision) {
+    uint32_t code;
+    if (this->_vocabulary->find(_attribute, code)) {
+        this->set_child(code, _decision);
+    }
 }
 
+/**
+ * 按照属性值的编码设置决策关系
+ * @param _code 属性值的编码，必须小于字典的大小
+ * @param _decision 当前属性取相应值时，所作出的选择
+ */
 template<class AttributeType>
-DecisionNode<AttributeType>::~DecisionNode(){
-
+void DecisionNode<AttributeType>::set_child(uint32_t _code, NodeBase *_decision) {
+    this->_children[_code] = _decision;
 }
 
 #endif //DESITIONTREE_DECISION_NODE_H
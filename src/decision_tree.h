@@ -6,9 +6,24 @@
 #define DESITIONTREE_DECISION_TREE_H
 
 #include "result_node.h"
+#include "node_arena.h"
 #include "decision_node.h"
+#include "threshold_node.h"
 #include "decision_methods.h"
+#include "dataset.h"
+#include "column_store.h"
+#include "compiled_tree.h"
+#include "tree_model.h"
+#include "thread_pool.h"
+#include "train_stats.h"
+#include <algorithm>
 #include <map>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #define GAIN ("KILC")
@@ -30,6 +45,9 @@
  *  <li>get_result() 获取相应的结果</li>
  * </ul>
  *
+ * 数值型的属性(见 Dataset 的分箱)使用阈值决策节点(ThresholdNode)，按照 x <= t 划分为两个子节点，
+ * 划分后该属性仍然可以在子树中继续使用
+ *
  * 同时，无论是什么类型的节点，都应当注意把控自身的_is_result属性，否则会在决策过程中出错
  */
 template<class AttributeType, class ResultType>
@@ -38,23 +56,180 @@ private:
 
 
     NodeBase* _root{}; // 决策树的树根
-    std::map<std::string, std::vector<AttributeType>> _attribute_list; // 每种属性的可能属性的列表
-    std::vector<ResultType> _result_list; // 可行结果的列表
+    NodeArena _arena; // 所有节点所在的内存池
+    std::vector<std::string> _attribute_names; // 每一列的属性名，下标为列下标
+    std::vector<Vocabulary<AttributeType>> _attribute_list; // 每一列可能的属性的字典，训练与预测共用同一套编码
+    std::vector<bool> _numeric_list; // 标记每一列是否为数值型，数值型的列的字典记录每个分箱的上界
+    Vocabulary<ResultType> _result_list; // 可行结果的字典
+    std::shared_ptr<ThreadPool> _thread_pool; // 训练时使用的线程池，为空时在当前线程中进行训练
+    size_t _parallel_cutoff; // 行数不少于该值的节点才会并行地选择属性以及创建子树
+    size_t _max_features; // 每个节点随机选取的候选属性的个数，为0时使用所有属性
+    uint64_t _feature_seed; // 随机选取候选属性的种子
+    size_t _max_depth; // 决策节点的最大深度，深度达到该值的节点成为结果节点，为0时没有限制
+    size_t _min_split_rows; // 行数少于该值的节点不再划分
+    size_t _min_child_rows; // 划分后每个有数据的子节点至少拥有的行数
+    double _min_improvement; // 划分的评分至少比不划分降低的值，为0时不检查
+    size_t _max_leaves; // 结果节点数量的上限，为0时没有限制
+    size_t _open_leaves; // 训练过程中已经创建以及尚未创建的结果节点的数量，只在限制了结果节点的数量时使用
+    TrainStats _stats; // 最近一次训练的统计结果
+#ifdef DESITIONTREE_ENABLE_STATS
+    TrainStatsCollector _stats_collector; // 训练过程中收集统计的计数器
+#endif
+    bool can_stop(const uint32_t* _labels, const uint32_t* _rows, size_t _row_count);
+
     /**
-     * 清空以root为根的所有节点及其记录的所有信息
-     * @param root 需要清除的子树的根节点
+     * 将以node为根的子树按照深度优先的顺序写入编译后的决策树
+     * @param _node 子树的根节点
+     * @param _compiled 编译后的决策树
+     * @return 子树的根节点在编译后的决策树中的下标，空节点返回 npos
      */
-    void _do_clear(NodeBase* root);
+    uint32_t _compile_node(NodeBase* _node, CompiledTree<ResultType>& _compiled) const;
 
-    bool can_stop(std::vector<ResultType>& _train_y);
+    /**
+     * 按照某一列的编码对行下标进行原地划分，划分后编码为code的行位于[_bucket_begin[code], _bucket_begin[code + 1])中
+     * @param _column 用于划分的列的编码数组
+     * @param _cardinality 该列的字典大小
+     * @param _rows 需要划分的行下标，会被原地重排
+     * @param _row_count 需要划分的行数
+     * @param _bucket_begin 输出每个编码对应的区间的起点，长度为_cardinality + 1
+     */
+    static void _partition(const uint32_t* _column, size_t _cardinality, uint32_t* _rows, size_t _row_count,
+                           std::vector<size_t>& _bucket_begin);
 
     /**
      * 以某一节点为树根，根据已有数据进行建树
-     * @param _train_x 一个map<string, vector<AttributeType>>，表示训练数据集，string代表属性的名字，相同下标的代表同一个数据
-     * @param _train_y 一个一维数组，表示_train_x的每一行的结果
-     * @param _attribute_name_list 一个一维数组，表示_train_x的每一列所属的属性名
+     * 整个训练过程共用一个行下标数组，每个节点只拥有其中的一段，子节点拥有的是父节点区间划分后得到的子区间
+     * @param _dataset 编码后的训练数据集
+     * @param _rows 当前节点拥有的数据的行下标区间的起点
+     * @param _row_count 当前节点拥有的数据的行数
+     * @param _attribute_index_list 当前节点可以使用的属性的列下标
+     * @param _histograms 当前节点在每一个属性上的直方图，与_attribute_index_list一一对应，为空时由当前节点统计
+     * @param _node_seed 当前节点随机选取候选属性的种子，只与节点在树中的位置有关，与线程的调度无关
+     * @param _depth 当前节点的深度，根节点为0
+     * @param _local_arena 当前任务分配节点使用的位置，提交到线程池的子树使用各自的位置
+     * @param Criterion 选择划分属性时使用的划分准则，见 split_criterion.h
+     */
+    template<class Criterion>
+    NodeBase* _do_decision(const Dataset<AttributeType, ResultType>& _dataset, uint32_t* _rows, size_t _row_count, const std::vector<size_t>& _attribute_index_list, std::vector<Histogram> _histograms, uint64_t _node_seed, size_t _depth, NodeArena::Local& _local_arena);
+
+    /**
+     * 在给定的行上训练决策树，是所有在 Dataset 上训练的入口，会清空之前训练得到的模型
+     * @param _dataset 编码后的训练数据集
+     * @param _rows 参与训练的行下标，可以重复，训练过程中会被原地重排
+     * @param Criterion 划分准则
+     */
+    template<class Criterion>
+    void _fit(const Dataset<AttributeType, ResultType>& _dataset, std::vector<uint32_t>& _rows);
+
+    /**
+     * 从当前节点可以使用的属性中随机选取_max_features个候选属性，候选属性保持原来的顺序
+     * @param _attribute_index_list 当前节点可以使用的属性的列下标
+     * @param _node_seed 当前节点的种子
+     * @param _candidates 选取的候选属性
+     */
+    void _sample_attributes(const std::vector<size_t>& _attribute_index_list, uint64_t _node_seed,
+                            std::vector<size_t>& _candidates) const;
+
+    /**
+     * 由一个种子与一个编号得到新的种子(splitmix64)，用于为子节点以及集成中的每一棵树生成互不相关的种子
+     * @param _seed 种子
+     * @param _index 编号
+     * @return 新的种子
+     */
+    static uint64_t _mix_seed(uint64_t _seed, uint64_t _index);
+
+    /**
+     * 判断一个节点是否会直接成为结果节点(或空节点)，这样的节点不需要统计直方图
+     * @param _dataset 编码后的训练数据集
+     * @param _rows 节点拥有的数据的行下标
+     * @param _row_count 节点拥有的数据的行数
+     * @param _attribute_index_list 节点可以使用的属性的列下标
+     * @param _depth 节点的深度
+     * @return 不会继续划分时返回true
+     */
+    bool _is_leaf(const Dataset<AttributeType, ResultType>& _dataset, const uint32_t* _rows, size_t _row_count,
+                  const std::vector<size_t>& _attribute_index_list, size_t _depth);
+
+    /**
+     * 判断一个节点是否被预剪枝的条件限制为结果节点，只需要行数与深度，在统计任何直方图之前进行
+     * @param _row_count 节点拥有的数据的行数
+     * @param _depth 节点的深度
+     * @return 不允许继续划分时返回true
+     */
+    bool _pre_pruned(size_t _row_count, size_t _depth) const;
+
+    /**
+     * 判断选出的划分是否带来了足够的改进，改进为不划分的评分减去划分的评分
+     * @param Criterion 划分准则
+     * @param _class_totals 节点上每一种结果的数量
+     * @param _class_count 结果的数量
+     * @param _split 选出的划分
+     * @return 改进不少于 _min_improvement 时返回true
+     */
+    template<class Criterion>
+    bool _enough_improvement(const uint32_t* _class_totals, size_t _class_count, const Split& _split) const;
+
+    /**
+     * 为一次划分预留结果节点：划分把一个结果节点替换为_child_count个，限制了结果节点的数量时检查是否超过上限
+     * @param _child_count 划分产生的子节点的数量
+     * @return 可以划分时返回true，并且计入预留的结果节点
      */
-    NodeBase* _do_decision(std::map<std::string, std::vector<AttributeType>>& _train_x, std::vector<ResultType>& _train_y, std::vector<std::string>& _attribute_name_list, bool is_cut=false, std::string& cut_method= (std::string &) "prev", std::string& _decision_method= (std::string &) "KILC");
+    bool _reserve_leaves(size_t _child_count);
+
+    /**
+     * 计算一个节点在所有属性上的直方图的格子总数，即相减一次的代价
+     * @param _dataset 编码后的训练数据集，Dataset 或 ColumnStore
+     * @param _attribute_index_list 节点可以使用的属性的列下标
+     * @return 格子总数
+     */
+    template<class DatasetType>
+    static size_t _histogram_cells(const DatasetType& _dataset, const std::vector<size_t>& _attribute_index_list);
+
+    /**
+     * 创建一个结果节点，结果为当前节点拥有的数据中出现次数最多的结果，数量相同时选择编码较小的结果
+     * @param _labels 结果的编码数组
+     * @param _rows 当前节点拥有的数据的行下标
+     * @param _row_count 当前节点拥有的数据的行数
+     * @param _local_arena 分配节点使用的位置
+     * @return 新创建的结果节点
+     */
+    NodeBase* _majority_leaf(const uint32_t* _labels, const uint32_t* _rows, size_t _row_count,
+                             NodeArena::Local& _local_arena);
+
+    /**
+     * 在内存池中创建一个结果节点
+     * @param _result_code 结果的编码
+     * @param _local_arena 分配节点使用的位置
+     * @return 新创建的结果节点
+     */
+    NodeBase* _result_node(uint32_t _result_code, NodeArena::Local& _local_arena);
+
+    /**
+     * 在内存池中创建一个决策节点，子节点表的长度为该列的字典大小，所有子节点初始为空指针
+     * @param _attribute_index 决策的列下标
+     * @param _local_arena 分配节点使用的位置
+     * @return 新创建的决策节点
+     */
+    DecisionNode<AttributeType>* _decision_node(size_t _attribute_index, NodeArena::Local& _local_arena);
+
+    /**
+     * 训练结束后整理统计结果，没有开启统计时清空统计结果
+     */
+    void _finish_stats();
+
+    /**
+     * 使用给定的划分准则在编码后的数据集上选择划分，足够大的节点会在线程池中并行计算各个属性的评分
+     * @param Criterion 划分准则
+     * @param _dataset 编码后的训练数据集
+     * @param _rows 当前节点拥有的数据的行下标
+     * @param _row_count 当前节点拥有的数据的行数
+     * @param _attribute_index_list 当前节点可以使用的属性的列下标
+     * @return 返回选择的划分
+     */
+    template<class Criterion>
+    Split _find_split(const Dataset<AttributeType, ResultType>& _dataset,
+                                      const uint32_t* _rows, size_t _row_count,
+                                      const std::vector<size_t>& _attribute_index_list) const;
 
 public:
     /**
@@ -63,7 +238,7 @@ public:
     DecisionTree();
 
     /**
-     * 决策树的析构函数，会对当前的树进行递归式删除(借助DecisionNode类型的析构函数)
+     * 决策树的析构函数，所有节点随着内存池一起释放
      */
     ~DecisionTree();
 
@@ -72,13 +247,143 @@ public:
      */
     void clear();
 
+    /**
+     * 获取最近一次训练的统计结果，只有定义了 DESITIONTREE_ENABLE_STATS 时才会收集，否则所有值都为0
+     * @return 统计结果，见 train_stats.h
+     */
+    const TrainStats& stats() const;
+
+    /**
+     * 设置训练时使用的线程数，线程池由决策树持有，直到下一次设置或决策树析构
+     * @param _thread_count 参与训练的线程总数，为1时在当前线程中进行训练，为0时使用硬件支持的线程数
+     */
+    void set_thread_count(size_t _thread_count);
+
+    /**
+     * 获取训练时使用的线程数
+     * @return 参与训练的线程总数
+     */
+    size_t thread_count() const;
+
+    /**
+     * 设置并行训练的阈值，行数少于该值的节点在当前线程中直接创建，不再拆分为任务
+     * @param _parallel_cutoff 节点的行数阈值
+     */
+    void set_parallel_cutoff(size_t _parallel_cutoff);
+
+    /**
+     * 设置每个节点随机选取的候选属性的个数，用于随机森林等集成方法，只对在 Dataset 上的训练生效
+     * @param _max_features 候选属性的个数，为0或者不少于可以使用的属性个数时使用所有属性
+     * @param _seed 随机选取的种子，相同的种子与数据得到相同的决策树，与线程数无关
+     */
+    void set_max_features(size_t _max_features, uint64_t _seed = 0);
+
+    /**
+     * 设置决策节点的最大深度，根节点的深度为0，深度达到该值的节点直接成为结果节点
+     * @param _max_depth 最大深度，为0时没有限制
+     */
+    void set_max_depth(size_t _max_depth);
+
+    /**
+     * 设置继续划分的节点至少拥有的行数，行数更少的节点直接成为结果节点
+     * @param _min_split_rows 行数
+     */
+    void set_min_split_rows(size_t _min_split_rows);
+
+    /**
+     * 设置划分后每个有数据的子节点至少拥有的行数，不满足的划分不会被选择，没有满足的划分时成为结果节点
+     * @param _min_child_rows 行数，至少为1
+     */
+    void set_min_child_rows(size_t _min_child_rows);
+
+    /**
+     * 设置划分的最小改进，即不划分的评分减去划分的评分(信息增益、基尼指数的减少量、增益率)，改进更小时成为结果节点
+     * @param _min_improvement 最小改进，为0时不检查
+     */
+    void set_min_improvement(double _min_improvement);
+
+    /**
+     * 设置结果节点数量的上限，会使划分超过上限的节点直接成为结果节点
+     * @param _max_leaves 上限，为0时没有限制
+     */
+    void set_max_leaves(size_t _max_leaves);
+
     /**
      * 对决策树模型进行训练，传入训练样本的自变量、结果、参数名，进行训练
      * @param _train_x 一个map<string, vector<AttributeType>>，表示训练数据集，string代表属性的名字，相同下标的代表同一个数据
      * @param _train_y 一个一维数组，表示_train_x的每一行的结果
      * @param _attribute_name_list 一个一维数组，表示_train_x的每一列所属的属性名
+     * @param _decision_method 选择划分属性的方法，可以选择 信息增益(KILC)、增益率(GAIN_RATIO)、基尼系数(GINI_INDEX)
      */
-    void fit(std::map<std::string, std::vector<AttributeType>>& _train_x, std::vector<ResultType>& _train_y, std::vector<std::string>& _attribute_name_list, bool is_cut=false, std::string& cut_method= (std::string &) "prev", std::string& _decision_method= (std::string &) "KILC");
+    void fit(std::map<std::string, std::vector<AttributeType>>& _train_x, std::vector<ResultType>& _train_y, std::vector<std::string>& _attribute_name_list, const std::string& _decision_method="KILC");
+
+    /**
+     * 旧的训练接口，剪枝参数不再使用，与 fit(_train_x, _train_y, _attribute_name_list, _decision_method) 相同
+     * 预剪枝通过 set_max_depth 等函数设置。剪枝开关只接受bool，fit(x, y, names, "GINI_INDEX") 不会匹配该重载
+     */
+    template<class CutFlag, class = typename std::enable_if<std::is_same<CutFlag, bool>::value>::type>
+    [[deprecated("is_cut/cut_method are ignored, use set_max_depth and the other pre-pruning setters")]]
+    void fit(std::map<std::string, std::vector<AttributeType>>& _train_x, std::vector<ResultType>& _train_y, std::vector<std::string>& _attribute_name_list, CutFlag, const std::string& ="prev", const std::string& _decision_method="KILC");
+
+    /**
+     * 在编码后的数据集上对决策树模型进行训练，会清空之前训练得到的模型
+     * @param _dataset 编码后的训练数据集
+     * @param _decision_method 选择划分属性的方法，可以选择 信息增益(KILC)、增益率(GAIN_RATIO)、基尼系数(GINI_INDEX)，
+     * 其他取值会抛出std::invalid_argument
+     */
+    void fit(const Dataset<AttributeType, ResultType>& _dataset, const std::string& _decision_method="KILC");
+
+    /**
+     * 旧的训练接口，剪枝参数不再使用，与 fit(_dataset, _decision_method) 相同
+     * 剪枝开关只接受bool，fit(dataset, "GINI_INDEX") 不会匹配该重载
+     */
+    template<class CutFlag, class = typename std::enable_if<std::is_same<CutFlag, bool>::value>::type>
+    [[deprecated("is_cut/cut_method are ignored, use set_max_depth and the other pre-pruning setters")]]
+    void fit(const Dataset<AttributeType, ResultType>& _dataset, CutFlag, const std::string& ="prev", const std::string& _decision_method="KILC");
+
+    /**
+     * 使用编译期确定的划分准则，在编码后的数据集上对决策树模型进行训练，会清空之前训练得到的模型
+     * 例如 tree.fit(dataset, GiniIndex())，准则的评分函数会被直接内联到属性选择的循环中
+     * @param _dataset 编码后的训练数据集
+     * @param _criterion 划分准则的标签，见 split_criterion.h，只有提供了 score(const Histogram&) 的类型才会匹配该重载
+     */
+    template<class Criterion, class = decltype(Criterion::score(std::declval<const Histogram&>()))>
+    void fit(const Dataset<AttributeType, ResultType>& _dataset, const Criterion& _criterion);
+
+    /**
+     * 只使用数据集中的部分行训练决策树，会清空之前训练得到的模型，数据集本身不会被复制或修改
+     * 例如随机森林的每一棵树在同一个数据集上使用各自的自助采样
+     * @param _dataset 编码后的训练数据集
+     * @param _criterion 划分准则的标签，见 split_criterion.h
+     * @param _rows 参与训练的行下标，可以重复，重复的行按照出现的次数计数
+     */
+    template<class Criterion, class = decltype(Criterion::score(std::declval<const Histogram&>()))>
+    void fit(const Dataset<AttributeType, ResultType>& _dataset, const Criterion& _criterion,
+             const std::vector<uint32_t>& _rows);
+
+    /**
+     * 在磁盘上的列式编码数据集上逐层训练决策树，会清空之前训练得到的模型，训练得到的模型与在相同数据上的 fit(Dataset) 相同
+     * 每一层只需要按照行的区间顺序地读取一遍所有的列，常驻内存主要由当前层的直方图以及正在读取的区间组成，
+     * 另外每一行需要4个字节记录它所在的节点
+     * @param _store 列式编码数据集
+     * @param _vocabularies 每一列的字典，例如 ColumnStoreWriter::vocabularies()，大小必须与数据集中的字典大小一致
+     * @param _result_vocabulary 结果的字典，例如 ColumnStoreWriter::result_vocabulary()
+     * @param _criterion 划分准则的标签，见 split_criterion.h
+     * @param _memory_budget 直方图与读取区间可以使用的内存的字节数，默认为256MB
+     */
+    template<class Criterion>
+    void fit(const ColumnStore& _store, const std::vector<Vocabulary<AttributeType>>& _vocabularies,
+             const Vocabulary<ResultType>& _result_vocabulary, const Criterion& _criterion,
+             size_t _memory_budget = (size_t)256 << 20);
+
+    /**
+     * 在磁盘上的列式编码数据集上逐层训练决策树，字典直接从数据集的目录中读取，见 ColumnStore::vocabularies
+     * @param _store 列式编码数据集，必须由版本2及之后的 ColumnStoreWriter 写入
+     * @param _criterion 划分准则的标签，见 split_criterion.h
+     * @param _memory_budget 直方图与读取区间可以使用的内存的字节数，默认为256MB
+     */
+    template<class Criterion, class = decltype(Criterion::score(std::declval<const Histogram&>()))>
+    void fit(const ColumnStore& _store, const Criterion& _criterion, size_t _memory_budget = (size_t)256 << 20);
 
     /**
      * 给出数据，使用当前的模型进行预测
@@ -87,6 +392,57 @@ public:
      */
     void transform(std::map<std::string, AttributeType>& _test_x, std::vector<ResultType>& _test_y);
 
+    /**
+     * 将训练得到的决策树编译为连续存放的节点数组，编译后的决策树只使用整数下标进行预测
+     * @return 编译后的决策树，输入的编码可以通过 encode 得到
+     */
+    CompiledTree<ResultType> compile() const;
+
+    /**
+     * 将训练得到的决策树导出为可以保存与加载的模型，模型包含编译后的决策树以及预测时编码所需的属性名与字典
+     * @return 导出的模型，可以通过 TreeModel::save 保存为二进制文件
+     */
+    TreeModel<AttributeType, ResultType> export_model() const;
+
+    /**
+     * 使用训练时的字典对一行数据进行编码，编码后的数据按照列下标排列
+     * @param _test_x 用于预测的数据，一个map，从string映射到AttributeType
+     * @param _codes 编码的结果，缺失的属性以及训练时没有出现过的属性值编码为 CompiledTree::npos
+     */
+    void encode(const std::map<std::string, AttributeType>& _test_x, std::vector<uint32_t>& _codes) const;
+
+    /**
+     * 使用训练时的字典对按列存放的一批数据进行编码，每一列只需要查找一次属性名
+     * @param _test_x 用于预测的数据，一个map<string, vector<AttributeType>>，相同下标的代表同一个数据
+     * @param _columns 编码的结果，按照列下标排列，缺失的属性以及训练时没有出现过的属性值编码为 CompiledTree::npos
+     */
+    void encode(const std::map<std::string, std::vector<AttributeType>>& _test_x,
+                std::vector<std::vector<uint32_t>>& _columns) const;
+
+    /**
+     * 查找属性名对应的列下标，用于在加载模型时一次性确定输入的列顺序
+     * @param _attribute_name 属性名
+     * @param _attribute_index 属性的列下标，仅在返回true时有效
+     * @return 如果该属性参与了训练则返回true，否则返回false
+     */
+    bool find_attribute(const std::string& _attribute_name, size_t& _attribute_index) const;
+
+    /**
+     * 使用训练时的字典对某一列的一个值进行编码
+     * @param _attribute_index 属性的列下标
+     * @param _value 属性值
+     * @return 属性值的编码，训练时没有出现过的属性值为 CompiledTree::npos
+     */
+    uint32_t encode(size_t _attribute_index, const AttributeType& _value) const;
+
+    /**
+     * 对编码后的一行数据进行预测，每一层直接按照节点记录的列下标读取编码，不需要查找属性名
+     * @param _row 按照列下标排列的属性值编码，可以通过 encode 得到，未知的属性值使用 CompiledTree::npos 表示
+     * @param _result 预测的结果，仅在返回true时有效
+     * @return 能够给出预测时返回true
+     */
+    bool predict(const uint32_t* _row, ResultType& _result) const;
+
     /**
      * 通过当前的数据集以及相应的方法，选择最适合的属性，并且返回相应的属性名。 这里本质上是一个选择器
      * @param _train_x 一个map<string, vector<AttributeType>>，表示训练数据集，string代表属性的名字，相同下标的代表同一个数据
@@ -98,6 +454,19 @@ public:
     std::string select_decision_attribute(std::map<std::string, std::vector<AttributeType>>& _train_x,
                                           std::vector<ResultType>& _train_y,
                                           std::vector<std::string>& _attribute_name_list, std::string& _decision_method);
+
+    /**
+     * 在编码后的数据集上选择最适合的属性，并且返回相应的列下标
+     * @param _dataset 编码后的训练数据集
+     * @param _rows 当前节点拥有的数据的行下标
+     * @param _row_count 当前节点拥有的数据的行数
+     * @param _attribute_index_list 当前节点可以使用的属性的列下标
+     * @param _decision_method 进行选择的方法，可以选择 信息增益(KILC)、增益率(GAIN_RATIO)、基尼系数(GINI_INDEX)
+     * @return 返回选择的属性的列下标
+     */
+    size_t select_decision_attribute(const Dataset<AttributeType, ResultType>& _dataset,
+                                     const uint32_t* _rows, size_t _row_count,
+                                     const std::vector<size_t>& _attribute_index_list, const std::string& _decision_method);
 };
 
 /**
@@ -106,46 +475,112 @@ public:
 template<class AttributeType, class ResultType>
 DecisionTree<AttributeType, ResultType>::DecisionTree() {
     this->_root = nullptr;
+    this->_parallel_cutoff = 4096;
+    this->_max_features = 0;
+    this->_feature_seed = 0;
+    this->_max_depth = 0;
+    this->_min_split_rows = 0;
+    this->_min_child_rows = 1;
+    this->_min_improvement = 0.0;
+    this->_max_leaves = 0;
+    this->_open_leaves = 0;
 }
 
 /**
- * 决策树的析构函数，会对当前的树进行递归式删除(借助DecisionNode类型的析构函数)
+ * 决策树的析构函数，所有节点随着内存池一起释放
  */
 template<class AttributeType, class ResultType>
-DecisionTree<AttributeType, ResultType>::~DecisionTree() {
-    this->_root;
-}
+DecisionTree<AttributeType, ResultType>::~DecisionTree() = default;
 
 /**
  * 清空决策树中的所有节点及其记录的所有信息
- * 递归式删除，并且将根结点所指向的设置为nullptr
+ * 所有节点都在内存池中，不需要遍历树的结构，直接清空内存池，并且将根结点所指向的设置为nullptr
  */
 template<class AttributeType, class ResultType>
 void DecisionTree<AttributeType, ResultType>::clear() {
-    this->_do_clear(this->_root);
+    this->_arena.clear();
     this->_root = nullptr;
+    this->_stats = TrainStats();
+}
+
+template<class AttributeType, class ResultType>
+const TrainStats &DecisionTree<AttributeType, ResultType>::stats() const {
+    return this->_stats;
 }
 
 /**
- * 清空以root为根的所有节点及其记录的所有信息
- * @param root 需要清除的子树的根节点
+ * 设置训练时使用的线程数，线程池由决策树持有，直到下一次设置或决策树析构
+ * 选择划分属性时，各个属性的评分会在线程池中并行计算，选择的结果与线程数无关
+ * @param _thread_count 参与训练的线程总数，为1时在当前线程中进行训练，为0时使用硬件支持的线程数
  */
 template<class AttributeType, class ResultType>
-void DecisionTree<AttributeType, ResultType>::_do_clear(NodeBase *root) {
-    if (root == nullptr) { // 如果当前的树根指向一个空指针，那么就无需进行更改，直接退出
-        return;
+void DecisionTree<AttributeType, ResultType>::set_thread_count(size_t _thread_count) {
+    if (_thread_count == 1) {
+        this->_thread_pool.reset();
+    } else {
+        this->_thread_pool = std::make_shared<ThreadPool>(_thread_count);
     }
-    if (root->is_result()) { // 如果当前点是一个结果点，那么就直接删除并且退出
-        ResultNode<ResultType>* del_ptr = root;
-        delete del_ptr;
-        return;
-    }
-    // 执行到这里就说明，当前点是一个决策点，我们先对其子节点进行递归删除，然后再对当前节点进行删除
-    DecisionNode<AttributeType>* del_ptr = root;
-    for(std::pair<AttributeType, NodeBase*>& item: del_ptr->_attribute_map) {
-        this->_do_clear(del_ptr->_attribute_map[item.first]); // 递归删除
-    }
-    delete root; // 递归删除结束后，删除子树的根节点的信息
+}
+
+/**
+ * 获取训练时使用的线程数
+ * @return 参与训练的线程总数
+ */
+template<class AttributeType, class ResultType>
+size_t DecisionTree<AttributeType, ResultType>::thread_count() const {
+    return this->_thread_pool ? this->_thread_pool->thread_count() : 1;
+}
+
+/**
+ * 设置并行训练的阈值，行数少于该值的节点在当前线程中直接创建，不再拆分为任务
+ * @param _parallel_cutoff 节点的行数阈值
+ */
+template<class AttributeType, class ResultType>
+void DecisionTree<AttributeType, ResultType>::set_parallel_cutoff(size_t _parallel_cutoff) {
+    this->_parallel_cutoff = _parallel_cutoff;
+}
+
+/**
+ * 设置每个节点随机选取的候选属性的个数，用于随机森林等集成方法，只对在 Dataset 上的训练生效
+ * 选取了候选属性的节点只在候选属性上统计并选择划分，不再保存直方图用于相减
+ * @param _max_features 候选属性的个数，为0或者不少于可以使用的属性个数时使用所有属性
+ * @param _seed 随机选取的种子，相同的种子与数据得到相同的决策树，与线程数无关
+ */
+template<class AttributeType, class ResultType>
+void DecisionTree<AttributeType, ResultType>::set_max_features(size_t _max_features, uint64_t _seed) {
+    this->_max_features = _max_features;
+    this->_feature_seed = _seed;
+}
+
+template<class AttributeType, class ResultType>
+void DecisionTree<AttributeType, ResultType>::set_max_depth(size_t _max_depth) {
+    this->_max_depth = _max_depth;
+}
+
+template<class AttributeType, class ResultType>
+void DecisionTree<AttributeType, ResultType>::set_min_split_rows(size_t _min_split_rows) {
+    this->_min_split_rows = _min_split_rows;
+}
+
+template<class AttributeType, class ResultType>
+void DecisionTree<AttributeType, ResultType>::set_min_child_rows(size_t _min_child_rows) {
+    this->_min_child_rows = std::max<size_t>(1, _min_child_rows);
+}
+
+template<class AttributeType, class ResultType>
+void DecisionTree<AttributeType, ResultType>::set_min_improvement(double _min_improvement) {
+    this->_min_improvement = _min_improvement;
+}
+
+/**
+ * 设置结果节点数量的上限，会使划分超过上限的节点直接成为结果节点
+ * 限制了结果节点的数量时，子树按照深度优先的顺序在当前线程中依次创建(各个属性的评分仍然并行计算)，
+ * 因此先创建的子树优先使用预算，训练的结果与线程数无关
+ * @param _max_leaves 上限，为0时没有限制
+ */
+template<class AttributeType, class ResultType>
+void DecisionTree<AttributeType, ResultType>::set_max_leaves(size_t _max_leaves) {
+    this->_max_leaves = _max_leaves;
 }
 
 /**
@@ -157,36 +592,391 @@ void DecisionTree<AttributeType, ResultType>::_do_clear(NodeBase *root) {
 template<class AttributeType, class ResultType>
 void DecisionTree<AttributeType, ResultType>::fit(
         std::map<std::string, std::vector<AttributeType>>& _train_x, std::vector<ResultType>& _train_y, std::vector<std::string>& _attribute_name_list,
-        bool is_cut, std::string& cut_method, std::string& _decision_method){
-    // 初始化自身的 _attribute_list, 记录所有属性的可能
-    for(std::string& iter: _attribute_name_list) {
-        for(AttributeType& _attribute: _train_x[iter]) {
-            bool found = false;
-            for(auto& it: this->_attribute_list[iter]){
-                if(it == _attribute){
-                    found = true;
+        const std::string& _decision_method){
+    // 对训练数据进行一次字典编码，之后的训练过程只访问编码后的列，各列的编码在线程池中并行进行
+    DESITIONTREE_STATS(auto vocabulary_begin = std::chrono::steady_clock::now();)
+    Dataset<AttributeType, ResultType> dataset(_train_x, _train_y, _attribute_name_list, this->_thread_pool.get());
+    DESITIONTREE_STATS(auto vocabulary_end = std::chrono::steady_clock::now();)
+    this->fit(dataset, _decision_method);
+    // 编码在训练开始之前完成，计入这一次训练的统计
+    DESITIONTREE_STATS(
+        this->_stats.vocabulary_seconds = std::chrono::duration<double>(vocabulary_end - vocabulary_begin).count();
+        this->_stats.bytes_copied += (uint64_t)dataset.row_count() * (dataset.attribute_count() + 1) * sizeof(uint32_t);
+    )
+}
+
+/**
+ * 在编码后的数据集上对决策树模型进行训练，会清空之前训练得到的模型
+ * 方法名只在这里比较一次，之后的建树过程全部使用对应的划分准则类型
+ * @param _dataset 编码后的训练数据集
+ * @param _decision_method 选择划分属性的方法，可以选择 信息增益(KILC)、增益率(GAIN_RATIO)、基尼系数(GINI_INDEX)，
+ * 其他取值会抛出std::invalid_argument
+ */
+template<class AttributeType, class ResultType>
+void DecisionTree<AttributeType, ResultType>::fit(const Dataset<AttributeType, ResultType> &_dataset,
+                                                  const std::string &_decision_method) {
+    if (_decision_method == InformationGain::name()) {
+        this->fit(_dataset, InformationGain());
+    } else if (_decision_method == GainRatio::name()) {
+        this->fit(_dataset, GainRatio());
+    } else if (_decision_method == GiniIndex::name()) {
+        this->fit(_dataset, GiniIndex());
+    } else {
+        throw std::invalid_argument("DecisionTree: unknown decision method '" + _decision_method + "'");
+    }
+}
+
+/**
+ * 旧的训练接口，剪枝参数不再使用，预剪枝通过 set_max_depth 等函数设置
+ */
+template<class AttributeType, class ResultType>
+template<class CutFlag, class>
+void DecisionTree<AttributeType, ResultType>::fit(
+        std::map<std::string, std::vector<AttributeType>>& _train_x, std::vector<ResultType>& _train_y, std::vector<std::string>& _attribute_name_list,
+        CutFlag, const std::string&, const std::string& _decision_method){
+    this->fit(_train_x, _train_y, _attribute_name_list, _decision_method);
+}
+
+/**
+ * 旧的训练接口，剪枝参数不再使用，预剪枝通过 set_max_depth 等函数设置
+ */
+template<class AttributeType, class ResultType>
+template<class CutFlag, class>
+void DecisionTree<AttributeType, ResultType>::fit(const Dataset<AttributeType, ResultType> &_dataset, CutFlag,
+                                                  const std::string &, const std::string &_decision_method) {
+    this->fit(_dataset, _decision_method);
+}
+
+/**
+ * 使用编译期确定的划分准则，在编码后的数据集上对决策树模型进行训练，会清空之前训练得到的模型
+ * @param _dataset 编码后的训练数据集
+ * @param _criterion 划分准则的标签，见 split_criterion.h
+ */
+template<class AttributeType, class ResultType>
+template<class Criterion, class>
+void DecisionTree<AttributeType, ResultType>::fit(const Dataset<AttributeType, ResultType> &_dataset,
+                                                  const Criterion &) {
+    // 整个训练过程只使用这一个行下标数组，建树时在其上进行原地划分
+    std::vector<uint32_t> rows(_dataset.row_count());
+    for(size_t row = 0; row < rows.size(); ++ row) {
+        rows[row] = (uint32_t)row;
+    }
+    this->template _fit<Criterion>(_dataset, rows);
+}
+
+/**
+ * 只使用数据集中的部分行训练决策树，会清空之前训练得到的模型，数据集本身不会被复制或修改
+ * @param _dataset 编码后的训练数据集
+ * @param _criterion 划分准则的标签，见 split_criterion.h
+ * @param _rows 参与训练的行下标，可以重复，重复的行按照出现的次数计数
+ */
+template<class AttributeType, class ResultType>
+template<class Criterion, class>
+void DecisionTree<AttributeType, ResultType>::fit(const Dataset<AttributeType, ResultType> &_dataset,
+                                                  const Criterion &, const std::vector<uint32_t> &_rows) {
+    for(uint32_t row: _rows) {
+        if (row >= _dataset.row_count()) {
+            throw std::out_of_range("DecisionTree::fit: row index out of range");
+        }
+    }
+    std::vector<uint32_t> rows(_rows);
+    this->template _fit<Criterion>(_dataset, rows);
+}
+
+/**
+ * 在给定的行上训练决策树，是所有在 Dataset 上训练的入口，会清空之前训练得到的模型
+ * @param _dataset 编码后的训练数据集
+ * @param _rows 参与训练的行下标，可以重复，训练过程中会被原地重排
+ * @param Criterion 划分准则
+ */
+template<class AttributeType, class ResultType>
+template<class Criterion>
+void DecisionTree<AttributeType, ResultType>::_fit(const Dataset<AttributeType, ResultType> &_dataset,
+                                                   std::vector<uint32_t> &_rows) {
+    this->clear();
+    // 记录每一列的属性名、所有属性的可能以及所有可能的结果，它们直接来自于数据集的字典
+    this->_attribute_names.clear();
+    this->_attribute_list.clear();
+    this->_numeric_list.clear();
+    std::vector<size_t> attribute_index_list;
+    for(size_t index = 0; index < _dataset.attribute_count(); ++ index) {
+        this->_attribute_names.push_back(_dataset.attribute_name(index));
+        this->_attribute_list.push_back(_dataset.vocabulary(index));
+        this->_numeric_list.push_back(_dataset.is_numeric(index));
+        attribute_index_list.push_back(index);
+    }
+    this->_result_list = _dataset.result_vocabulary();
+    DESITIONTREE_STATS(this->_stats_collector.reset();)
+    this->_open_leaves = 1;
+    NodeArena::Local local_arena(this->_arena);
+    this->_root = this->template _do_decision<Criterion>(_dataset, _rows.data(), _rows.size(), attribute_index_list,
+                                                          std::vector<Histogram>(), this->_feature_seed, 0, local_arena);
+    this->_finish_stats();
+}
+
+/**
+ * 在磁盘上的列式编码数据集上逐层训练决策树，字典直接从数据集的目录中读取，见 ColumnStore::vocabularies
+ * @param _store 列式编码数据集，必须由版本2及之后的 ColumnStoreWriter 写入
+ * @param _criterion 划分准则的标签，见 split_criterion.h
+ * @param _memory_budget 直方图与读取区间可以使用的内存的字节数
+ */
+template<class AttributeType, class ResultType>
+template<class Criterion, class>
+void DecisionTree<AttributeType, ResultType>::fit(const ColumnStore &_store, const Criterion &_criterion,
+                                                  size_t _memory_budget) {
+    this->fit(_store, _store.template vocabularies<AttributeType>(), _store.template result_vocabulary<ResultType>(),
+              _criterion, _memory_budget);
+}
+
+/**
+ * 在磁盘上的列式编码数据集上逐层训练决策树，会清空之前训练得到的模型，训练得到的模型与在相同数据上的 fit(Dataset) 相同
+ *
+ * <p>每一层的训练分为以下几步</p>
+ * <ul>
+ *  <li>按照行的区间依次读取：先根据上一层的划分更新每一行所在的节点，再把区间中的行按照节点分组，累加到每个节点的直方图中，
+ *  处理完一个区间后立即将它移出常驻内存</li>
+ *  <li>当前层的直方图超过预算的一半时，节点被分为若干组，每一组各自读取一遍</li>
+ *  <li>根据直方图为当前层的每个节点选择划分或者成为结果节点，有数据的子节点组成下一层</li>
+ * </ul>
+ * 终止条件与 _do_decision 相同：只剩下一个属性时选择众数，结果唯一时停止，没有数据的子节点使用编码为0的结果
+ * 预剪枝的条件同样生效，子节点的行数与结果的数量直接来自父节点的直方图，因此被剪枝的子节点不会参与下一层的统计；
+ * 限制了结果节点的数量时按照层的顺序使用预算，得到的模型可能与 fit(Dataset) 按照深度优先的顺序得到的不同
+ * @param _store 列式编码数据集
+ * @param _vocabularies 每一列的字典，大小必须与数据集中的字典大小一致，否则抛出std::invalid_argument
+ * @param _result_vocabulary 结果的字典，大小必须与数据集中结果的数量一致
+ * @param _criterion 划分准则的标签，见 split_criterion.h
+ * @param _memory_budget 直方图与读取区间可以使用的内存的字节数
+ */
+template<class AttributeType, class ResultType>
+template<class Criterion>
+void DecisionTree<AttributeType, ResultType>::fit(const ColumnStore &_store,
+                                                  const std::vector<Vocabulary<AttributeType>> &_vocabularies,
+                                                  const Vocabulary<ResultType> &_result_vocabulary,
+                                                  const Criterion &, size_t _memory_budget) {
+    if (_vocabularies.size() != _store.attribute_count() || _result_vocabulary.size() != _store.class_count()) {
+        throw std::invalid_argument("DecisionTree: vocabularies do not match the column store");
+    }
+    for(size_t index = 0; index < _vocabularies.size(); ++ index) {
+        if (_vocabularies[index].size() != _store.cardinality(index)) {
+            throw std::invalid_argument("DecisionTree: vocabularies do not match the column store");
+        }
+    }
+    this->clear();
+    this->_attribute_names.clear();
+    this->_attribute_list = _vocabularies;
+    this->_numeric_list.assign(_store.attribute_count(), false);
+    this->_result_list = _result_vocabulary;
+    std::vector<size_t> attribute_index_list;
+    for(size_t index = 0; index < _store.attribute_count(); ++ index) {
+        this->_attribute_names.push_back(_store.attribute_name(index));
+        attribute_index_list.push_back(index);
+    }
+    DESITIONTREE_STATS(this->_stats_collector.reset();)
+    this->_open_leaves = 1;
+    if (attribute_index_list.empty() || _store.row_count() == 0) {
+        this->_finish_stats();
+        return;
+    }
+    const uint32_t closed = CompiledTree<ResultType>::npos; // 已经成为结果节点的行
+    const size_t row_count = _store.row_count();
+    const uint32_t* labels = _store.labels();
+    // 当前层的一个节点，创建后挂到父节点上
+    struct LevelNode {
+        DecisionNode<AttributeType>* parent; // 父节点，根节点为空
+        size_t parent_attribute; // 父节点划分使用的列下标
+        uint32_t code; // 在父节点中对应的属性值编码
+        std::vector<size_t> attributes; // 可以使用的属性的列下标
+    };
+    auto attach = [this](const LevelNode& _level_node, NodeBase* _node) {
+        if (_level_node.parent == nullptr) {
+            this->_root = _node;
+        } else {
+            _level_node.parent->set_child(_level_node.code, _node);
+        }
+    };
+    // 每一种结果的数量中最多的一个，数量相同时选择编码较小的结果，同时统计出现过的结果的种类
+    auto majority_of = [](const uint32_t* _counts, size_t _class_count, size_t& _class_kinds) {
+        size_t majority = 0;
+        _class_kinds = 0;
+        for(size_t cls = 0; cls < _class_count; ++ cls) {
+            _class_kinds += _counts[cls] > 0;
+            if (_counts[cls] > _counts[majority]) {
+                majority = cls;
+            }
+        }
+        return (uint32_t)majority;
+    };
+    NodeArena::Local local_arena(this->_arena); // 节点只在当前线程中创建
+    std::vector<LevelNode> frontier {{nullptr, 0, 0, attribute_index_list}};
+    std::vector<uint32_t> node_of_row(row_count, 0); // 每一行所在的当前层的节点
+    std::vector<uint32_t> split_attribute; // 上一层每个节点划分使用的列下标，成为结果节点的为 closed
+    std::vector<size_t> child_offset; // 上一层每个节点的子节点表在 child_table 中的起点
+    std::vector<uint32_t> child_table; // 上一层的子节点在当前层中的下标，下标为属性值的编码
+    const size_t chunk_rows = std::max<size_t>(1, _memory_budget / 2 / ((_store.attribute_count() + 3) * sizeof(uint32_t)));
+    std::vector<uint32_t> chunk_buffer(std::min(chunk_rows, row_count)); // 区间中的行按照节点分组后的结果
+    for(size_t depth = 0; !frontier.empty(); ++ depth) {
+        std::vector<LevelNode> next_frontier;
+        std::vector<uint32_t> next_split_attribute(frontier.size(), closed);
+        std::vector<size_t> next_child_offset(frontier.size(), 0);
+        std::vector<uint32_t> next_child_table;
+        bool reassign = !split_attribute.empty();
+        for(size_t group_begin = 0; group_begin < frontier.size(); ) {
+            // 按照直方图的大小将节点分组，每一组的直方图不超过预算的一半(至少包含一个节点)
+            size_t group_end = group_begin, group_bytes = 0;
+            while (group_end < frontier.size()) {
+                size_t bytes = this->_histogram_cells(_store, frontier[group_end].attributes) * sizeof(uint32_t);
+                if (group_end > group_begin && group_bytes + bytes > _memory_budget / 2) {
                     break;
                 }
+                group_bytes += bytes;
+                ++ group_end;
             }
-            if (!found) {
-                this->_attribute_list[iter].push_back(_attribute);
+            std::vector<std::vector<Histogram>> histograms(group_end - group_begin);
+            std::vector<std::pair<size_t, size_t>> tasks; // (组内节点, 属性在节点中的位置)
+            for(size_t node = group_begin; node < group_end; ++ node) {
+                std::vector<Histogram>& node_histograms = histograms[node - group_begin];
+                node_histograms.resize(frontier[node].attributes.size());
+                for(size_t position = 0; position < node_histograms.size(); ++ position) {
+                    node_histograms[position].reset(_store.cardinality(frontier[node].attributes[position]),
+                                                    _store.class_count());
+                    tasks.emplace_back(node - group_begin, position);
+                }
             }
-        }
-    }
-    // 初始化自身的 _result_list, 记录所有可能的结果
-    for(ResultType& iter: _train_y) {
-        bool found = false;
-        for(auto& it: this->_result_list){
-            if(it == iter){
-                found = true;
-                break;
+            std::vector<size_t> bucket_begin(group_end - group_begin + 1);
+            for(size_t begin = 0; begin < row_count; begin += chunk_rows) {
+                const size_t end = std::min(row_count, begin + chunk_rows);
+                if (depth == 0) { // 第一层会读取所有的行，在累加直方图之前检查编码，损坏的文件不会导致越界写入
+                    _store.check_rows(begin, end);
+                }
+                if (reassign) { // 根据上一层的划分，将每一行移动到当前层的节点
+                    DESITIONTREE_STATS(TrainStatsCollector::Timer timer(this->_stats_collector, TrainStatsCollector::PARTITION); this->_stats_collector.add_rows(end - begin);)
+                    for(size_t row = begin; row < end; ++ row) {
+                        uint32_t node = node_of_row[row];
+                        if (node == closed) {
+                            continue;
+                        }
+                        uint32_t attribute = split_attribute[node];
+                        node_of_row[row] = attribute == closed
+                                ? closed : child_table[child_offset[node] + _store.column(attribute)[row]];
+                    }
+                }
+                // 将区间中属于这一组的行按照节点分组
+                {
+                    DESITIONTREE_STATS(TrainStatsCollector::Timer timer(this->_stats_collector, TrainStatsCollector::PARTITION);)
+                    std::fill(bucket_begin.begin(), bucket_begin.end(), 0);
+                    for(size_t row = begin; row < end; ++ row) {
+                        uint32_t node = node_of_row[row];
+                        if (node != closed && node >= group_begin && node < group_end) {
+                            ++ bucket_begin[node - group_begin + 1];
+                        }
+                    }
+                    for(size_t node = 0; node + 1 < bucket_begin.size(); ++ node) {
+                        bucket_begin[node + 1] += bucket_begin[node];
+                    }
+                    std::vector<size_t> next(bucket_begin.begin(), bucket_begin.end() - 1);
+                    for(size_t row = begin; row < end; ++ row) {
+                        uint32_t node = node_of_row[row];
+                        if (node != closed && node >= group_begin && node < group_end) {
+                            chunk_buffer[next[node - group_begin] ++] = (uint32_t)row;
+                        }
+                    }
+                    DESITIONTREE_STATS(this->_stats_collector.add_bytes(bucket_begin.back() * sizeof(uint32_t));)
+                }
+                auto count = [&](size_t index) {
+                    size_t node = tasks[index].first, position = tasks[index].second;
+                    histograms[node][position].accumulate(_store.column(frontier[group_begin + node].attributes[position]),
+                                                          labels, chunk_buffer.data() + bucket_begin[node],
+                                                          bucket_begin[node + 1] - bucket_begin[node]);
+                };
+                ThreadPool* pool = end - begin >= this->_parallel_cutoff ? this->_thread_pool.get() : nullptr;
+                {
+                    DESITIONTREE_STATS(TrainStatsCollector::Timer timer(this->_stats_collector, TrainStatsCollector::HISTOGRAM); this->_stats_collector.add_rows(bucket_begin.back());)
+                    if (pool != nullptr) {
+                        pool->parallel_for(0, tasks.size(), count);
+                    } else {
+                        for(size_t index = 0; index < tasks.size(); ++ index) {
+                            count(index);
+                        }
+                    }
+                }
+                _store.release_rows(begin, end);
             }
+            reassign = false;
+            // 根据直方图为这一组的每个节点选择划分或者成为结果节点
+            for(size_t node = group_begin; node < group_end; ++ node) {
+                std::vector<Histogram>& node_histograms = histograms[node - group_begin];
+                for(Histogram& histogram: node_histograms) {
+                    histogram.finish();
+                }
+                const LevelNode& level_node = frontier[node];
+                const Histogram& any = node_histograms[0];
+                std::vector<uint32_t> class_totals(any.class_count());
+                for(size_t cls = 0; cls < any.class_count(); ++ cls) {
+                    class_totals[cls] = any.class_total(cls);
+                }
+                size_t class_kinds = 0;
+                uint32_t majority = majority_of(class_totals.data(), class_totals.size(), class_kinds);
+                auto majority_leaf = [&]() {
+                    attach(level_node, this->_result_node(majority, local_arena));
+                };
+                if (level_node.attributes.size() == 1 || class_kinds <= 1 || this->_pre_pruned(any.total(), depth)
+                    || (this->_max_leaves != 0 && this->_open_leaves + 1 > this->_max_leaves)) {
+                    // 只剩下一种选择时选择众数，结果唯一时众数就是唯一的结果
+                    majority_leaf();
+                    continue;
+                }
+                ThreadPool* pool = any.total() >= this->_parallel_cutoff ? this->_thread_pool.get() : nullptr;
+                Split split;
+                {
+                    DESITIONTREE_STATS(TrainStatsCollector::Timer timer(this->_stats_collector, TrainStatsCollector::CRITERION);)
+                    split = find_split<Criterion>(_store, node_histograms, level_node.attributes, pool,
+                                                  this->_min_child_rows);
+                }
+                size_t attribute = split.attribute_index;
+                if (split.degenerate
+                    || (this->_min_improvement > 0.0 && !this->template _enough_improvement<Criterion>(
+                            class_totals.data(), class_totals.size(), split))
+                    || !this->_reserve_leaves(_store.cardinality(attribute))) {
+                    majority_leaf();
+                    continue;
+                }
+                auto* decision_node = this->_decision_node(attribute, local_arena);
+                attach(level_node, (NodeBase*)decision_node);
+                std::vector<size_t> child_attributes;
+                size_t position = 0;
+                for(size_t index = 0; index < level_node.attributes.size(); ++ index) {
+                    if (level_node.attributes[index] == attribute) {
+                        position = index;
+                    } else {
+                        child_attributes.push_back(level_node.attributes[index]);
+                    }
+                }
+                next_split_attribute[node] = (uint32_t)attribute;
+                next_child_offset[node] = next_child_table.size();
+                for(uint32_t code = 0; code < _store.cardinality(attribute); ++ code) {
+                    LevelNode child {decision_node, attribute, code, child_attributes};
+                    const uint32_t child_row_count = node_histograms[position].value_total(code);
+                    size_t child_class_kinds = 0;
+                    uint32_t child_majority = child_row_count == 0 ? 0 : majority_of(
+                            node_histograms[position].row(code), _store.class_count(), child_class_kinds);
+                    if (child_row_count == 0 || child_attributes.size() == 1 || child_class_kinds <= 1
+                        || this->_pre_pruned(child_row_count, depth + 1)) {
+                        // 没有数据的子节点，或者一定会成为结果节点的子节点，结果直接来自父节点的直方图，不再参与下一层的统计
+                        attach(child, this->_result_node(child_majority, local_arena));
+                        next_child_table.push_back(closed);
+                    } else {
+                        next_child_table.push_back((uint32_t)next_frontier.size());
+                        next_frontier.push_back(std::move(child));
+                    }
+                }
+            }
+            group_begin = group_end;
         }
-        if (!found) {
-            this->_result_list.push_back(iter);
-        }
+        frontier.swap(next_frontier);
+        split_attribute.swap(next_split_attribute);
+        child_offset.swap(next_child_offset);
+        child_table.swap(next_child_table);
     }
-    this->_root = this->_do_decision(_train_x, _train_y, _attribute_name_list, is_cut, cut_method, _decision_method);
 }
 
 /**
@@ -198,6 +988,11 @@ template<class AttributeType, class ResultType>
 void DecisionTree<AttributeType, ResultType>::transform(std::map<std::string, AttributeType> &_test_x,
                                                         std::vector<ResultType>& _test_y) {
     NodeBase* _cur = this->_root;
+    const AttributeType missing = AttributeType(); // 缺失的属性按照默认值进行决策，不会向_test_x中插入
+    auto value_of = [&_test_x, &missing](const std::string& _attribute_name) -> const AttributeType& {
+        auto it = _test_x.find(_attribute_name);
+        return it == _test_x.end() ? missing : it->second;
+    };
     // 从根节点开始遍历
     // 如果为空节点那么就直接退出，如果为结果节点，那么就跳出循环进行预测
     // 如果为决策节点，那么就使用do_decision函数进行一次决策
@@ -206,89 +1001,374 @@ void DecisionTree<AttributeType, ResultType>::transform(std::map<std::string, At
         if (_cur->is_result()) {
             break;
         }
+        if (_cur->is_threshold()) { // 数值型的属性，与阈值进行比较
+            auto* _threshold_node = (ThresholdNode<AttributeType>*)_cur;
+            _cur = _threshold_node->do_decision(value_of(this->_attribute_names[_threshold_node->get_attribute_index()]));
+            continue;
+        }
         // 如果是决策点，那么使用节点的决策功能进行决策，
         DecisionNode<AttributeType>* _node = (DecisionNode<AttributeType>*)_cur;
-        _cur = _node->do_decision(_test_x[_node->get_attribute_name()]);
+        _cur = _node->do_decision(value_of(this->_attribute_names[_node->get_attribute_index()]));
     }
     ResultNode<ResultType>* _node = (ResultNode<ResultType>*)_cur;
     _test_y.push_back(_node->get_result());
 }
 
+/**
+ * 将训练得到的决策树编译为连续存放的节点数组，编译后的决策树只使用整数下标进行预测
+ * @return 编译后的决策树，输入的编码可以通过 encode 得到
+ */
+template<class AttributeType, class ResultType>
+CompiledTree<ResultType> DecisionTree<AttributeType, ResultType>::compile() const {
+    CompiledTree<ResultType> compiled;
+    this->_compile_node(this->_root, compiled);
+    compiled.set_leaf_values(this->_result_list.values());
+    return compiled;
+}
+
+/**
+ * 将训练得到的决策树导出为可以保存与加载的模型，模型包含编译后的决策树以及预测时编码所需的属性名与字典
+ * @return 导出的模型，可以通过 TreeModel::save 保存为二进制文件
+ */
+template<class AttributeType, class ResultType>
+TreeModel<AttributeType, ResultType> DecisionTree<AttributeType, ResultType>::export_model() const {
+    return TreeModel<AttributeType, ResultType>(this->compile(), this->_attribute_names, this->_attribute_list,
+                                                this->_numeric_list);
+}
+
+/**
+ * 将以node为根的子树按照深度优先的顺序写入编译后的决策树
+ * 先写入当前节点并且预留出子节点表，再依次写入每一棵子树，因此同一棵子树的节点在数组中是连续的
+ * @param _node 子树的根节点
+ * @param _compiled 编译后的决策树
+ * @return 子树的根节点在编译后的决策树中的下标，空节点返回 npos
+ */
+template<class AttributeType, class ResultType>
+uint32_t DecisionTree<AttributeType, ResultType>::_compile_node(NodeBase *_node,
+                                                                CompiledTree<ResultType> &_compiled) const {
+    if (_node == nullptr) {
+        return CompiledTree<ResultType>::npos;
+    }
+    if (_node->is_result()) {
+        return _compiled.add_leaf(((ResultNode<ResultType>*)_node)->get_result_code());
+    }
+    if (_node->is_threshold()) {
+        auto* threshold_node = (ThresholdNode<AttributeType>*)_node;
+        uint32_t index = _compiled.add_threshold((uint32_t)threshold_node->get_attribute_index(),
+                                                 threshold_node->get_threshold_code());
+        _compiled.set_child(index, 0, this->_compile_node(threshold_node->get_left(), _compiled));
+        _compiled.set_child(index, 1, this->_compile_node(threshold_node->get_right(), _compiled));
+        return index;
+    }
+    auto* decision_node = (DecisionNode<AttributeType>*)_node;
+    uint32_t index = _compiled.add_decision((uint32_t)decision_node->get_attribute_index(), decision_node->child_count());
+    for(uint32_t code = 0; code < decision_node->child_count(); ++ code) {
+        if (decision_node->get_child(code) != nullptr) {
+            _compiled.set_child(index, code, this->_compile_node(decision_node->get_child(code), _compiled));
+        }
+    }
+    return index;
+}
+
+/**
+ * 使用训练时的字典对一行数据进行编码，编码后的数据按照列下标排列
+ * @param _test_x 用于预测的数据，一个map，从string映射到AttributeType
+ * @param _codes 编码的结果，缺失的属性以及训练时没有出现过的属性值编码为 CompiledTree::npos
+ */
+template<class AttributeType, class ResultType>
+void DecisionTree<AttributeType, ResultType>::encode(const std::map<std::string, AttributeType> &_test_x,
+                                                     std::vector<uint32_t> &_codes) const {
+    _codes.assign(this->_attribute_names.size(), CompiledTree<ResultType>::npos);
+    for(size_t index = 0; index < this->_attribute_names.size(); ++ index) {
+        auto it = _test_x.find(this->_attribute_names[index]);
+        if (it != _test_x.end()) {
+            _codes[index] = this->encode(index, it->second);
+        }
+    }
+}
+
+/**
+ * 使用训练时的字典对按列存放的一批数据进行编码，每一列只需要查找一次属性名
+ * @param _test_x 用于预测的数据，一个map<string, vector<AttributeType>>，相同下标的代表同一个数据
+ * @param _columns 编码的结果，按照列下标排列，缺失的属性以及训练时没有出现过的属性值编码为 CompiledTree::npos
+ */
+template<class AttributeType, class ResultType>
+void DecisionTree<AttributeType, ResultType>::encode(const std::map<std::string, std::vector<AttributeType>> &_test_x,
+                                                     std::vector<std::vector<uint32_t>> &_columns) const {
+    size_t row_count = _test_x.empty() ? 0 : _test_x.begin()->second.size();
+    _columns.resize(this->_attribute_names.size());
+    for(size_t index = 0; index < this->_attribute_names.size(); ++ index) {
+        std::vector<uint32_t>& codes = _columns[index];
+        codes.assign(row_count, CompiledTree<ResultType>::npos);
+        auto it = _test_x.find(this->_attribute_names[index]);
+        if (it == _test_x.end()) {
+            continue;
+        }
+        for(size_t row = 0; row < row_count && row < it->second.size(); ++ row) {
+            codes[row] = this->encode(index, it->second[row]);
+        }
+    }
+}
+
+/**
+ * 查找属性名对应的列下标，用于在加载模型时一次性确定输入的列顺序
+ * @param _attribute_name 属性名
+ * @param _attribute_index 属性的列下标，仅在返回true时有效
+ * @return 如果该属性参与了训练则返回true，否则返回false
+ */
+template<class AttributeType, class ResultType>
+bool DecisionTree<AttributeType, ResultType>::find_attribute(const std::string &_attribute_name,
+                                                             size_t &_attribute_index) const {
+    for(size_t index = 0; index < this->_attribute_names.size(); ++ index) {
+        if (this->_attribute_names[index] == _attribute_name) {
+            _attribute_index = index;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * 使用训练时的字典对某一列的一个值进行编码，数值型的列编码为所在分箱的编码
+ * @param _attribute_index 属性的列下标
+ * @param _value 属性值
+ * @return 属性值的编码，训练时没有出现过的属性值为 CompiledTree::npos
+ */
+template<class AttributeType, class ResultType>
+uint32_t DecisionTree<AttributeType, ResultType>::encode(size_t _attribute_index, const AttributeType &_value) const {
+    const Vocabulary<AttributeType>& vocabulary = this->_attribute_list[_attribute_index];
+    if (this->_numeric_list[_attribute_index]) {
+        return _dataset_self_use::find_bin(vocabulary.values(), _value);
+    }
+    uint32_t code = CompiledTree<ResultType>::npos;
+    vocabulary.find(_value, code);
+    return code;
+}
+
+/**
+ * 对编码后的一行数据进行预测，每一层直接按照节点记录的列下标读取编码，不需要查找属性名
+ * @param _row 按照列下标排列的属性值编码，可以通过 encode 得到，未知的属性值使用 CompiledTree::npos 表示
+ * @param _result 预测的结果，仅在返回true时有效
+ * @return 能够给出预测时返回true
+ */
+template<class AttributeType, class ResultType>
+bool DecisionTree<AttributeType, ResultType>::predict(const uint32_t *_row, ResultType &_result) const {
+    NodeBase* _cur = this->_root;
+    while (_cur != nullptr && !_cur->is_result()) {
+        if (_cur->is_threshold()) {
+            auto* _threshold_node = (ThresholdNode<AttributeType>*)_cur;
+            uint32_t code = _row[_threshold_node->get_attribute_index()];
+            if (code == CompiledTree<ResultType>::npos) { // 缺失的数值
+                return false;
+            }
+            _cur = _threshold_node->do_decision_code(code);
+        } else {
+            auto* _node = (DecisionNode<AttributeType>*)_cur;
+            _cur = _node->get_child(_row[_node->get_attribute_index()]);
+        }
+    }
+    if (_cur == nullptr) {
+        return false;
+    }
+    _result = ((ResultNode<ResultType>*)_cur)->get_result();
+    return true;
+}
+
 /**
  * 以某一节点为树根，根据已有数据进行建树，会建立出一个节点，并且进行返回
- * @param _train_x 一个map<string, vector<AttributeType>>，表示训练数据集，string代表属性的名字，相同下标的代表同一个数据
- * @param _train_y 一个一维数组，表示_train_x的每一行的结果
- * @param _attribute_name_list 一个一维数组，表示_train_x的每一列所属的属性名
- * @param is_cut 表示是否进行剪枝
- * @param _method 表示选择的
+ * @param _dataset 编码后的训练数据集
+ * @param _rows 当前节点拥有的数据的行下标区间的起点，建树过程中会对该区间进行原地重排
+ * @param _row_count 当前节点拥有的数据的行数
+ * @param _attribute_index_list 当前节点可以使用的属性的列下标
+ * @param _histograms 当前节点在每一个属性上的直方图，与_attribute_index_list一一对应，为空时由当前节点统计
+ * @param _node_seed 当前节点随机选取候选属性的种子，子节点的种子由它与子节点的编号得到
+ * @param _depth 当前节点的深度，根节点为0
+ * @param _local_arena 当前任务分配节点使用的位置，提交到线程池的子树使用各自的位置
+ * @param Criterion 选择划分属性时使用的划分准则
  */
 template<class AttributeType, class ResultType>
-NodeBase *DecisionTree<AttributeType, ResultType>::_do_decision(std::map<std::string, std::vector<AttributeType>> &_train_x,
-                                                                std::vector<ResultType> &_train_y,
-                                                                std::vector<std::string> &_attribute_name_list,
-                                                                bool is_cut,std::string& cut_method, std::string& _decision_method) {
-    if(_attribute_name_list.empty()) {
+template<class Criterion>
+NodeBase *DecisionTree<AttributeType, ResultType>::_do_decision(const Dataset<AttributeType, ResultType> &_dataset,
+                                                                uint32_t *_rows, size_t _row_count,
+                                                                const std::vector<size_t> &_attribute_index_list,
+                                                                std::vector<Histogram> _histograms,
+                                                                uint64_t _node_seed, size_t _depth,
+                                                                NodeArena::Local &_local_arena) {
+    if(_attribute_index_list.empty()) {
         return nullptr;
     }
-    if (_attribute_name_list.size() == 1) {
+    const uint32_t* labels = _dataset.labels();
+    if (_attribute_index_list.size() == 1 && !_dataset.is_numeric(_attribute_index_list[0])) {
         // 如果当前节点只剩下一种选择，那么就必须强制停止
-        // 从所有可行解中找到众数，作为最终选择的答案
-        std::map<ResultType, int> answer_count;
-        for(ResultType& iter: _train_y) {
-            answer_count[iter] ++;
+        // 与 _is_leaf 中的判断保持一致
+        // 数值型的属性在划分后仍然可以继续使用，不受这一限制
+        return this->_majority_leaf(labels, _rows, _row_count, _local_arena);
+    }
+    // 如果当前节点能够停止，那么就将当前节点作为结果点进行返回
+    if (this->can_stop(labels, _rows, _row_count)) {
+        if(_row_count == 0) { // 如果当前结果为空
+            return this->_result_node(0, _local_arena);
+        } else {
+            return this->_result_node(labels[_rows[0]], _local_arena);
         }
-        int max_count = - 1;
-        ResultType select_res;
-        for(std::pair<ResultType, int> iter: answer_count) {
-            if (iter.second > max_count) {
-                select_res = iter.first;
-                max_count = iter.first;
+    }
+    // 预剪枝：深度、行数以及结果节点的预算(至少产生两个子节点)只取决于节点本身，在统计直方图之前判断
+    if (this->_pre_pruned(_row_count, _depth)
+        || (this->_max_leaves != 0 && this->_open_leaves + 1 > this->_max_leaves)) {
+        return this->_majority_leaf(labels, _rows, _row_count, _local_arena);
+    }
+    // 上方已经对终止条件进行了考虑，在此处我们只需要对树的递归创建方法进行考虑即可
+    // 较小的节点在当前线程中依次计算，避免任务调度的开销超过计算本身
+    ThreadPool* pool = _row_count >= this->_parallel_cutoff ? this->_thread_pool.get() : nullptr;
+    // 随机选取候选属性时只在候选属性上统计，统计的属性每个节点都不同，因此不保存直方图
+    const bool sampling = this->_max_features != 0 && this->_max_features < _attribute_index_list.size();
+    std::vector<size_t> candidates;
+    if (sampling) {
+        this->_sample_attributes(_attribute_index_list, _node_seed, candidates);
+    }
+    // 行数少于直方图的格子数时，统计的代价低于保存与相减，直接在每个线程复用的直方图上选择划分
+    if (!sampling && _histograms.empty() && _row_count >= this->_histogram_cells(_dataset, _attribute_index_list)) {
+        DESITIONTREE_STATS(TrainStatsCollector::Timer timer(this->_stats_collector, TrainStatsCollector::HISTOGRAM); this->_stats_collector.add_rows(_row_count);)
+        build_histograms(_dataset, _rows, _row_count, _attribute_index_list, _histograms, pool);
+    }
+    Split split;
+    if (_histograms.empty()) { // 统计与评分同时进行，计入统计直方图的阶段
+        DESITIONTREE_STATS(TrainStatsCollector::Timer timer(this->_stats_collector, TrainStatsCollector::HISTOGRAM); this->_stats_collector.add_rows(_row_count);)
+        split = find_split<Criterion>(_dataset, _rows, _row_count, sampling ? candidates : _attribute_index_list, pool,
+                                      this->_min_child_rows);
+    } else {
+        DESITIONTREE_STATS(TrainStatsCollector::Timer timer(this->_stats_collector, TrainStatsCollector::CRITERION);)
+        split = find_split<Criterion>(_dataset, _histograms, _attribute_index_list, pool, this->_min_child_rows);
+    }
+    size_t decision_attribute = split.attribute_index;
+    bool numeric = _dataset.is_numeric(decision_attribute);
+    if (split.degenerate) {
+        // 选出的数值型属性的所有行都在同一个分箱中，或者任何划分都有子节点少于最少行数，说明没有任何属性能够继续划分
+        return this->_majority_leaf(labels, _rows, _row_count, _local_arena);
+    }
+    if (this->_min_improvement > 0.0) {
+        std::vector<uint32_t> class_totals(this->_result_list.size(), 0);
+        if (_histograms.empty()) {
+            for(size_t i = 0; i < _row_count; ++ i) {
+                ++ class_totals[labels[_rows[i]]];
             }
+        } else {
+            for(size_t cls = 0; cls < class_totals.size(); ++ cls) {
+                class_totals[cls] = _histograms[0].class_total(cls);
+            }
+        }
+        if (!this->template _enough_improvement<Criterion>(class_totals.data(), class_totals.size(), split)) {
+            return this->_majority_leaf(labels, _rows, _row_count, _local_arena);
         }
-        return (NodeBase*)new ResultNode<ResultType>(select_res);
     }
-    // 如果当前节点能够停止，那么就将当前节点作为结果点进行返回
-    if (this->can_stop(_train_y)) {
-        if(_train_y.empty()) { // 如果当前结果为空
-            return (NodeBase*)new ResultNode<ResultType>(this->_result_list[0]);
+    if (!this->_reserve_leaves(numeric ? 2 : _dataset.cardinality(decision_attribute))) {
+        return this->_majority_leaf(labels, _rows, _row_count, _local_arena);
+    }
+    // 创建属性列表，普通的属性使用后不再出现在子树中，数值型的属性保留
+    std::vector<size_t> new_attribute_index_list;
+    for(size_t iter: _attribute_index_list){
+        if(numeric || iter != decision_attribute){
+            new_attribute_index_list.push_back(iter);
+        }
+    }
+    // 对当前区间进行原地划分，每一个子节点对应一个子区间，不需要复制任何数据
+    // 普通的属性每一种属性值对应一个子区间，数值型的属性按照阈值划分为左右两个子区间
+    std::vector<size_t> bucket_begin;
+    {
+        DESITIONTREE_STATS(TrainStatsCollector::Timer timer(this->_stats_collector, TrainStatsCollector::PARTITION);)
+        DESITIONTREE_STATS(this->_stats_collector.add_rows(_row_count);)
+        DESITIONTREE_STATS(this->_stats_collector.add_bytes(_row_count * sizeof(uint32_t));)
+        if (numeric) {
+            const uint8_t* bins = _dataset.bin_column(decision_attribute);
+            const uint32_t threshold = split.threshold;
+            uint32_t* middle = std::partition(_rows, _rows + _row_count,
+                                              [bins, threshold](uint32_t row) { return bins[row] <= threshold; });
+            bucket_begin = {0, (size_t)(middle - _rows), _row_count};
         } else {
-            return (NodeBase*)new ResultNode<ResultType>(_train_y[0]);
+            _partition(_dataset.column(decision_attribute), _dataset.cardinality(decision_attribute),
+                       _rows, _row_count, bucket_begin);
         }
     }
-    // 上方已经对终止条件进行了考虑，在此处我们只需要对树的递归创建方法进行考虑即可
-    std::string decision_attribute = DecisionTree<AttributeType, ResultType>::select_decision_attribute(
-                _train_x, _train_y, _attribute_name_list, _decision_method);
-
-    auto* res = new DecisionNode<AttributeType>(decision_attribute);
-    // 获取了作为根节点的属性
-    // 根据属性进行分别建树
-    // 创建属性列表
-    std::vector<std::string> new_attribute_name_list;
-    for(const std::string& iter: _attribute_name_list){
-        if(iter != decision_attribute){
-            new_attribute_name_list.push_back(iter);
+    // 父节点的直方图等于所有子节点的直方图之和：只对较小的子节点进行统计，最大的子节点由父节点的直方图减去其余子节点的直方图得到
+    // 最大的子节点不再继续划分，或者它的行数少于直方图的格子数时不进行相减，所有子节点各自进行统计
+    size_t child_count = bucket_begin.size() - 1;
+    size_t largest = 0;
+    for(size_t code = 1; code < child_count; ++ code) {
+        if (bucket_begin[code + 1] - bucket_begin[code] > bucket_begin[largest + 1] - bucket_begin[largest]) {
+            largest = code;
         }
     }
-    // 对属性进行选择，遍历每一种属性，将数据集对不同属性进行拆分
-    for(AttributeType& iter: this->_attribute_list[decision_attribute]) {
-        std::map<std::string, std::vector<AttributeType>> new_train_x;
-        std::vector<ResultType> new_train_y;
-        int index = 0;
-        // 遍历寻找数据集，一旦属性相同，就添加到new数据集中
-        for(int i = 0; i < _train_y.size(); ++i){
-            if(_train_x[decision_attribute][i] == iter) { // 检测到与当前检测的属性相同，进行添加操作
-                new_train_y.push_back(_train_y[i]);
-                for(std::string& _attribute: _attribute_name_list) { // 将每个属性的对应值进行添加
-                    if(_attribute != decision_attribute){
-                        new_train_x[_attribute].push_back(_train_x[_attribute][i]);
-                    }
+    size_t largest_row_count = bucket_begin[largest + 1] - bucket_begin[largest];
+    bool subtract = !_histograms.empty()
+            && largest_row_count >= this->_histogram_cells(_dataset, new_attribute_index_list)
+            && !this->_is_leaf(_dataset, _rows + bucket_begin[largest], largest_row_count, new_attribute_index_list,
+                               _depth + 1);
+    std::vector<std::vector<Histogram>> child_histograms(child_count);
+    for(size_t code = 0; code < child_count; ++ code) {
+        uint32_t* child_rows = _rows + bucket_begin[code];
+        size_t child_row_count = bucket_begin[code + 1] - bucket_begin[code];
+        if (subtract && code != largest && child_row_count > 0) {
+            DESITIONTREE_STATS(TrainStatsCollector::Timer timer(this->_stats_collector, TrainStatsCollector::HISTOGRAM); this->_stats_collector.add_rows(child_row_count);)
+            ThreadPool* child_pool = child_row_count >= this->_parallel_cutoff ? pool : nullptr;
+            build_histograms(_dataset, child_rows, child_row_count, new_attribute_index_list,
+                             child_histograms[code], child_pool);
+        }
+    }
+    if (subtract) {
+        DESITIONTREE_STATS(TrainStatsCollector::Timer timer(this->_stats_collector, TrainStatsCollector::HISTOGRAM);)
+        if (!numeric) { // 划分使用的属性不会出现在子节点中
+            for(size_t index = 0; index < _attribute_index_list.size(); ++ index) {
+                if (_attribute_index_list[index] == decision_attribute) {
+                    _histograms.erase(_histograms.begin() + index);
+                    break;
                 }
             }
         }
-        // 创建子树
-        res->insert_decision(iter, this->_do_decision(
-                new_train_x, new_train_y, new_attribute_name_list, is_cut, cut_method, _decision_method
-                ));
+        for(size_t code = 0; code < child_count; ++ code) {
+            if (code == largest || child_histograms[code].empty()) { // 没有数据的子节点不需要统计，也不需要减去
+                continue;
+            }
+            for(size_t index = 0; index < _histograms.size(); ++ index) {
+                _histograms[index].subtract(child_histograms[code][index]);
+            }
+        }
+        child_histograms[largest] = std::move(_histograms);
+    }
+    std::vector<Histogram>().swap(_histograms);
+    // 遍历每一个子区间，在相应的子区间上创建子树
+    // 子树之间不共享任何数据，足够大的子树作为任务提交到线程池中，由空闲的线程窃取执行，较小的子树直接在当前线程中创建
+    // 提交的子树使用自己的分配位置，节点在内存中与同一棵子树相邻，不会与其他线程的子树交错
+    std::vector<NodeBase*> children(child_count, nullptr);
+    ThreadPool::TaskGroup group(pool);
+    for(size_t code = 0; code < children.size(); ++ code) {
+        uint32_t* child_rows = _rows + bucket_begin[code];
+        size_t child_row_count = bucket_begin[code + 1] - bucket_begin[code];
+        auto build = [&, code, child_rows, child_row_count](NodeArena::Local& _child_arena) {
+            children[code] = this->template _do_decision<Criterion>(_dataset, child_rows, child_row_count,
+                                                                    new_attribute_index_list,
+                                                                    std::move(child_histograms[code]),
+                                                                    _mix_seed(_node_seed, code), _depth + 1,
+                                                                    _child_arena);
+        };
+        // 限制了结果节点的数量时按照顺序创建子树，先创建的子树优先使用预算
+        if (child_row_count >= this->_parallel_cutoff && this->_max_leaves == 0) {
+            group.run([this, build]() {
+                NodeArena::Local task_arena(this->_arena);
+                build(task_arena);
+            });
+        } else {
+            build(_local_arena);
+        }
+    }
+    group.wait();
+    if (numeric) {
+        return (NodeBase*)_local_arena.create<ThresholdNode<AttributeType>>(
+                decision_attribute, &this->_attribute_list[decision_attribute], split.threshold,
+                children[0], children[1]);
+    }
+    auto* res = this->_decision_node(decision_attribute, _local_arena);
+    for(size_t code = 0; code < children.size(); ++ code) {
+        res->set_child((uint32_t)code, children[code]);
     }
     return (NodeBase*)res;
 }
@@ -309,24 +1389,336 @@ std::string DecisionTree<AttributeType, ResultType>::select_decision_attribute(
     std::string res;
     if(_decision_method == "KILC") {
         res = KILC_method(_train_x, _train_y, _attribute_name_list);
+    } else if (_decision_method == GAIN_RATIO || _decision_method == GINI_INDEX) {
+        // 其余的方法只在编码后的数据集上实现，先对数据进行一次编码
+        Dataset<AttributeType, ResultType> dataset(_train_x, _train_y, _attribute_name_list);
+        std::vector<uint32_t> rows(dataset.row_count());
+        std::vector<size_t> attribute_index_list(dataset.attribute_count());
+        for(size_t row = 0; row < rows.size(); ++ row) {
+            rows[row] = (uint32_t)row;
+        }
+        for(size_t index = 0; index < attribute_index_list.size(); ++ index) {
+            attribute_index_list[index] = index;
+        }
+        if (!attribute_index_list.empty()) {
+            res = dataset.attribute_name(this->select_decision_attribute(
+                    dataset, rows.data(), rows.size(), attribute_index_list, _decision_method));
+        }
+    }
+    return res;
+}
+
+/**
+ * 在编码后的数据集上选择最适合的属性，并且返回相应的列下标
+ * @param _dataset 编码后的训练数据集
+ * @param _rows 当前节点拥有的数据的行下标
+ * @param _row_count 当前节点拥有的数据的行数
+ * @param _attribute_index_list 当前节点可以使用的属性的列下标
+ * @param _decision_method 进行选择的方法，可以选择 信息增益(KILC)、增益率(GAIN_RATIO)、基尼系数(GINI_INDEX)
+ * @return 返回选择的属性的列下标
+ */
+template<class AttributeType, class ResultType>
+size_t DecisionTree<AttributeType, ResultType>::select_decision_attribute(
+        const Dataset<AttributeType, ResultType> &_dataset, const uint32_t *_rows, size_t _row_count,
+        const std::vector<size_t> &_attribute_index_list, const std::string &_decision_method) {
+    // 分发器，根据_decision_method选择适配的方法即可
+    size_t res = _attribute_index_list[0];
+    if(_decision_method == InformationGain::name()) {
+        res = this->template _find_split<InformationGain>(_dataset, _rows, _row_count, _attribute_index_list).attribute_index;
+    } else if (_decision_method == GainRatio::name()) {
+        res = this->template _find_split<GainRatio>(_dataset, _rows, _row_count, _attribute_index_list).attribute_index;
+    } else if (_decision_method == GiniIndex::name()) {
+        res = this->template _find_split<GiniIndex>(_dataset, _rows, _row_count, _attribute_index_list).attribute_index;
     }
     return res;
 }
 
+/**
+ * 使用给定的划分准则在编码后的数据集上选择划分
+ * 较小的节点在当前线程中依次计算，避免任务调度的开销超过计算本身
+ * @param Criterion 划分准则
+ * @param _dataset 编码后的训练数据集
+ * @param _rows 当前节点拥有的数据的行下标
+ * @param _row_count 当前节点拥有的数据的行数
+ * @param _attribute_index_list 当前节点可以使用的属性的列下标
+ * @return 返回选择的划分
+ */
+template<class AttributeType, class ResultType>
+template<class Criterion>
+Split DecisionTree<AttributeType, ResultType>::_find_split(
+        const Dataset<AttributeType, ResultType> &_dataset, const uint32_t *_rows, size_t _row_count,
+        const std::vector<size_t> &_attribute_index_list) const {
+    ThreadPool* pool = _row_count >= this->_parallel_cutoff ? this->_thread_pool.get() : nullptr;
+    return find_split<Criterion>(_dataset, _rows, _row_count, _attribute_index_list, pool);
+}
+
+/**
+ * 判断一个节点是否会直接成为结果节点(或空节点)，这样的节点不需要统计直方图
+ * 与 _do_decision 开头的终止条件保持一致
+ * @param _dataset 编码后的训练数据集
+ * @param _rows 节点拥有的数据的行下标
+ * @param _row_count 节点拥有的数据的行数
+ * @param _attribute_index_list 节点可以使用的属性的列下标
+ * @param _depth 节点的深度
+ * @return 不会继续划分时返回true
+ */
+template<class AttributeType, class ResultType>
+bool DecisionTree<AttributeType, ResultType>::_is_leaf(const Dataset<AttributeType, ResultType> &_dataset,
+                                                       const uint32_t *_rows, size_t _row_count,
+                                                       const std::vector<size_t> &_attribute_index_list,
+                                                       size_t _depth) {
+    if (_attribute_index_list.empty()) {
+        return true;
+    }
+    if (_attribute_index_list.size() == 1 && !_dataset.is_numeric(_attribute_index_list[0])) {
+        return true;
+    }
+    return this->can_stop(_dataset.labels(), _rows, _row_count) || this->_pre_pruned(_row_count, _depth);
+}
+
+/**
+ * 判断一个节点是否被预剪枝的条件限制为结果节点，只需要行数与深度，在统计任何直方图之前进行
+ * 少于两倍 _min_child_rows 的节点无论如何划分都会有子节点少于最少行数
+ * @param _row_count 节点拥有的数据的行数
+ * @param _depth 节点的深度
+ * @return 不允许继续划分时返回true
+ */
+template<class AttributeType, class ResultType>
+bool DecisionTree<AttributeType, ResultType>::_pre_pruned(size_t _row_count, size_t _depth) const {
+    if (this->_max_depth != 0 && _depth >= this->_max_depth) {
+        return true;
+    }
+    return _row_count < this->_min_split_rows || _row_count < 2 * this->_min_child_rows;
+}
+
+/**
+ * 判断选出的划分是否带来了足够的改进，改进为不划分的评分减去划分的评分
+ * 不划分的评分为只有一种属性值的直方图的评分，信息增益的改进即信息增益，基尼指数的改进即基尼指数的减少量，增益率的改进即增益率
+ * @param Criterion 划分准则
+ * @param _class_totals 节点上每一种结果的数量
+ * @param _class_count 结果的数量
+ * @param _split 选出的划分
+ * @return 改进不少于 _min_improvement 时返回true
+ */
+template<class AttributeType, class ResultType>
+template<class Criterion>
+bool DecisionTree<AttributeType, ResultType>::_enough_improvement(const uint32_t *_class_totals, size_t _class_count,
+                                                                  const Split &_split) const {
+    Histogram unsplit(1, _class_count);
+    unsplit.add(0, _class_totals);
+    return Criterion::score(unsplit) - _split.score >= this->_min_improvement;
+}
+
+/**
+ * 为一次划分预留结果节点：划分把一个结果节点替换为_child_count个，限制了结果节点的数量时检查是否超过上限
+ * 没有数据的子节点同样会成为结果节点，因此普通的属性按照字典的大小计数
+ * @param _child_count 划分产生的子节点的数量
+ * @return 可以划分时返回true，并且计入预留的结果节点
+ */
+template<class AttributeType, class ResultType>
+bool DecisionTree<AttributeType, ResultType>::_reserve_leaves(size_t _child_count) {
+    if (this->_max_leaves == 0) {
+        return true;
+    }
+    if (this->_open_leaves + _child_count - 1 > this->_max_leaves) {
+        return false;
+    }
+    this->_open_leaves += _child_count - 1;
+    return true;
+}
+
+/**
+ * 计算一个节点在所有属性上的直方图的格子总数，即相减一次的代价
+ * @param _dataset 编码后的训练数据集
+ * @param _attribute_index_list 节点可以使用的属性的列下标
+ * @return 格子总数
+ */
+template<class AttributeType, class ResultType>
+template<class DatasetType>
+size_t DecisionTree<AttributeType, ResultType>::_histogram_cells(const DatasetType &_dataset,
+                                                                 const std::vector<size_t> &_attribute_index_list) {
+    size_t cells = 0;
+    for(size_t attribute_index: _attribute_index_list) {
+        cells += _dataset.cardinality(attribute_index) * _dataset.class_count();
+    }
+    return cells;
+}
+
+/**
+ * 创建一个结果节点，结果为当前节点拥有的数据中出现次数最多的结果，数量相同时选择编码较小的结果
+ * @param _labels 结果的编码数组
+ * @param _rows 当前节点拥有的数据的行下标
+ * @param _row_count 当前节点拥有的数据的行数
+ * @param _local_arena 分配节点使用的位置
+ * @return 新创建的结果节点
+ */
+template<class AttributeType, class ResultType>
+NodeBase *DecisionTree<AttributeType, ResultType>::_majority_leaf(const uint32_t *_labels, const uint32_t *_rows,
+                                                                  size_t _row_count, NodeArena::Local &_local_arena) {
+    std::vector<size_t> answer_count(this->_result_list.size(), 0);
+    for(size_t i = 0; i < _row_count; ++ i) {
+        answer_count[_labels[_rows[i]]] ++;
+    }
+    size_t select_res = 0;
+    for(size_t code = 1; code < answer_count.size(); ++ code) {
+        if (answer_count[code] > answer_count[select_res]) {
+            select_res = code;
+        }
+    }
+    return this->_result_node((uint32_t)select_res, _local_arena);
+}
+
+/**
+ * 在内存池中创建一个结果节点，节点只记录结果的编码，通过指针引用决策树持有的结果字典
+ * @param _result_code 结果的编码
+ * @param _local_arena 分配节点使用的位置
+ * @return 新创建的结果节点
+ */
+template<class AttributeType, class ResultType>
+NodeBase *DecisionTree<AttributeType, ResultType>::_result_node(uint32_t _result_code, NodeArena::Local &_local_arena) {
+    return (NodeBase*)_local_arena.create<ResultNode<ResultType>>(&this->_result_list, _result_code);
+}
+
+/**
+ * 在内存池中创建一个决策节点，子节点表的长度为该列的字典大小，所有子节点初始为空指针
+ * 节点与子节点表都由内存池分配，节点通过指针引用决策树持有的字典
+ * @param _attribute_index 决策的列下标
+ * @param _local_arena 分配节点使用的位置
+ * @return 新创建的决策节点
+ */
+template<class AttributeType, class ResultType>
+DecisionNode<AttributeType> *DecisionTree<AttributeType, ResultType>::_decision_node(size_t _attribute_index,
+                                                                                     NodeArena::Local &_local_arena) {
+    const Vocabulary<AttributeType>& vocabulary = this->_attribute_list[_attribute_index];
+    NodeBase** children = _local_arena.create_array<NodeBase*>(vocabulary.size(), nullptr);
+    return _local_arena.create<DecisionNode<AttributeType>>(_attribute_index, &vocabulary, children);
+}
+
+/**
+ * 训练结束后整理统计结果，没有开启统计时清空统计结果
+ * 节点的数量与深度通过遍历训练得到的树得到，只在开启统计时进行
+ */
+template<class AttributeType, class ResultType>
+void DecisionTree<AttributeType, ResultType>::_finish_stats() {
+    this->_stats = TrainStats();
+#ifdef DESITIONTREE_ENABLE_STATS
+    this->_stats_collector.collect(this->_stats);
+    std::vector<std::pair<NodeBase*, size_t>> stack; // (节点, 深度)
+    if (this->_root != nullptr) {
+        stack.emplace_back(this->_root, 0);
+    }
+    while (!stack.empty()) {
+        NodeBase* node = stack.back().first;
+        size_t depth = stack.back().second;
+        stack.pop_back();
+        ++ this->_stats.node_count;
+        if (node->is_result()) {
+            ++ this->_stats.leaf_count;
+            this->_stats.max_depth = std::max(this->_stats.max_depth, depth);
+        } else if (node->is_threshold()) {
+            auto* threshold_node = (ThresholdNode<AttributeType>*)node;
+            stack.emplace_back(threshold_node->get_left(), depth + 1);
+            stack.emplace_back(threshold_node->get_right(), depth + 1);
+        } else {
+            auto* decision_node = (DecisionNode<AttributeType>*)node;
+            for(uint32_t code = 0; code < decision_node->child_count(); ++ code) {
+                if (decision_node->get_child(code) != nullptr) {
+                    stack.emplace_back(decision_node->get_child(code), depth + 1);
+                }
+            }
+        }
+    }
+    this->_stats.tree_bytes = this->_arena.capacity();
+#endif
+}
+
+/**
+ * 从当前节点可以使用的属性中随机选取_max_features个候选属性，候选属性保持原来的顺序
+ * 评分相同时仍然选择靠前的属性，与不选取候选属性时的规则一致
+ * @param _attribute_index_list 当前节点可以使用的属性的列下标
+ * @param _node_seed 当前节点的种子
+ * @param _candidates 选取的候选属性
+ */
+template<class AttributeType, class ResultType>
+void DecisionTree<AttributeType, ResultType>::_sample_attributes(const std::vector<size_t> &_attribute_index_list,
+                                                                 uint64_t _node_seed,
+                                                                 std::vector<size_t> &_candidates) const {
+    std::vector<size_t> positions(_attribute_index_list.size());
+    for(size_t index = 0; index < positions.size(); ++ index) {
+        positions[index] = index;
+    }
+    // 只打乱前_max_features个位置
+    std::mt19937_64 random(_node_seed);
+    for(size_t index = 0; index < this->_max_features; ++ index) {
+        std::uniform_int_distribution<size_t> pick(index, positions.size() - 1);
+        std::swap(positions[index], positions[pick(random)]);
+    }
+    positions.resize(this->_max_features);
+    std::sort(positions.begin(), positions.end());
+    _candidates.clear();
+    for(size_t position: positions) {
+        _candidates.push_back(_attribute_index_list[position]);
+    }
+}
+
+template<class AttributeType, class ResultType>
+uint64_t DecisionTree<AttributeType, ResultType>::_mix_seed(uint64_t _seed, uint64_t _index) {
+    uint64_t z = _seed + (_index + 1) * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
 /**
  * 判断当前的数据集能否结束
- * @param _train_y 用于判断的数据集结果
+ * @param _labels 结果的编码数组
+ * @param _rows 当前节点拥有的数据的行下标
+ * @param _row_count 当前节点拥有的数据的行数
  * @return 返回一个布尔值，表示是否能够结束分割
  */
 template<class AttributeType, class ResultType>
-bool DecisionTree<AttributeType, ResultType>::can_stop(std::vector<ResultType> &_train_y) {
-    if(_train_y.empty()) return true;
-    for(int i = 1 ; i < _train_y.size(); ++ i) {
-        if (_train_y[i] != _train_y[i - 1]) {
+bool DecisionTree<AttributeType, ResultType>::can_stop(const uint32_t* _labels, const uint32_t* _rows, size_t _row_count) {
+    if(_row_count == 0) return true;
+    for(size_t i = 1 ; i < _row_count; ++ i) {
+        if (_labels[_rows[i]] != _labels[_rows[i - 1]]) {
             return false;
         }
     }
     return true;
 }
 
+/**
+ * 按照某一列的编码对行下标进行原地划分，划分后编码为code的行位于[_bucket_begin[code], _bucket_begin[code + 1])中
+ * 先统计每个编码的数量得到每个区间的位置，再像快速排序一样通过交换把每一行放入所属的区间，不需要额外的缓冲区
+ * @param _column 用于划分的列的编码数组
+ * @param _cardinality 该列的字典大小
+ * @param _rows 需要划分的行下标，会被原地重排
+ * @param _row_count 需要划分的行数
+ * @param _bucket_begin 输出每个编码对应的区间的起点，长度为_cardinality + 1
+ */
+template<class AttributeType, class ResultType>
+void DecisionTree<AttributeType, ResultType>::_partition(const uint32_t *_column, size_t _cardinality, uint32_t *_rows,
+                                                         size_t _row_count, std::vector<size_t> &_bucket_begin) {
+    _bucket_begin.assign(_cardinality + 1, 0);
+    for(size_t i = 0; i < _row_count; ++ i) {
+        _bucket_begin[_column[_rows[i]] + 1] ++;
+    }
+    for(size_t code = 0; code < _cardinality; ++ code) {
+        _bucket_begin[code + 1] += _bucket_begin[code];
+    }
+    // next[code] 表示编码为code的区间中下一个待确定的位置
+    std::vector<size_t> next(_bucket_begin.begin(), _bucket_begin.end() - 1);
+    for(size_t code = 0; code < _cardinality; ++ code) {
+        while (next[code] < _bucket_begin[code + 1]) {
+            uint32_t target = _column[_rows[next[code]]];
+            if (target == code) {
+                ++ next[code];
+            } else {
+                std::swap(_rows[next[code]], _rows[next[target]]);
+                ++ next[target];
+            }
+        }
+    }
+}
+
 #endif //DESITIONTREE_DECISION_TREE_H
@@ -0,0 +1,854 @@
+//
+// Created by wangsy on 2026/10/18.
+//
+
+#ifndef DESITIONTREE_GRADIENT_BOOSTING_H
+#define DESITIONTREE_GRADIENT_BOOSTING_H
+
+#include "compiled_tree.h"
+#include "dataset.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <unistd.h>
+
+/**
+ * 梯度提升的损失函数，与划分准则一样是在编译期传入的策略类型，每一种损失函数都必须提供：
+ * <ul>
+ *  <li>static double base_score(const std::vector<double>&) 所有树之前的初始预测值</li>
+ *  <li>static void gradient(double y, double score, double& g, double& h) 一阶与二阶导数</li>
+ *  <li>static double transform(double score) 将累加的预测值转换为最终的预测</li>
+ *  <li>static void check(double y) 检查目标值是否合法，不合法时抛出std::invalid_argument</li>
+ *  <li>static const char* name() 损失函数的名称</li>
+ * </ul>
+ */
+
+/**
+ * 平方误差，用于回归，L = (score - y)^2 / 2
+ */
+struct SquaredError {
+    static double base_score(const std::vector<double>& _targets) {
+        double sum = 0.0;
+        for(double target: _targets) {
+            sum += target;
+        }
+        return _targets.empty() ? 0.0 : sum / _targets.size();
+    }
+
+    static void gradient(double _target, double _score, double& _gradient, double& _hessian) {
+        _gradient = _score - _target;
+        _hessian = 1.0;
+    }
+
+    static double transform(double _score) {
+        return _score;
+    }
+
+    static void check(double) {
+    }
+
+    static const char* name() {
+        return "SQUARED_ERROR";
+    }
+};
+
+/**
+ * 对数损失，用于二分类，目标值必须为0或1，预测值为正类的概率
+ */
+struct LogisticLoss {
+    static double base_score(const std::vector<double>& _targets) {
+        double positive = 0.0;
+        for(double target: _targets) {
+            positive += target;
+        }
+        double p = _targets.empty() ? 0.5 : positive / _targets.size();
+        p = std::min(std::max(p, 1e-6), 1.0 - 1e-6);
+        return std::log(p / (1.0 - p));
+    }
+
+    static void gradient(double _target, double _score, double& _gradient, double& _hessian) {
+        double p = transform(_score);
+        _gradient = p - _target;
+        _hessian = std::max(p * (1.0 - p), 1e-16);
+    }
+
+    static double transform(double _score) {
+        return 1.0 / (1.0 + std::exp(-_score));
+    }
+
+    static void check(double _target) {
+        if (_target != 0.0 && _target != 1.0) {
+            throw std::invalid_argument("LogisticLoss: targets must be 0 or 1");
+        }
+    }
+
+    static const char* name() {
+        return "LOGISTIC";
+    }
+};
+
+/**
+ * 梯度提升树的节点，所有树的节点连续存放在同一个数组中，每个节点16字节，一个缓存行可以放下4个节点
+ * 两个子节点相邻存放，右子节点为 left + 1
+ */
+struct BoostedNode {
+    static const uint32_t CATEGORICAL = 0x80000000u; // feature 的最高位，标记按照 code == threshold 划分的普通属性
+
+    uint32_t feature; // 决策的列下标，普通的列带有 CATEGORICAL 标记，结果节点为 CompiledTree::npos
+    uint32_t threshold; // 数值型的列为分箱编码的阈值，不大于阈值时选择左子节点；普通的列等于该编码时选择左子节点
+    uint32_t left; // 左子节点的下标
+    float value; // 结果节点的值，已经乘以学习率
+};
+
+namespace _gradient_boosting_self_use {
+
+    /**
+     * 梯度直方图的一个格子，记录某一种属性值(或分箱)下所有行的梯度之和、二阶导数之和以及行数
+     */
+    struct GradientBin {
+        double gradient;
+        double hessian;
+        uint32_t count;
+    };
+
+    /**
+     * 选出的二分划分
+     */
+    struct BoostSplit {
+        size_t attribute_index; // 划分属性的列下标
+        uint32_t threshold; // 阈值(数值型)或者分到左侧的编码(普通属性)
+        double gain; // 划分带来的损失下降
+        double left_gradient; // 左子节点的梯度之和
+        double left_hessian; // 左子节点的二阶导数之和
+        bool valid; // 是否存在满足条件的划分
+    };
+}
+
+/**
+ * 基于直方图的梯度提升树，每一轮在编码后的数据集上按照当前的梯度生长一棵较浅的二叉回归树
+ *
+ * <p>每一棵树的生长方式</p>
+ * <ul>
+ *  <li>对每个节点统计每一个属性在每一种取值(数值型的列为分箱)上的梯度之和与二阶导数之和，较大的子节点由父节点减去较小的子节点得到</li>
+ *  <li>数值型的列在分箱上寻找最优的阈值，普通的列尝试将每一种取值单独分到左侧，增益为 GL^2/(HL+λ) + GR^2/(HR+λ) - G^2/(H+λ)</li>
+ *  <li>达到最大深度、行数不足或者没有正的增益时成为结果节点，值为 -G/(H+λ) 乘以学习率，
+ *  并且直接累加到该节点中每一行的预测值上，不需要重新预测训练数据</li>
+ * </ul>
+ * 预测时缺失的属性值以及训练时没有出现过的属性值一律走右子节点，因此总能给出预测
+ * 训练的结果与线程数无关
+ * @param AttributeType 属性值的类型
+ * @param ResultType 目标值的类型，必须是算术类型
+ * @param Loss 损失函数，见 SquaredError 与 LogisticLoss
+ */
+template<class AttributeType, class ResultType, class Loss = SquaredError>
+class GradientBoosting {
+    static_assert(std::is_arithmetic<ResultType>::value, "GradientBoosting: targets must be arithmetic");
+
+private:
+    typedef _gradient_boosting_self_use::GradientBin GradientBin;
+    typedef _gradient_boosting_self_use::BoostSplit BoostSplit;
+    typedef std::vector<std::vector<GradientBin>> GradientHistograms; // 每一个属性的梯度直方图，下标为列下标
+
+    std::vector<BoostedNode> _nodes; // 所有树的节点
+    std::vector<uint32_t> _roots; // 每一棵树的根节点的下标
+    double _base_score; // 初始预测值
+    std::vector<std::string> _attribute_names; // 每一列的属性名，下标为列下标
+    std::vector<Vocabulary<AttributeType>> _attribute_list; // 每一列的字典
+    std::vector<bool> _numeric_list; // 标记每一列是否为数值型
+    std::shared_ptr<ThreadPool> _thread_pool; // 训练与批量预测时使用的线程池，为空时在当前线程中进行
+    size_t _tree_count; // 树的数量
+    double _learning_rate; // 学习率
+    size_t _max_depth; // 每一棵树的最大深度
+    size_t _min_child_rows; // 每个结果节点至少拥有的行数
+    double _lambda; // 结果节点的值的L2正则化系数
+    size_t _parallel_cutoff; // 行数不少于该值的节点才会并行地统计各个属性的直方图
+
+    /**
+     * 统计一个节点在每一个属性上的梯度直方图
+     * @param _dataset 编码后的训练数据集
+     * @param _rows 节点拥有的数据的行下标
+     * @param _row_count 节点拥有的数据的行数
+     * @param _gradients 每一行的梯度
+     * @param _hessians 每一行的二阶导数
+     * @param _histograms 输出的直方图
+     */
+    void _build_histograms(const Dataset<AttributeType, ResultType>& _dataset, const uint32_t* _rows, size_t _row_count,
+                           const std::vector<double>& _gradients, const std::vector<double>& _hessians,
+                           GradientHistograms& _histograms) const;
+
+    /**
+     * 在梯度直方图上选出增益最大的二分划分
+     * @param _dataset 编码后的训练数据集
+     * @param _histograms 节点的梯度直方图
+     * @param _gradient 节点的梯度之和
+     * @param _hessian 节点的二阶导数之和
+     * @param _row_count 节点的行数
+     * @return 选出的划分，增益相同时选择列下标以及阈值较小的划分
+     */
+    BoostSplit _find_split(const Dataset<AttributeType, ResultType>& _dataset, const GradientHistograms& _histograms,
+                           double _gradient, double _hessian, size_t _row_count) const;
+
+    /**
+     * 生长以某一节点为根的子树
+     * @param _dataset 编码后的训练数据集
+     * @param _node 节点的下标，节点已经在数组中分配
+     * @param _rows 节点拥有的数据的行下标区间的起点，会被原地重排
+     * @param _row_count 节点拥有的数据的行数
+     * @param _depth 节点的深度
+     * @param _histograms 节点的梯度直方图，为空时由节点自己统计
+     * @param _gradient 节点的梯度之和
+     * @param _hessian 节点的二阶导数之和
+     * @param _gradients 每一行的梯度
+     * @param _hessians 每一行的二阶导数
+     * @param _scores 每一行当前的预测值，结果节点会把自己的值累加到所拥有的行上
+     */
+    void _grow(const Dataset<AttributeType, ResultType>& _dataset, uint32_t _node, uint32_t* _rows, size_t _row_count,
+               size_t _depth, GradientHistograms _histograms, double _gradient, double _hessian,
+               const std::vector<double>& _gradients, const std::vector<double>& _hessians,
+               std::vector<double>& _scores);
+
+    /**
+     * 从某一棵树的根节点开始对一行数据进行预测
+     * @param _root 根节点的下标
+     * @param _columns 按照列下标排列的列指针
+     * @param _row 行下标
+     * @return 结果节点的值
+     */
+    float _predict_tree(uint32_t _root, const uint32_t* const* _columns, size_t _row) const;
+
+    /**
+     * 根据二级缓存的大小选择批量预测时每一组的行数
+     * @return 每一组的行数
+     */
+    size_t _auto_block_rows() const;
+
+public:
+    /**
+     * 构造函数，默认训练100棵深度为3的树，学习率为0.1
+     */
+    GradientBoosting();
+
+    void set_tree_count(size_t _tree_count);
+
+    void set_learning_rate(double _learning_rate);
+
+    void set_max_depth(size_t _max_depth);
+
+    /**
+     * 设置每个结果节点至少拥有的行数，划分后任何一侧少于该值的划分都不会被选择
+     * @param _min_child_rows 行数
+     */
+    void set_min_child_rows(size_t _min_child_rows);
+
+    /**
+     * 设置结果节点的值的L2正则化系数λ
+     * @param _lambda 正则化系数，必须为正数
+     */
+    void set_l2_regularization(double _lambda);
+
+    /**
+     * 设置训练与批量预测时使用的线程数
+     * @param _thread_count 参与的线程总数，为1时在当前线程中进行，为0时使用硬件支持的线程数
+     */
+    void set_thread_count(size_t _thread_count);
+
+    /**
+     * 清空所有的树
+     */
+    void clear();
+
+    /**
+     * 对模型进行训练，_numeric_attribute_names 中给出的列按照分位数进行分箱
+     * @param _train_x 一个map<string, vector<AttributeType>>，表示训练数据集
+     * @param _train_y 一个一维数组，表示_train_x的每一行的目标值
+     * @param _attribute_name_list 一个一维数组，表示_train_x的每一列所属的属性名
+     * @param _numeric_attribute_names 数值型的列的属性名
+     */
+    void fit(const std::map<std::string, std::vector<AttributeType>>& _train_x, const std::vector<ResultType>& _train_y,
+             const std::vector<std::string>& _attribute_name_list,
+             const std::set<std::string>& _numeric_attribute_names = std::set<std::string>());
+
+    /**
+     * 在编码后的数据集上对模型进行训练，会清空之前训练得到的所有树，目标值为结果字典中的原始值
+     * @param _dataset 编码后的训练数据集
+     */
+    void fit(const Dataset<AttributeType, ResultType>& _dataset);
+
+    /**
+     * 获取树的数量
+     * @return 树的数量
+     */
+    size_t size() const;
+
+    /**
+     * 获取所有树的节点数之和
+     * @return 节点数
+     */
+    size_t node_count() const;
+
+    /**
+     * 获取所有树的节点数组
+     * @return 节点数组的起点，长度为 node_count()
+     */
+    const BoostedNode* nodes() const;
+
+    /**
+     * 获取某一棵树的根节点的下标
+     * @param _index 树的编号
+     * @return 根节点在节点数组中的下标
+     */
+    uint32_t root(size_t _index) const;
+
+    /**
+     * 获取所有树之前的初始预测值
+     * @return 初始预测值
+     */
+    double base_score() const;
+
+    /**
+     * 使用训练时的字典对一行数据进行编码，编码后的数据按照列下标排列
+     * @param _test_x 用于预测的数据，一个map，从string映射到AttributeType
+     * @param _codes 编码的结果，缺失的属性以及训练时没有出现过的属性值编码为 CompiledTree::npos
+     */
+    void encode(const std::map<std::string, AttributeType>& _test_x, std::vector<uint32_t>& _codes) const;
+
+    /**
+     * 使用训练时的字典对某一列的一个值进行编码，数值型的列编码为所在分箱的编码
+     * @param _attribute_index 属性的列下标
+     * @param _value 属性值
+     * @return 属性值的编码，训练时没有出现过的属性值为 CompiledTree::npos
+     */
+    uint32_t encode(size_t _attribute_index, const AttributeType& _value) const;
+
+    /**
+     * 对编码后的一行数据计算所有树的累加值(未经过损失函数的转换)
+     * @param _row 按照列下标排列的属性值编码
+     * @return 初始预测值与所有树的结果之和
+     */
+    double predict_raw(const uint32_t* _row) const;
+
+    /**
+     * 对编码后的一行数据进行预测
+     * @param _row 按照列下标排列的属性值编码
+     * @return 预测值，平方误差为回归值，对数损失为正类的概率
+     */
+    double predict(const uint32_t* _row) const;
+
+    /**
+     * 对编码后的一批数据进行预测，数据按列存放，按照树的顺序逐组处理，各组在线程池中并行预测
+     * @param _columns 按照列下标排列的列指针，_columns[feature][row] 为第row行在该列上的属性值编码
+     * @param _row_count 数据的行数
+     * @param _results 调用者提供的长度为_row_count的数组，写入每一行的预测值，与 predict 相同
+     */
+    void predict(const uint32_t* const* _columns, size_t _row_count, double* _results) const;
+
+    /**
+     * 给出数据，使用当前的模型进行预测
+     * @param _test_x 用于预测的数据
+     * @param _test_y 预测值，直接追加到_test_y的末尾
+     */
+    void transform(const std::map<std::string, AttributeType>& _test_x, std::vector<double>& _test_y) const;
+};
+
+/**
+ * 构造函数，默认训练100棵深度为3的树，学习率为0.1
+ */
+template<class AttributeType, class ResultType, class Loss>
+GradientBoosting<AttributeType, ResultType, Loss>::GradientBoosting() {
+    this->_base_score = 0.0;
+    this->_tree_count = 100;
+    this->_learning_rate = 0.1;
+    this->_max_depth = 3;
+    this->_min_child_rows = 20;
+    this->_lambda = 1.0;
+    this->_parallel_cutoff = 4096;
+}
+
+template<class AttributeType, class ResultType, class Loss>
+void GradientBoosting<AttributeType, ResultType, Loss>::set_tree_count(size_t _tree_count) {
+    this->_tree_count = _tree_count;
+}
+
+template<class AttributeType, class ResultType, class Loss>
+void GradientBoosting<AttributeType, ResultType, Loss>::set_learning_rate(double _learning_rate) {
+    this->_learning_rate = _learning_rate;
+}
+
+template<class AttributeType, class ResultType, class Loss>
+void GradientBoosting<AttributeType, ResultType, Loss>::set_max_depth(size_t _max_depth) {
+    this->_max_depth = _max_depth;
+}
+
+template<class AttributeType, class ResultType, class Loss>
+void GradientBoosting<AttributeType, ResultType, Loss>::set_min_child_rows(size_t _min_child_rows) {
+    this->_min_child_rows = std::max<size_t>(1, _min_child_rows);
+}
+
+template<class AttributeType, class ResultType, class Loss>
+void GradientBoosting<AttributeType, ResultType, Loss>::set_l2_regularization(double _lambda) {
+    if (!(_lambda > 0.0)) {
+        throw std::invalid_argument("GradientBoosting: lambda must be positive");
+    }
+    this->_lambda = _lambda;
+}
+
+template<class AttributeType, class ResultType, class Loss>
+void GradientBoosting<AttributeType, ResultType, Loss>::set_thread_count(size_t _thread_count) {
+    if (_thread_count == 1) {
+        this->_thread_pool.reset();
+    } else {
+        this->_thread_pool = std::make_shared<ThreadPool>(_thread_count);
+    }
+}
+
+template<class AttributeType, class ResultType, class Loss>
+void GradientBoosting<AttributeType, ResultType, Loss>::clear() {
+    this->_nodes.clear();
+    this->_roots.clear();
+    this->_base_score = 0.0;
+}
+
+/**
+ * 对模型进行训练，_numeric_attribute_names 中给出的列按照分位数进行分箱
+ * @param _train_x 一个map<string, vector<AttributeType>>，表示训练数据集
+ * @param _train_y 一个一维数组，表示_train_x的每一行的目标值
+ * @param _attribute_name_list 一个一维数组，表示_train_x的每一列所属的属性名
+ * @param _numeric_attribute_names 数值型的列的属性名
+ */
+template<class AttributeType, class ResultType, class Loss>
+void GradientBoosting<AttributeType, ResultType, Loss>::fit(
+        const std::map<std::string, std::vector<AttributeType>> &_train_x, const std::vector<ResultType> &_train_y,
+        const std::vector<std::string> &_attribute_name_list, const std::set<std::string> &_numeric_attribute_names) {
+    Dataset<AttributeType, ResultType> dataset(_train_x, _train_y, _attribute_name_list, _numeric_attribute_names,
+                                               this->_thread_pool.get());
+    this->fit(dataset);
+}
+
+/**
+ * 在编码后的数据集上对模型进行训练，会清空之前训练得到的所有树，目标值为结果字典中的原始值
+ * 每一轮先根据当前的预测值计算每一行的梯度，再生长一棵树；整个训练过程共用一个行下标数组
+ * @param _dataset 编码后的训练数据集
+ */
+template<class AttributeType, class ResultType, class Loss>
+void GradientBoosting<AttributeType, ResultType, Loss>::fit(const Dataset<AttributeType, ResultType> &_dataset) {
+    this->clear();
+    this->_attribute_names.clear();
+    this->_attribute_list.clear();
+    this->_numeric_list.clear();
+    for(size_t index = 0; index < _dataset.attribute_count(); ++ index) {
+        if (!_dataset.is_numeric(index) && index >= BoostedNode::CATEGORICAL) {
+            throw std::invalid_argument("GradientBoosting: too many attributes");
+        }
+        this->_attribute_names.push_back(_dataset.attribute_name(index));
+        this->_attribute_list.push_back(_dataset.vocabulary(index));
+        this->_numeric_list.push_back(_dataset.is_numeric(index));
+    }
+    const size_t row_count = _dataset.row_count();
+    std::vector<double> targets(row_count);
+    for(size_t row = 0; row < row_count; ++ row) {
+        targets[row] = (double)_dataset.result_vocabulary().value(_dataset.labels()[row]);
+        Loss::check(targets[row]);
+    }
+    this->_base_score = Loss::base_score(targets);
+    if (row_count == 0) {
+        return;
+    }
+    std::vector<double> scores(row_count, this->_base_score);
+    std::vector<double> gradients(row_count), hessians(row_count);
+    std::vector<uint32_t> rows(row_count);
+    const size_t chunk = 16384;
+    const size_t chunk_count = (row_count + chunk - 1) / chunk;
+    auto compute_gradients = [&](size_t _chunk) {
+        for(size_t row = _chunk * chunk; row < std::min(row_count, (_chunk + 1) * chunk); ++ row) {
+            Loss::gradient(targets[row], scores[row], gradients[row], hessians[row]);
+        }
+    };
+    for(size_t tree = 0; tree < this->_tree_count; ++ tree) {
+        if (this->_thread_pool && chunk_count > 1) {
+            this->_thread_pool->parallel_for(0, chunk_count, compute_gradients);
+        } else {
+            for(size_t index = 0; index < chunk_count; ++ index) {
+                compute_gradients(index);
+            }
+        }
+        double gradient = 0.0, hessian = 0.0;
+        for(size_t row = 0; row < row_count; ++ row) {
+            rows[row] = (uint32_t)row;
+            gradient += gradients[row];
+            hessian += hessians[row];
+        }
+        uint32_t root = (uint32_t)this->_nodes.size();
+        this->_roots.push_back(root);
+        this->_nodes.push_back(BoostedNode {CompiledTree<ResultType>::npos, 0, 0, 0.0f});
+        this->_grow(_dataset, root, rows.data(), row_count, 0, GradientHistograms(), gradient, hessian,
+                    gradients, hessians, scores);
+    }
+}
+
+/**
+ * 统计一个节点在每一个属性上的梯度直方图，足够大的节点在线程池中并行地统计各个属性
+ * 每个属性的直方图由一个线程按照行的顺序累加，结果与线程数无关
+ * @param _dataset 编码后的训练数据集
+ * @param _rows 节点拥有的数据的行下标
+ * @param _row_count 节点拥有的数据的行数
+ * @param _gradients 每一行的梯度
+ * @param _hessians 每一行的二阶导数
+ * @param _histograms 输出的直方图
+ */
+template<class AttributeType, class ResultType, class Loss>
+void GradientBoosting<AttributeType, ResultType, Loss>::_build_histograms(
+        const Dataset<AttributeType, ResultType> &_dataset, const uint32_t *_rows, size_t _row_count,
+        const std::vector<double> &_gradients, const std::vector<double> &_hessians,
+        GradientHistograms &_histograms) const {
+    _histograms.resize(_dataset.attribute_count());
+    auto build = [&](size_t _attribute_index) {
+        std::vector<GradientBin>& histogram = _histograms[_attribute_index];
+        histogram.assign(_dataset.cardinality(_attribute_index), GradientBin {0.0, 0.0, 0});
+        auto accumulate = [&](const auto* _column) {
+            for(size_t index = 0; index < _row_count; ++ index) {
+                uint32_t row = _rows[index];
+                GradientBin& bin = histogram[_column[row]];
+                bin.gradient += _gradients[row];
+                bin.hessian += _hessians[row];
+                ++ bin.count;
+            }
+        };
+        if (_dataset.is_numeric(_attribute_index)) {
+            accumulate(_dataset.bin_column(_attribute_index));
+        } else {
+            accumulate(_dataset.column(_attribute_index));
+        }
+    };
+    if (this->_thread_pool && _row_count >= this->_parallel_cutoff) {
+        this->_thread_pool->parallel_for(0, _histograms.size(), build);
+    } else {
+        for(size_t index = 0; index < _histograms.size(); ++ index) {
+            build(index);
+        }
+    }
+}
+
+/**
+ * 在梯度直方图上选出增益最大的二分划分
+ * 数值型的列从小到大依次把分箱移动到左侧，普通的列依次尝试把每一种取值单独分到左侧
+ * @param _dataset 编码后的训练数据集
+ * @param _histograms 节点的梯度直方图
+ * @param _gradient 节点的梯度之和
+ * @param _hessian 节点的二阶导数之和
+ * @param _row_count 节点的行数
+ * @return 选出的划分，增益相同时选择列下标以及阈值较小的划分
+ */
+template<class AttributeType, class ResultType, class Loss>
+typename GradientBoosting<AttributeType, ResultType, Loss>::BoostSplit
+GradientBoosting<AttributeType, ResultType, Loss>::_find_split(const Dataset<AttributeType, ResultType> &_dataset,
+                                                               const GradientHistograms &_histograms,
+                                                               double _gradient, double _hessian,
+                                                               size_t _row_count) const {
+    const double lambda = this->_lambda;
+    const double parent = _gradient * _gradient / (_hessian + lambda);
+    BoostSplit best {0, 0, 0.0, 0.0, 0.0, false};
+    auto consider = [&](size_t _attribute_index, uint32_t _threshold, double _left_gradient, double _left_hessian,
+                        size_t _left_count) {
+        if (_left_count < this->_min_child_rows || _row_count - _left_count < this->_min_child_rows) {
+            return;
+        }
+        double right_gradient = _gradient - _left_gradient;
+        double right_hessian = _hessian - _left_hessian;
+        double gain = _left_gradient * _left_gradient / (_left_hessian + lambda)
+                + right_gradient * right_gradient / (right_hessian + lambda) - parent;
+        if (gain > best.gain) {
+            best = BoostSplit {_attribute_index, _threshold, gain, _left_gradient, _left_hessian, true};
+        }
+    };
+    for(size_t attribute_index = 0; attribute_index < _histograms.size(); ++ attribute_index) {
+        const std::vector<GradientBin>& histogram = _histograms[attribute_index];
+        if (_dataset.is_numeric(attribute_index)) {
+            double left_gradient = 0.0, left_hessian = 0.0;
+            size_t left_count = 0;
+            for(size_t bin = 0; bin + 1 < histogram.size(); ++ bin) {
+                left_gradient += histogram[bin].gradient;
+                left_hessian += histogram[bin].hessian;
+                left_count += histogram[bin].count;
+                if (histogram[bin].count != 0) {
+                    consider(attribute_index, (uint32_t)bin, left_gradient, left_hessian, left_count);
+                }
+            }
+        } else {
+            for(size_t code = 0; code < histogram.size(); ++ code) {
+                if (histogram[code].count != 0) {
+                    consider(attribute_index, (uint32_t)code, histogram[code].gradient, histogram[code].hessian,
+                             histogram[code].count);
+                }
+            }
+        }
+    }
+    return best;
+}
+
+/**
+ * 生长以某一节点为根的子树
+ * 划分后只对较小的子节点统计直方图，较大的子节点的直方图由父节点的直方图减去较小的子节点得到
+ * @param _dataset 编码后的训练数据集
+ * @param _node 节点的下标，节点已经在数组中分配
+ * @param _rows 节点拥有的数据的行下标区间的起点，会被原地重排
+ * @param _row_count 节点拥有的数据的行数
+ * @param _depth 节点的深度
+ * @param _histograms 节点的梯度直方图，为空时由节点自己统计
+ * @param _gradient 节点的梯度之和
+ * @param _hessian 节点的二阶导数之和
+ * @param _gradients 每一行的梯度
+ * @param _hessians 每一行的二阶导数
+ * @param _scores 每一行当前的预测值，结果节点会把自己的值累加到所拥有的行上
+ */
+template<class AttributeType, class ResultType, class Loss>
+void GradientBoosting<AttributeType, ResultType, Loss>::_grow(const Dataset<AttributeType, ResultType> &_dataset,
+                                                              uint32_t _node, uint32_t *_rows, size_t _row_count,
+                                                              size_t _depth, GradientHistograms _histograms,
+                                                              double _gradient, double _hessian,
+                                                              const std::vector<double> &_gradients,
+                                                              const std::vector<double> &_hessians,
+                                                              std::vector<double> &_scores) {
+    BoostSplit split {0, 0, 0.0, 0.0, 0.0, false};
+    if (_depth < this->_max_depth && _row_count >= 2 * this->_min_child_rows) {
+        if (_histograms.empty()) {
+            this->_build_histograms(_dataset, _rows, _row_count, _gradients, _hessians, _histograms);
+        }
+        split = this->_find_split(_dataset, _histograms, _gradient, _hessian, _row_count);
+    }
+    if (!split.valid) { // 成为结果节点，值直接累加到所拥有的行上
+        const float value = (float)(-_gradient / (_hessian + this->_lambda) * this->_learning_rate);
+        this->_nodes[_node].value = value;
+        for(size_t index = 0; index < _row_count; ++ index) {
+            _scores[_rows[index]] += value;
+        }
+        return;
+    }
+    const size_t attribute_index = split.attribute_index;
+    const uint32_t threshold = split.threshold;
+    uint32_t* middle;
+    if (_dataset.is_numeric(attribute_index)) {
+        const uint8_t* bins = _dataset.bin_column(attribute_index);
+        middle = std::partition(_rows, _rows + _row_count,
+                                [bins, threshold](uint32_t row) { return bins[row] <= threshold; });
+    } else {
+        const uint32_t* codes = _dataset.column(attribute_index);
+        middle = std::partition(_rows, _rows + _row_count,
+                                [codes, threshold](uint32_t row) { return codes[row] == threshold; });
+    }
+    const size_t left_count = (size_t)(middle - _rows);
+    const uint32_t left = (uint32_t)this->_nodes.size();
+    this->_nodes[_node].feature = _dataset.is_numeric(attribute_index) ? (uint32_t)attribute_index
+            : (uint32_t)attribute_index | BoostedNode::CATEGORICAL;
+    this->_nodes[_node].threshold = threshold;
+    this->_nodes[_node].left = left;
+    const BoostedNode leaf {CompiledTree<ResultType>::npos, 0, 0, 0.0f};
+    this->_nodes.push_back(leaf);
+    this->_nodes.push_back(leaf);
+    // 较小的子节点统计直方图，父节点的直方图减去它得到较大的子节点的直方图；子节点已经达到最大深度时不需要直方图
+    const bool left_smaller = left_count <= _row_count - left_count;
+    GradientHistograms smaller;
+    if (_depth + 1 >= this->_max_depth) {
+        _histograms.clear();
+    } else if (left_smaller) {
+        this->_build_histograms(_dataset, _rows, left_count, _gradients, _hessians, smaller);
+    } else {
+        this->_build_histograms(_dataset, middle, _row_count - left_count, _gradients, _hessians, smaller);
+    }
+    for(size_t index = 0; index < _histograms.size(); ++ index) {
+        for(size_t bin = 0; bin < _histograms[index].size(); ++ bin) {
+            _histograms[index][bin].gradient -= smaller[index][bin].gradient;
+            _histograms[index][bin].hessian -= smaller[index][bin].hessian;
+            _histograms[index][bin].count -= smaller[index][bin].count;
+        }
+    }
+    GradientHistograms& left_histograms = left_smaller ? smaller : _histograms;
+    GradientHistograms& right_histograms = left_smaller ? _histograms : smaller;
+    this->_grow(_dataset, left, _rows, left_count, _depth + 1, std::move(left_histograms),
+                split.left_gradient, split.left_hessian, _gradients, _hessians, _scores);
+    this->_grow(_dataset, left + 1, middle, _row_count - left_count, _depth + 1, std::move(right_histograms),
+                _gradient - split.left_gradient, _hessian - split.left_hessian, _gradients, _hessians, _scores);
+}
+
+template<class AttributeType, class ResultType, class Loss>
+size_t GradientBoosting<AttributeType, ResultType, Loss>::size() const {
+    return this->_roots.size();
+}
+
+template<class AttributeType, class ResultType, class Loss>
+size_t GradientBoosting<AttributeType, ResultType, Loss>::node_count() const {
+    return this->_nodes.size();
+}
+
+template<class AttributeType, class ResultType, class Loss>
+const BoostedNode *GradientBoosting<AttributeType, ResultType, Loss>::nodes() const {
+    return this->_nodes.data();
+}
+
+template<class AttributeType, class ResultType, class Loss>
+uint32_t GradientBoosting<AttributeType, ResultType, Loss>::root(size_t _index) const {
+    return this->_roots.at(_index);
+}
+
+template<class AttributeType, class ResultType, class Loss>
+double GradientBoosting<AttributeType, ResultType, Loss>::base_score() const {
+    return this->_base_score;
+}
+
+/**
+ * 使用训练时的字典对一行数据进行编码，编码后的数据按照列下标排列
+ * @param _test_x 用于预测的数据，一个map，从string映射到AttributeType
+ * @param _codes 编码的结果，缺失的属性以及训练时没有出现过的属性值编码为 CompiledTree::npos
+ */
+template<class AttributeType, class ResultType, class Loss>
+void GradientBoosting<AttributeType, ResultType, Loss>::encode(const std::map<std::string, AttributeType> &_test_x,
+                                                               std::vector<uint32_t> &_codes) const {
+    _codes.assign(this->_attribute_names.size(), CompiledTree<ResultType>::npos);
+    for(size_t index = 0; index < this->_attribute_names.size(); ++ index) {
+        auto it = _test_x.find(this->_attribute_names[index]);
+        if (it != _test_x.end()) {
+            _codes[index] = this->encode(index, it->second);
+        }
+    }
+}
+
+/**
+ * 使用训练时的字典对某一列的一个值进行编码，数值型的列编码为所在分箱的编码
+ * @param _attribute_index 属性的列下标
+ * @param _value 属性值
+ * @return 属性值的编码，训练时没有出现过的属性值为 CompiledTree::npos
+ */
+template<class AttributeType, class ResultType, class Loss>
+uint32_t GradientBoosting<AttributeType, ResultType, Loss>::encode(size_t _attribute_index,
+                                                                   const AttributeType &_value) const {
+    const Vocabulary<AttributeType>& vocabulary = this->_attribute_list[_attribute_index];
+    if (this->_numeric_list[_attribute_index]) {
+        return _dataset_self_use::find_bin(vocabulary.values(), _value);
+    }
+    uint32_t code = CompiledTree<ResultType>::npos;
+    vocabulary.find(_value, code);
+    return code;
+}
+
+/**
+ * 从某一棵树的根节点开始对一行数据进行预测，缺失的属性值(npos)在两种节点上都走右子节点
+ * @param _root 根节点的下标
+ * @param _columns 按照列下标排列的列指针
+ * @param _row 行下标
+ * @return 结果节点的值
+ */
+template<class AttributeType, class ResultType, class Loss>
+float GradientBoosting<AttributeType, ResultType, Loss>::_predict_tree(uint32_t _root, const uint32_t *const *_columns,
+                                                                       size_t _row) const {
+    const BoostedNode* nodes = this->_nodes.data();
+    const uint32_t npos = CompiledTree<ResultType>::npos;
+    uint32_t node = _root;
+    while (nodes[node].feature != npos) {
+        const BoostedNode& current = nodes[node];
+        const uint32_t code = _columns[current.feature & ~BoostedNode::CATEGORICAL][_row];
+        const bool left = (current.feature & BoostedNode::CATEGORICAL) ? code == current.threshold
+                : code <= current.threshold;
+        node = current.left + (left ? 0 : 1);
+    }
+    return nodes[node].value;
+}
+
+/**
+ * 对编码后的一行数据计算所有树的累加值(未经过损失函数的转换)
+ * @param _row 按照列下标排列的属性值编码
+ * @return 初始预测值与所有树的结果之和
+ */
+template<class AttributeType, class ResultType, class Loss>
+double GradientBoosting<AttributeType, ResultType, Loss>::predict_raw(const uint32_t *_row) const {
+    // 一行数据视为每一列只有一行的列式数据
+    std::vector<const uint32_t*> columns(this->_attribute_names.size());
+    for(size_t index = 0; index < columns.size(); ++ index) {
+        columns[index] = _row + index;
+    }
+    double score = this->_base_score;
+    for(uint32_t root: this->_roots) {
+        score += this->_predict_tree(root, columns.data(), 0);
+    }
+    return score;
+}
+
+template<class AttributeType, class ResultType, class Loss>
+double GradientBoosting<AttributeType, ResultType, Loss>::predict(const uint32_t *_row) const {
+    return Loss::transform(this->predict_raw(_row));
+}
+
+/**
+ * 对编码后的一批数据进行预测，数据按列存放，按照树的顺序逐组处理，各组在线程池中并行预测
+ * 每一组的预测值累加在_results中，一棵树处理完整组之后才会换到下一棵树
+ * @param _columns 按照列下标排列的列指针，_columns[feature][row] 为第row行在该列上的属性值编码
+ * @param _row_count 数据的行数
+ * @param _results 调用者提供的长度为_row_count的数组，写入每一行的预测值，与 predict 相同
+ */
+template<class AttributeType, class ResultType, class Loss>
+void GradientBoosting<AttributeType, ResultType, Loss>::predict(const uint32_t *const *_columns, size_t _row_count,
+                                                                double *_results) const {
+    const size_t block_rows = this->_auto_block_rows();
+    const size_t block_count = (_row_count + block_rows - 1) / block_rows;
+    auto predict_block = [&](size_t _block) {
+        const size_t begin = _block * block_rows;
+        const size_t end = std::min(_row_count, begin + block_rows);
+        std::fill(_results + begin, _results + end, this->_base_score);
+        for(uint32_t root: this->_roots) {
+            for(size_t row = begin; row < end; ++ row) {
+                _results[row] += this->_predict_tree(root, _columns, row);
+            }
+        }
+        for(size_t row = begin; row < end; ++ row) {
+            _results[row] = Loss::transform(_results[row]);
+        }
+    };
+    if (this->_thread_pool && block_count > 1) {
+        this->_thread_pool->parallel_for(0, block_count, predict_block);
+    } else {
+        for(size_t block = 0; block < block_count; ++ block) {
+            predict_block(block);
+        }
+    }
+}
+
+/**
+ * 根据二级缓存的大小选择批量预测时每一组的行数，使组内的预测值与读取的列占用不超过二级缓存的一半；
+ * 无法获取缓存大小时按照256KB计算
+ * @return 每一组的行数
+ */
+template<class AttributeType, class ResultType, class Loss>
+size_t GradientBoosting<AttributeType, ResultType, Loss>::_auto_block_rows() const {
+    const size_t step = CompiledTree<ResultType>::BLOCK_SIZE;
+    long cache_size = -1;
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    cache_size = ::sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+    if (cache_size <= 0) {
+        cache_size = 256 << 10;
+    }
+    const size_t row_bytes = sizeof(double) + this->_attribute_names.size() * sizeof(uint32_t);
+    const size_t rows = (size_t)cache_size / 2 / row_bytes / step * step;
+    return std::min<size_t>(std::max(rows, step), 64 * step);
+}
+
+/**
+ * 给出数据，使用当前的模型进行预测
+ * @param _test_x 用于预测的数据
+ * @param _test_y 预测值，直接追加到_test_y的末尾
+ */
+template<class AttributeType, class ResultType, class Loss>
+void GradientBoosting<AttributeType, ResultType, Loss>::transform(const std::map<std::string, AttributeType> &_test_x,
+                                                                  std::vector<double> &_test_y) const {
+    std::vector<uint32_t> codes;
+    this->encode(_test_x, codes);
+    _test_y.push_back(this->predict(codes.data()));
+}
+
+#endif //DESITIONTREE_GRADIENT_BOOSTING_H
@@ -0,0 +1,475 @@
+//
+// Created by wangsy on 2026/10/18.
+//
+
+#ifndef DESITIONTREE_HISTOGRAM_H
+#define DESITIONTREE_HISTOGRAM_H
+
+#include "nlogn_table.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * 直方图，记录某一属性的每一种取值下每一种结果出现的次数
+ * 所有的计数都存放在一个连续的 [属性值 x 结果] 的整数数组中，属性值与结果都必须是字典编码后的整数
+ * 所有的划分准则都在直方图上进行计算，不再直接访问原始数据
+ *
+ * <p>直方图中主要包含以下数据成员</p>
+ * <ul>
+ *  <li>计数矩阵，下标为 value * class_count + class</li>
+ *  <li>每一种属性值的总数(矩阵的行和)，以及每一种结果的总数(矩阵的列和)</li>
+ * </ul>
+ */
+class Histogram {
+private:
+    size_t _value_count; // 属性值的数量，即矩阵的行数
+    size_t _class_count; // 结果的数量，即矩阵的列数
+    size_t _total; // 参与统计的数据的总数
+    std::vector<uint32_t> _counts; // 计数矩阵
+    std::vector<uint32_t> _value_totals; // 每一种属性值的总数
+    std::vector<uint32_t> _class_totals; // 每一种结果的总数
+
+    /**
+     * 根据计数矩阵计算行和、列和以及总数
+     */
+    void _sum_up();
+
+public:
+    /**
+     * 构造一个空的直方图
+     */
+    Histogram();
+
+    /**
+     * 构造一个指定大小的直方图，所有计数都为0
+     * @param _value_count 属性值的数量
+     * @param _class_count 结果的数量
+     */
+    Histogram(size_t _value_count, size_t _class_count);
+
+    /**
+     * 重新设置直方图的大小，并且将所有计数清零，已经申请的内存会被复用
+     * @param _value_count 属性值的数量
+     * @param _class_count 结果的数量
+     */
+    void reset(size_t _value_count, size_t _class_count);
+
+    /**
+     * 统计_rows中给出的行，将计数累加到直方图中
+     * @param _column 属性的编码数组，编码必须小于 value_count()
+     * @param _labels 结果的编码数组，编码必须小于 class_count()
+     * @param _rows 参与统计的行的下标
+     * @param _row_count 参与统计的行数
+     */
+    template<class CodeType>
+    void build(const CodeType* _column, const uint32_t* _labels, const uint32_t* _rows, size_t _row_count);
+
+    /**
+     * 统计前_row_count行，将计数累加到直方图中
+     * @param _column 属性的编码数组，编码必须小于 value_count()
+     * @param _labels 结果的编码数组，编码必须小于 class_count()
+     * @param _row_count 参与统计的行数
+     */
+    template<class CodeType>
+    void build(const CodeType* _column, const uint32_t* _labels, size_t _row_count);
+
+    /**
+     * 统计_rows中给出的行，只累加计数矩阵，行和、列和以及总数在调用 finish 之前不会更新
+     * 用于分多次统计同一个直方图，例如按照行的区间依次读取磁盘上的列
+     * @param _column 属性的编码数组，编码必须小于 value_count()
+     * @param _labels 结果的编码数组，编码必须小于 class_count()
+     * @param _rows 参与统计的行的下标
+     * @param _row_count 参与统计的行数
+     */
+    template<class CodeType>
+    void accumulate(const CodeType* _column, const uint32_t* _labels, const uint32_t* _rows, size_t _row_count);
+
+    /**
+     * 在若干次 accumulate 之后，根据计数矩阵重新计算行和、列和以及总数
+     */
+    void finish();
+
+    /**
+     * 将一组计数累加到某一种属性值对应的计数行中
+     * @param _value 属性值的编码
+     * @param _counts 长度为 class_count() 的计数数组
+     */
+    void add(size_t _value, const uint32_t* _counts);
+
+    /**
+     * 将一行数据计入直方图，用于逐行更新的在线训练，总数达到 uint32_t 的上限时先调用 halve
+     * @param _value 属性值的编码，必须小于 value_count()
+     * @param _class 结果的编码，必须小于 class_count()
+     */
+    void increment(size_t _value, size_t _class);
+
+    /**
+     * 将所有计数减半(向下取整)，并重新计算行和、列和以及总数，各个计数之间的比例基本保持不变
+     */
+    void halve();
+
+    /**
+     * 扩大直方图的大小，已有的计数保持不变，新增的属性值与结果的计数为0
+     * 用于字典在训练过程中不断增长的情况，大小不会缩小
+     * @param _value_count 新的属性值的数量
+     * @param _class_count 新的结果的数量
+     */
+    void grow(size_t _value_count, size_t _class_count);
+
+    /**
+     * 将一组计数从一种属性值移动到另一种属性值，总数与每一种结果的总数不变
+     * 用于在分箱后的直方图上依次尝试阈值，每次只需要移动一个分箱的计数
+     * @param _from 移出计数的属性值的编码，该行的计数必须不少于_counts
+     * @param _to 移入计数的属性值的编码
+     * @param _counts 长度为 class_count() 的计数数组
+     */
+    void move(size_t _from, size_t _to, const uint32_t* _counts);
+
+    /**
+     * 从直方图中减去另一个大小相同的直方图的所有计数
+     * 父节点的直方图等于所有子节点的直方图之和，因此可以用父节点的直方图减去其余子节点的直方图得到某一个子节点的直方图
+     * @param _other 被减去的直方图，每一个计数都必须不大于本直方图中对应的计数
+     */
+    void subtract(const Histogram& _other);
+
+    size_t value_count() const;
+
+    size_t class_count() const;
+
+    size_t total() const;
+
+    /**
+     * 获取某一种属性值下某一种结果出现的次数
+     * @param _value 属性值的编码
+     * @param _class 结果的编码
+     * @return 出现的次数
+     */
+    uint32_t count(size_t _value, size_t _class) const;
+
+    /**
+     * 获取某一种属性值对应的计数行
+     * @param _value 属性值的编码
+     * @return 一个指向长度为 class_count() 的连续数组的指针
+     */
+    const uint32_t* row(size_t _value) const;
+
+    uint32_t value_total(size_t _value) const;
+
+    uint32_t class_total(size_t _class) const;
+
+    /**
+     * 计算结果在该属性确定时的条件熵(以10为底)
+     * @return 条件熵，没有数据时返回0
+     */
+    double conditional_entropy() const;
+
+    /**
+     * 计算结果本身的熵(以10为底)，即划分前的信息熵
+     * @return 熵，没有数据时返回0
+     */
+    double entropy() const;
+
+    /**
+     * 计算属性本身的熵(以10为底)，即增益率中的固有值(intrinsic value)
+     * @return 属性的熵，没有数据时返回0
+     */
+    double split_information() const;
+};
+
+/**
+ * 构造一个空的直方图
+ */
+inline Histogram::Histogram() {
+    this->_value_count = 0;
+    this->_class_count = 0;
+    this->_total = 0;
+}
+
+/**
+ * 构造一个指定大小的直方图，所有计数都为0
+ * @param _value_count 属性值的数量
+ * @param _class_count 结果的数量
+ */
+inline Histogram::Histogram(size_t _value_count, size_t _class_count) {
+    this->_total = 0;
+    this->reset(_value_count, _class_count);
+}
+
+/**
+ * 重新设置直方图的大小，并且将所有计数清零，已经申请的内存会被复用
+ * @param _value_count 属性值的数量
+ * @param _class_count 结果的数量
+ */
+inline void Histogram::reset(size_t _value_count, size_t _class_count) {
+    this->_value_count = _value_count;
+    this->_class_count = _class_count;
+    this->_total = 0;
+    this->_counts.assign(_value_count * _class_count, 0);
+    this->_value_totals.assign(_value_count, 0);
+    this->_class_totals.assign(_class_count, 0);
+}
+
+/**
+ * 统计_rows中给出的行，将计数累加到直方图中
+ * 每一行只需要一次对计数矩阵的自增，不会进行任何查找与内存申请
+ * @param _column 属性的编码数组，编码必须小于 value_count()
+ * @param _labels 结果的编码数组，编码必须小于 class_count()
+ * @param _rows 参与统计的行的下标
+ * @param _row_count 参与统计的行数
+ */
+template<class CodeType>
+void Histogram::build(const CodeType *_column, const uint32_t *_labels, const uint32_t *_rows, size_t _row_count) {
+    this->accumulate(_column, _labels, _rows, _row_count);
+    this->_sum_up();
+}
+
+/**
+ * 统计_rows中给出的行，只累加计数矩阵，行和、列和以及总数在调用 finish 之前不会更新
+ * @param _column 属性的编码数组，编码必须小于 value_count()
+ * @param _labels 结果的编码数组，编码必须小于 class_count()
+ * @param _rows 参与统计的行的下标
+ * @param _row_count 参与统计的行数
+ */
+template<class CodeType>
+void Histogram::accumulate(const CodeType *_column, const uint32_t *_labels, const uint32_t *_rows, size_t _row_count) {
+    uint32_t* counts = this->_counts.data();
+    const size_t class_count = this->_class_count;
+    for(size_t i = 0; i < _row_count; ++ i) {
+        const uint32_t row = _rows[i];
+        counts[(size_t)_column[row] * class_count + _labels[row]] ++;
+    }
+}
+
+/**
+ * 在若干次 accumulate 之后，根据计数矩阵重新计算行和、列和以及总数
+ */
+inline void Histogram::finish() {
+    this->_sum_up();
+}
+
+/**
+ * 统计前_row_count行，将计数累加到直方图中
+ * @param _column 属性的编码数组，编码必须小于 value_count()
+ * @param _labels 结果的编码数组，编码必须小于 class_count()
+ * @param _row_count 参与统计的行数
+ */
+template<class CodeType>
+void Histogram::build(const CodeType *_column, const uint32_t *_labels, size_t _row_count) {
+    uint32_t* counts = this->_counts.data();
+    const size_t class_count = this->_class_count;
+    for(size_t row = 0; row < _row_count; ++ row) {
+        counts[(size_t)_column[row] * class_count + _labels[row]] ++;
+    }
+    this->_sum_up();
+}
+
+/**
+ * 根据计数矩阵计算行和、列和以及总数
+ */
+inline void Histogram::_sum_up() {
+    std::fill(this->_class_totals.begin(), this->_class_totals.end(), 0);
+    this->_total = 0;
+    for(size_t value = 0; value < this->_value_count; ++ value) {
+        const uint32_t* cur = this->row(value);
+        uint32_t value_total = 0;
+        for(size_t cls = 0; cls < this->_class_count; ++ cls) {
+            value_total += cur[cls];
+            this->_class_totals[cls] += cur[cls];
+        }
+        this->_value_totals[value] = value_total;
+        this->_total += value_total;
+    }
+}
+
+/**
+ * 将一组计数累加到某一种属性值对应的计数行中
+ * @param _value 属性值的编码
+ * @param _counts 长度为 class_count() 的计数数组
+ */
+inline void Histogram::add(size_t _value, const uint32_t *_counts) {
+    uint32_t* cur = this->_counts.data() + _value * this->_class_count;
+    for(size_t cls = 0; cls < this->_class_count; ++ cls) {
+        cur[cls] += _counts[cls];
+        this->_value_totals[_value] += _counts[cls];
+        this->_class_totals[cls] += _counts[cls];
+        this->_total += _counts[cls];
+    }
+}
+
+/**
+ * 将一行数据计入直方图，用于逐行更新的在线训练
+ * 每一个计数以及行和、列和都不超过总数，因此总数达到 uint32_t 的上限时先将所有计数减半，
+ * 之后的数据与减半后的计数一起参与评分(在线学习中常用的衰减)，不会有计数溢出或者被冻结
+ * @param _value 属性值的编码，必须小于 value_count()
+ * @param _class 结果的编码，必须小于 class_count()
+ */
+inline void Histogram::increment(size_t _value, size_t _class) {
+    if (this->_total >= std::numeric_limits<uint32_t>::max()) {
+        this->halve();
+    }
+    ++ this->_counts[_value * this->_class_count + _class];
+    ++ this->_value_totals[_value];
+    ++ this->_class_totals[_class];
+    ++ this->_total;
+}
+
+/**
+ * 将所有计数减半(向下取整)，并重新计算行和、列和以及总数
+ */
+inline void Histogram::halve() {
+    for(size_t index = 0; index < this->_value_count * this->_class_count; ++ index) {
+        this->_counts[index] >>= 1;
+    }
+    this->_sum_up();
+}
+
+/**
+ * 扩大直方图的大小，已有的计数保持不变，新增的属性值与结果的计数为0
+ * 结果的数量不变时计数矩阵只需要在末尾追加，否则按照新的行宽重新排列
+ * @param _value_count 新的属性值的数量
+ * @param _class_count 新的结果的数量
+ */
+inline void Histogram::grow(size_t _value_count, size_t _class_count) {
+    _value_count = std::max(_value_count, this->_value_count);
+    _class_count = std::max(_class_count, this->_class_count);
+    if (_class_count != this->_class_count) {
+        std::vector<uint32_t> counts(_value_count * _class_count, 0);
+        for(size_t value = 0; value < this->_value_count; ++ value) {
+            std::copy(this->row(value), this->row(value) + this->_class_count, counts.data() + value * _class_count);
+        }
+        this->_counts.swap(counts);
+        this->_class_totals.resize(_class_count, 0);
+    } else {
+        this->_counts.resize(_value_count * _class_count, 0);
+    }
+    this->_value_totals.resize(_value_count, 0);
+    this->_value_count = _value_count;
+    this->_class_count = _class_count;
+}
+
+/**
+ * 将一组计数从一种属性值移动到另一种属性值，总数与每一种结果的总数不变
+ * @param _from 移出计数的属性值的编码，该行的计数必须不少于_counts
+ * @param _to 移入计数的属性值的编码
+ * @param _counts 长度为 class_count() 的计数数组
+ */
+inline void Histogram::move(size_t _from, size_t _to, const uint32_t *_counts) {
+    uint32_t* from = this->_counts.data() + _from * this->_class_count;
+    uint32_t* to = this->_counts.data() + _to * this->_class_count;
+    for(size_t cls = 0; cls < this->_class_count; ++ cls) {
+        from[cls] -= _counts[cls];
+        to[cls] += _counts[cls];
+        this->_value_totals[_from] -= _counts[cls];
+        this->_value_totals[_to] += _counts[cls];
+    }
+}
+
+/**
+ * 从直方图中减去另一个大小相同的直方图的所有计数
+ * 只需要遍历计数矩阵以及行和、列和，与数据的行数无关
+ * @param _other 被减去的直方图，每一个计数都必须不大于本直方图中对应的计数
+ */
+inline void Histogram::subtract(const Histogram &_other) {
+    for(size_t i = 0; i < this->_counts.size(); ++ i) {
+        this->_counts[i] -= _other._counts[i];
+    }
+    for(size_t value = 0; value < this->_value_count; ++ value) {
+        this->_value_totals[value] -= _other._value_totals[value];
+    }
+    for(size_t cls = 0; cls < this->_class_count; ++ cls) {
+        this->_class_totals[cls] -= _other._class_totals[cls];
+    }
+    this->_total -= _other._total;
+}
+
+inline size_t Histogram::value_count() const {
+    return this->_value_count;
+}
+
+inline size_t Histogram::class_count() const {
+    return this->_class_count;
+}
+
+inline size_t Histogram::total() const {
+    return this->_total;
+}
+
+inline uint32_t Histogram::count(size_t _value, size_t _class) const {
+    return this->_counts[_value * this->_class_count + _class];
+}
+
+inline const uint32_t *Histogram::row(size_t _value) const {
+    return this->_counts.data() + _value * this->_class_count;
+}
+
+inline uint32_t Histogram::value_total(size_t _value) const {
+    return this->_value_totals[_value];
+}
+
+inline uint32_t Histogram::class_total(size_t _class) const {
+    return this->_class_totals[_class];
+}
+
+/**
+ * 计算结果在该属性确定时的条件熵(以10为底)
+ * H(Y|X) = sum_v (N_v / N) * H(Y|X=v) = (sum_v N_v * ln(N_v) - sum_{v,c} n_vc * ln(n_vc)) / (N * ln(10))
+ * 所有的 n * ln(n) 都从查找表中得到，整个计算只有查表、求和以及一次除法
+ * @return 条件熵，没有数据时返回0
+ */
+inline double Histogram::conditional_entropy() const {
+    if (this->_total == 0) {
+        return 0.0;
+    }
+    NLogNTable& table = NLogNTable::instance();
+    table.ensure(this->_total); // 任何一个计数都不会超过总数
+    double cell_sum = 0.0;
+    for(uint32_t n: this->_counts) {
+        cell_sum += table(n);
+    }
+    double value_sum = 0.0;
+    for(uint32_t n: this->_value_totals) {
+        value_sum += table(n);
+    }
+    return (value_sum - cell_sum) / ((double)this->_total * std::log(10.0));
+}
+
+/**
+ * 计算结果本身的熵(以10为底)，即划分前的信息熵
+ * H(Y) = (N * ln(N) - sum_c n_c * ln(n_c)) / (N * ln(10))
+ * @return 熵，没有数据时返回0
+ */
+inline double Histogram::entropy() const {
+    if (this->_total == 0) {
+        return 0.0;
+    }
+    NLogNTable& table = NLogNTable::instance();
+    table.ensure(this->_total);
+    double class_sum = 0.0;
+    for(uint32_t n: this->_class_totals) {
+        class_sum += table(n);
+    }
+    return (table(this->_total) - class_sum) / ((double)this->_total * std::log(10.0));
+}
+
+/**
+ * 计算属性本身的熵(以10为底)，即增益率中的固有值(intrinsic value)
+ * IV(X) = (N * ln(N) - sum_v N_v * ln(N_v)) / (N * ln(10))
+ * @return 属性的熵，没有数据时返回0
+ */
+inline double Histogram::split_information() const {
+    if (this->_total == 0) {
+        return 0.0;
+    }
+    NLogNTable& table = NLogNTable::instance();
+    table.ensure(this->_total);
+    double value_sum = 0.0;
+    for(uint32_t n: this->_value_totals) {
+        value_sum += table(n);
+    }
+    return (table(this->_total) - value_sum) / ((double)this->_total * std::log(10.0));
+}
+
+#endif //DESITIONTREE_HISTOGRAM_H
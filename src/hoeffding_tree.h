@@ -0,0 +1,552 @@
+//
+// Created by wangsy on 2026/10/18.
+//
+
+#ifndef DESITIONTREE_HOEFFDING_TREE_H
+#define DESITIONTREE_HOEFFDING_TREE_H
+
+#include "compiled_tree.h"
+#include "histogram.h"
+#include "split_criterion.h"
+#include "vocabulary.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace _hoeffding_tree_self_use {
+
+    /**
+     * 划分准则的取值范围R，用于计算Hoeffding界，只有信息增益与基尼指数可以用于在线训练
+     * @param _class_count 结果的数量
+     * @return 评分之差的上界
+     */
+    inline double criterion_range(const InformationGain&, size_t _class_count) {
+        return std::log10((double)std::max<size_t>(2, _class_count)); // 条件熵以10为底
+    }
+
+    inline double criterion_range(const GiniIndex&, size_t) {
+        return 1.0;
+    }
+
+    /**
+     * 在线决策树的节点，结果节点保存每一个候选属性的直方图作为充分统计量，划分后或者不可能再划分时释放
+     */
+    struct HoeffdingNode {
+        uint32_t attribute_index; // 决策的列下标，结果节点为 CompiledTree::npos
+        std::vector<uint32_t> children; // 每一种属性值对应的子节点的下标，没有子节点时为 CompiledTree::npos
+        std::vector<uint64_t> class_counts; // 该节点见过的每一种结果的数量，用于预测
+        std::vector<size_t> attributes; // 结果节点的候选属性；决策节点为子节点的候选属性
+        std::vector<Histogram> histograms; // 每一个候选属性的直方图，与 attributes 一一对应，只有可以划分的结果节点拥有，
+                                           // 第一次更新时才申请
+        uint64_t pending; // 上一次尝试划分之后新增的行数
+    };
+}
+
+/**
+ * 在线(流式)决策树(Hoeffding tree / VFDT)，数据以小批量的形式依次到达，模型只更新计数，不需要重新读取历史数据
+ *
+ * <p>训练方式</p>
+ * <ul>
+ *  <li>每一行从根节点走到所在的结果节点，累加该结果节点上每一个候选属性的直方图，随后这一行就不再需要</li>
+ *  <li>结果节点每新增 grace_period 行尝试一次划分：计算评分最好与次好的选择(包括不划分)之差，
+ *  当差值大于Hoeffding界 ε = sqrt(R^2 ln(1/δ) / 2n) 时，以1-δ的置信度认为最好的属性确实更好，进行划分；
+ *  两者过于接近(ε 小于 tie_threshold)时也进行划分</li>
+ *  <li>划分后释放该节点的直方图，新的结果节点从零开始统计</li>
+ *  <li>结果节点的数量达到 max_leaves 后任何结果节点都不可能再划分：释放所有的直方图，之后只更新结果的计数，
+ *  也不再为新出现的属性值扩大子节点表，模型的内存不再增长(字典除外)</li>
+ *  <li>直方图的计数在达到 uint32_t 的上限后饱和，结果的计数使用 uint64_t</li>
+ *  <li>属性值与结果的字典随着数据不断增长，新出现的属性值在决策节点上得到新的子节点</li>
+ * </ul>
+ * 预测时使用所在节点见过的结果中数量最多的一个，没有见过任何数据的节点使用最近的有数据的祖先节点
+ * @param Criterion 划分准则，InformationGain 或 GiniIndex
+ */
+template<class AttributeType, class ResultType, class Criterion = InformationGain>
+class HoeffdingTree {
+private:
+    typedef _hoeffding_tree_self_use::HoeffdingNode HoeffdingNode;
+
+    std::vector<HoeffdingNode> _nodes; // 所有节点，根节点的下标为0
+    std::vector<std::string> _attribute_names; // 每一列的属性名，下标为列下标
+    std::vector<Vocabulary<AttributeType>> _attribute_list; // 每一列的字典，随着数据增长
+    Vocabulary<ResultType> _result_list; // 结果的字典，随着数据增长
+    double _delta; // Hoeffding界的置信参数δ
+    double _tie_threshold; // ε 小于该值时直接划分
+    uint64_t _grace_period; // 结果节点每新增多少行尝试一次划分
+    size_t _max_leaves; // 结果节点数量的上限，为0时没有限制
+    size_t _leaf_count; // 结果节点的数量
+    uint64_t _row_count; // 已经训练的总行数
+
+    /**
+     * 创建一个结果节点，结果节点的数量因此达到上限时释放所有的直方图
+     * @param _attributes 候选属性
+     * @return 新节点的下标
+     */
+    uint32_t _new_leaf(const std::vector<size_t>& _attributes);
+
+    /**
+     * 判断结果节点的数量是否已经达到上限，达到上限后任何划分都会增加结果节点，因此不会再发生
+     * @return 达到上限时返回true
+     */
+    bool _capped() const;
+
+    /**
+     * 释放所有结果节点的直方图，在结果节点不可能再划分时调用
+     */
+    void _release_histograms();
+
+    /**
+     * 将一行数据从根节点走到所在的节点，遇到新的属性值时创建新的结果节点(结果节点的数量已经达到上限时停在决策节点)
+     * @param _codes 按照列下标排列的列编码
+     * @param _row 行下标
+     * @return 所在节点的下标
+     */
+    uint32_t _route(const std::vector<std::vector<uint32_t>>& _codes, size_t _row);
+
+    /**
+     * 尝试划分一个结果节点
+     * @param _node 结果节点的下标
+     */
+    void _try_split(uint32_t _node);
+
+public:
+    /**
+     * 构造一棵只有一个结果节点的在线决策树
+     * @param _attribute_name_list 属性名，列下标即为该数组中的下标，之后的每一批数据都必须包含这些属性
+     */
+    explicit HoeffdingTree(const std::vector<std::string>& _attribute_name_list);
+
+    /**
+     * 设置Hoeffding界的置信参数δ，越小越保守，默认为1e-7
+     * @param _delta 置信参数，在(0, 1)之间
+     */
+    void set_confidence(double _delta);
+
+    /**
+     * 设置评分过于接近时直接划分的阈值τ，默认为0.05
+     * @param _tie_threshold 阈值
+     */
+    void set_tie_threshold(double _tie_threshold);
+
+    /**
+     * 设置结果节点每新增多少行尝试一次划分，默认为200
+     * @param _grace_period 行数，至少为1
+     */
+    void set_grace_period(uint64_t _grace_period);
+
+    /**
+     * 设置结果节点数量的上限，达到上限后释放所有的直方图，只更新结果的计数，不再划分
+     * 之后放宽上限时，结果节点的直方图从零开始重新统计
+     * @param _max_leaves 上限，为0时没有限制
+     */
+    void set_max_leaves(size_t _max_leaves);
+
+    /**
+     * 使用一批新的数据更新模型
+     * @param _batch_x 一个map<string, vector<AttributeType>>，必须包含构造时给出的所有属性，相同下标的代表同一个数据
+     * @param _batch_y 一个一维数组，表示_batch_x的每一行的结果
+     */
+    void partial_fit(const std::map<std::string, std::vector<AttributeType>>& _batch_x,
+                     const std::vector<ResultType>& _batch_y);
+
+    /**
+     * 使用训练时的字典对一行数据进行编码，编码后的数据按照列下标排列
+     * @param _test_x 用于预测的数据，一个map，从string映射到AttributeType
+     * @param _codes 编码的结果，缺失的属性以及没有出现过的属性值编码为 CompiledTree::npos
+     */
+    void encode(const std::map<std::string, AttributeType>& _test_x, std::vector<uint32_t>& _codes) const;
+
+    /**
+     * 对编码后的一行数据进行预测
+     * @param _row 按照列下标排列的属性值编码
+     * @param _result 预测的结果，仅在返回true时有效
+     * @return 模型见过任何数据时返回true
+     */
+    bool predict(const uint32_t* _row, ResultType& _result) const;
+
+    /**
+     * 给出数据，使用当前的模型进行预测
+     * @param _test_x 用于预测的数据
+     * @param _test_y 预测的结果，直接追加到_test_y的末尾，无法给出预测时不追加
+     */
+    void transform(const std::map<std::string, AttributeType>& _test_x, std::vector<ResultType>& _test_y) const;
+
+    size_t node_count() const;
+
+    size_t leaf_count() const;
+
+    /**
+     * 获取已经训练的总行数
+     * @return 行数
+     */
+    uint64_t row_count() const;
+
+    /**
+     * 估计模型占用的字节数，主要是结果节点的直方图
+     * @return 字节数
+     */
+    size_t memory_bytes() const;
+};
+
+/**
+ * 构造一棵只有一个结果节点的在线决策树
+ * @param _attribute_name_list 属性名，列下标即为该数组中的下标，之后的每一批数据都必须包含这些属性
+ */
+template<class AttributeType, class ResultType, class Criterion>
+HoeffdingTree<AttributeType, ResultType, Criterion>::HoeffdingTree(const std::vector<std::string> &_attribute_name_list) {
+    this->_attribute_names = _attribute_name_list;
+    this->_attribute_list.resize(_attribute_name_list.size());
+    this->_delta = 1e-7;
+    this->_tie_threshold = 0.05;
+    this->_grace_period = 200;
+    this->_max_leaves = 0;
+    this->_leaf_count = 0;
+    this->_row_count = 0;
+    std::vector<size_t> attributes(_attribute_name_list.size());
+    for(size_t index = 0; index < attributes.size(); ++ index) {
+        attributes[index] = index;
+    }
+    this->_new_leaf(attributes);
+}
+
+template<class AttributeType, class ResultType, class Criterion>
+void HoeffdingTree<AttributeType, ResultType, Criterion>::set_confidence(double _delta) {
+    if (!(_delta > 0.0 && _delta < 1.0)) {
+        throw std::invalid_argument("HoeffdingTree: delta must be in (0, 1)");
+    }
+    this->_delta = _delta;
+}
+
+template<class AttributeType, class ResultType, class Criterion>
+void HoeffdingTree<AttributeType, ResultType, Criterion>::set_tie_threshold(double _tie_threshold) {
+    this->_tie_threshold = _tie_threshold;
+}
+
+template<class AttributeType, class ResultType, class Criterion>
+void HoeffdingTree<AttributeType, ResultType, Criterion>::set_grace_period(uint64_t _grace_period) {
+    this->_grace_period = std::max<uint64_t>(1, _grace_period);
+}
+
+template<class AttributeType, class ResultType, class Criterion>
+void HoeffdingTree<AttributeType, ResultType, Criterion>::set_max_leaves(size_t _max_leaves) {
+    this->_max_leaves = _max_leaves;
+    if (this->_capped()) {
+        this->_release_histograms();
+    }
+}
+
+/**
+ * 创建一个结果节点，直方图在第一次更新时才申请内存
+ * 结果节点的数量因此达到上限时释放所有的直方图，上限只会在这里以及 set_max_leaves 中达到
+ * @param _attributes 候选属性
+ * @return 新节点的下标
+ */
+template<class AttributeType, class ResultType, class Criterion>
+uint32_t HoeffdingTree<AttributeType, ResultType, Criterion>::_new_leaf(const std::vector<size_t> &_attributes) {
+    HoeffdingNode node;
+    node.attribute_index = CompiledTree<ResultType>::npos;
+    node.attributes = _attributes;
+    node.pending = 0;
+    this->_nodes.push_back(std::move(node));
+    ++ this->_leaf_count;
+    if (this->_capped()) {
+        this->_release_histograms();
+    }
+    return (uint32_t)(this->_nodes.size() - 1);
+}
+
+template<class AttributeType, class ResultType, class Criterion>
+bool HoeffdingTree<AttributeType, ResultType, Criterion>::_capped() const {
+    return this->_max_leaves != 0 && this->_leaf_count >= this->_max_leaves;
+}
+
+/**
+ * 释放所有结果节点的直方图，在结果节点不可能再划分时调用
+ */
+template<class AttributeType, class ResultType, class Criterion>
+void HoeffdingTree<AttributeType, ResultType, Criterion>::_release_histograms() {
+    for(HoeffdingNode& node: this->_nodes) {
+        std::vector<Histogram>().swap(node.histograms);
+        node.pending = 0;
+    }
+}
+
+/**
+ * 使用一批新的数据更新模型
+ * 先用不断增长的字典对这一批数据进行编码，再逐行走到所在的结果节点并累加计数，结果节点的计数足够时立即尝试划分，
+ * 之后的行会走到划分后的子节点
+ * @param _batch_x 一个map<string, vector<AttributeType>>，必须包含构造时给出的所有属性，相同下标的代表同一个数据
+ * @param _batch_y 一个一维数组，表示_batch_x的每一行的结果
+ */
+template<class AttributeType, class ResultType, class Criterion>
+void HoeffdingTree<AttributeType, ResultType, Criterion>::partial_fit(
+        const std::map<std::string, std::vector<AttributeType>> &_batch_x, const std::vector<ResultType> &_batch_y) {
+    const size_t row_count = _batch_y.size();
+    std::vector<const std::vector<AttributeType>*> sources(this->_attribute_names.size());
+    for(size_t index = 0; index < sources.size(); ++ index) {
+        auto it = _batch_x.find(this->_attribute_names[index]);
+        if (it == _batch_x.end() || it->second.size() != row_count) {
+            throw std::invalid_argument("HoeffdingTree::partial_fit: column '" + this->_attribute_names[index]
+                                        + "' is missing or has a different length");
+        }
+        sources[index] = &it->second;
+    }
+    std::vector<std::vector<uint32_t>> codes(sources.size(), std::vector<uint32_t>(row_count));
+    for(size_t index = 0; index < sources.size(); ++ index) {
+        for(size_t row = 0; row < row_count; ++ row) {
+            codes[index][row] = this->_attribute_list[index].insert((*sources[index])[row]);
+        }
+    }
+    std::vector<uint32_t> labels(row_count);
+    for(size_t row = 0; row < row_count; ++ row) {
+        labels[row] = this->_result_list.insert(_batch_y[row]);
+    }
+    const size_t class_count = this->_result_list.size();
+    for(size_t row = 0; row < row_count; ++ row) {
+        const uint32_t index = this->_route(codes, row);
+        HoeffdingNode& node = this->_nodes[index];
+        const uint32_t label = labels[row];
+        if (node.class_counts.size() < class_count) {
+            node.class_counts.resize(class_count, 0);
+        }
+        ++ node.class_counts[label];
+        // 停在决策节点，或者结果节点的数量已经达到上限，都不会再划分，只更新结果的计数
+        if (node.attribute_index != CompiledTree<ResultType>::npos || this->_capped()) {
+            continue;
+        }
+        if (node.histograms.size() != node.attributes.size()) {
+            node.histograms.resize(node.attributes.size());
+        }
+        for(size_t position = 0; position < node.attributes.size(); ++ position) {
+            const size_t attribute_index = node.attributes[position];
+            const uint32_t code = codes[attribute_index][row];
+            Histogram& histogram = node.histograms[position];
+            if (code >= histogram.value_count() || label >= histogram.class_count()) {
+                histogram.grow(this->_attribute_list[attribute_index].size(), class_count);
+            }
+            // 同一个节点的所有直方图总数相同，总数达到上限时在同一行一起减半，评分时各个直方图的规模保持一致
+            histogram.increment(code, label);
+        }
+        if (++ node.pending >= this->_grace_period) {
+            node.pending = 0;
+            this->_try_split(index);
+        }
+    }
+    this->_row_count += row_count;
+}
+
+/**
+ * 将一行数据从根节点走到所在的节点，遇到新的属性值时创建新的结果节点(结果节点的数量已经达到上限时停在决策节点)
+ * @param _codes 按照列下标排列的列编码
+ * @param _row 行下标
+ * @return 所在节点的下标
+ */
+template<class AttributeType, class ResultType, class Criterion>
+uint32_t HoeffdingTree<AttributeType, ResultType, Criterion>::_route(const std::vector<std::vector<uint32_t>> &_codes,
+                                                                     size_t _row) {
+    const uint32_t npos = CompiledTree<ResultType>::npos;
+    uint32_t index = 0;
+    while (this->_nodes[index].attribute_index != npos) {
+        const size_t attribute_index = this->_nodes[index].attribute_index;
+        const uint32_t code = _codes[attribute_index][_row];
+        if (code >= this->_nodes[index].children.size()) {
+            if (this->_capped()) { // 不会再创建子节点，不需要扩大子节点表
+                return index;
+            }
+            this->_nodes[index].children.resize(this->_attribute_list[attribute_index].size(), npos);
+        }
+        uint32_t child = this->_nodes[index].children[code];
+        if (child == npos) { // 划分之后才出现的属性值
+            if (this->_capped()) {
+                return index;
+            }
+            child = this->_new_leaf(this->_nodes[index].attributes);
+            this->_nodes[index].children[code] = child;
+        }
+        index = child;
+    }
+    return index;
+}
+
+/**
+ * 尝试划分一个结果节点
+ * 不划分也作为一个选择参与比较，它的评分为只有一种属性值的直方图的评分
+ * @param _node 结果节点的下标
+ */
+template<class AttributeType, class ResultType, class Criterion>
+void HoeffdingTree<AttributeType, ResultType, Criterion>::_try_split(uint32_t _node) {
+    if (this->_capped()) {
+        return;
+    }
+    HoeffdingNode& node = this->_nodes[_node];
+    if (node.attributes.empty()) {
+        return;
+    }
+    size_t observed = 0; // 该节点见过的结果的种类
+    for(uint64_t count: node.class_counts) {
+        observed += count != 0;
+    }
+    if (observed < 2) {
+        return;
+    }
+    const size_t class_count = this->_result_list.size();
+    Histogram unsplit(1, class_count);
+    std::vector<uint32_t> class_totals(class_count, 0);
+    for(size_t cls = 0; cls < node.histograms[0].class_count(); ++ cls) {
+        class_totals[cls] = node.histograms[0].class_total(cls);
+    }
+    unsplit.add(0, class_totals.data());
+    const double n = (double)unsplit.total();
+    double best = Criterion::score(unsplit), second = best;
+    size_t best_position = node.attributes.size(); // 不划分
+    for(size_t position = 0; position < node.attributes.size(); ++ position) {
+        double score = Criterion::score(node.histograms[position]);
+        if (score < best) {
+            second = best;
+            best = score;
+            best_position = position;
+        } else if (score < second) {
+            second = score;
+        }
+    }
+    if (best_position == node.attributes.size()) {
+        return;
+    }
+    const double range = _hoeffding_tree_self_use::criterion_range(Criterion(), class_count);
+    const double epsilon = std::sqrt(range * range * std::log(1.0 / this->_delta) / (2.0 * n));
+    if (second - best <= epsilon && epsilon >= this->_tie_threshold) {
+        return;
+    }
+    // 划分：每一种见过的属性值创建一个子节点，子节点的结果计数来自该属性值的直方图，用于在子节点见到数据之前进行预测
+    const size_t attribute_index = node.attributes[best_position];
+    size_t child_count = 0;
+    for(size_t code = 0; code < node.histograms[best_position].value_count(); ++ code) {
+        child_count += node.histograms[best_position].value_total(code) != 0;
+    }
+    // 只有一个子节点的划分不会改变任何预测；限制了结果节点的数量时，划分后的数量不能超过上限
+    if (child_count < 2 || (this->_max_leaves != 0 && this->_leaf_count - 1 + child_count > this->_max_leaves)) {
+        return;
+    }
+    Histogram histogram = std::move(node.histograms[best_position]);
+    std::vector<size_t> child_attributes;
+    for(size_t position = 0; position < node.attributes.size(); ++ position) {
+        if (position != best_position) {
+            child_attributes.push_back(node.attributes[position]);
+        }
+    }
+    node.attribute_index = (uint32_t)attribute_index;
+    node.attributes = child_attributes;
+    std::vector<Histogram>().swap(node.histograms);
+    -- this->_leaf_count;
+    std::vector<uint32_t> children(this->_attribute_list[attribute_index].size(), CompiledTree<ResultType>::npos);
+    for(size_t code = 0; code < histogram.value_count(); ++ code) {
+        if (histogram.value_total(code) == 0) {
+            continue;
+        }
+        uint32_t child = this->_new_leaf(child_attributes); // 之后不能再使用 node，数组可能已经重新分配
+        this->_nodes[child].class_counts.assign(histogram.row(code), histogram.row(code) + histogram.class_count());
+        children[code] = child;
+    }
+    this->_nodes[_node].children.swap(children);
+}
+
+/**
+ * 使用训练时的字典对一行数据进行编码，编码后的数据按照列下标排列
+ * @param _test_x 用于预测的数据，一个map，从string映射到AttributeType
+ * @param _codes 编码的结果，缺失的属性以及没有出现过的属性值编码为 CompiledTree::npos
+ */
+template<class AttributeType, class ResultType, class Criterion>
+void HoeffdingTree<AttributeType, ResultType, Criterion>::encode(const std::map<std::string, AttributeType> &_test_x,
+                                                                 std::vector<uint32_t> &_codes) const {
+    _codes.assign(this->_attribute_names.size(), CompiledTree<ResultType>::npos);
+    for(size_t index = 0; index < this->_attribute_names.size(); ++ index) {
+        auto it = _test_x.find(this->_attribute_names[index]);
+        if (it != _test_x.end()) {
+            this->_attribute_list[index].find(it->second, _codes[index]);
+        }
+    }
+}
+
+/**
+ * 对编码后的一行数据进行预测，走到没有子节点的位置为止，使用路径上最后一个见过数据的节点中数量最多的结果，
+ * 数量相同时选择编码较小的结果
+ * @param _row 按照列下标排列的属性值编码
+ * @param _result 预测的结果，仅在返回true时有效
+ * @return 模型见过任何数据时返回true
+ */
+template<class AttributeType, class ResultType, class Criterion>
+bool HoeffdingTree<AttributeType, ResultType, Criterion>::predict(const uint32_t *_row, ResultType &_result) const {
+    const uint32_t npos = CompiledTree<ResultType>::npos;
+    const HoeffdingNode* voter = nullptr;
+    uint32_t index = 0;
+    while (index != npos) {
+        const HoeffdingNode& node = this->_nodes[index];
+        if (std::any_of(node.class_counts.begin(), node.class_counts.end(), [](uint64_t count) { return count != 0; })) {
+            voter = &node;
+        }
+        if (node.attribute_index == npos) {
+            break;
+        }
+        const uint32_t code = _row[node.attribute_index];
+        index = code < node.children.size() ? node.children[code] : npos;
+    }
+    if (voter == nullptr) {
+        return false;
+    }
+    size_t best = std::max_element(voter->class_counts.begin(), voter->class_counts.end()) - voter->class_counts.begin();
+    _result = this->_result_list.value((uint32_t)best);
+    return true;
+}
+
+/**
+ * 给出数据，使用当前的模型进行预测
+ * @param _test_x 用于预测的数据
+ * @param _test_y 预测的结果，直接追加到_test_y的末尾，无法给出预测时不追加
+ */
+template<class AttributeType, class ResultType, class Criterion>
+void HoeffdingTree<AttributeType, ResultType, Criterion>::transform(const std::map<std::string, AttributeType> &_test_x,
+                                                                    std::vector<ResultType> &_test_y) const {
+    std::vector<uint32_t> codes;
+    this->encode(_test_x, codes);
+    ResultType result;
+    if (this->predict(codes.data(), result)) {
+        _test_y.push_back(result);
+    }
+}
+
+template<class AttributeType, class ResultType, class Criterion>
+size_t HoeffdingTree<AttributeType, ResultType, Criterion>::node_count() const {
+    return this->_nodes.size();
+}
+
+template<class AttributeType, class ResultType, class Criterion>
+size_t HoeffdingTree<AttributeType, ResultType, Criterion>::leaf_count() const {
+    return this->_leaf_count;
+}
+
+template<class AttributeType, class ResultType, class Criterion>
+uint64_t HoeffdingTree<AttributeType, ResultType, Criterion>::row_count() const {
+    return this->_row_count;
+}
+
+/**
+ * 估计模型占用的字节数，包括节点本身、子节点表、结果计数以及结果节点的直方图，不包括字典
+ * @return 字节数
+ */
+template<class AttributeType, class ResultType, class Criterion>
+size_t HoeffdingTree<AttributeType, ResultType, Criterion>::memory_bytes() const {
+    size_t bytes = this->_nodes.capacity() * sizeof(HoeffdingNode);
+    for(const HoeffdingNode& node: this->_nodes) {
+        bytes += node.children.capacity() * sizeof(uint32_t) + node.class_counts.capacity() * sizeof(uint64_t)
+                + node.attributes.capacity() * sizeof(size_t) + node.histograms.capacity() * sizeof(Histogram);
+        for(const Histogram& histogram: node.histograms) {
+            bytes += (histogram.value_count() + 1) * (histogram.class_count() + 1) * sizeof(uint32_t);
+        }
+    }
+    return bytes;
+}
+
+#endif //DESITIONTREE_HOEFFDING_TREE_H
@@ -0,0 +1,170 @@
+//
+// Created by wangsy on 2026/10/18.
+//
+
+#ifndef DESITIONTREE_MAPPED_FILE_H
+#define DESITIONTREE_MAPPED_FILE_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * 只读的内存映射文件，文件的内容由操作系统按需读入，不占用进程自己申请的内存
+ * 同一个文件被多个进程映射时共享同一份页缓存
+ * 映射在析构时解除，对象可以移动但不能复制
+ */
+class MappedFile {
+private:
+    void* _data; // 映射的起点，空文件为空指针
+    size_t _size; // 文件的字节数
+
+    /**
+     * 解除当前的映射
+     */
+    void _unmap();
+
+public:
+    /**
+     * 构造一个没有映射任何文件的对象
+     */
+    MappedFile();
+
+    /**
+     * 以只读的方式映射一个文件，无法打开或映射时抛出std::runtime_error
+     * @param _path 文件的路径
+     */
+    explicit MappedFile(const std::string& _path);
+
+    MappedFile(MappedFile&& _other) noexcept;
+
+    MappedFile& operator=(MappedFile&& _other) noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile();
+
+    /**
+     * 获取映射的起点，起点按照页大小对齐
+     * @return 指向文件内容的指针，空文件为空指针
+     */
+    const void* data() const;
+
+    /**
+     * 获取文件的字节数
+     * @return 文件的字节数
+     */
+    size_t size() const;
+
+    /**
+     * 告知操作系统某一段内容暂时不再使用，对应的页会从进程的常驻内存中移出，之后再次访问时会重新读入
+     * @param _offset 起始的字节偏移
+     * @param _length 字节数
+     */
+    void release(size_t _offset, size_t _length) const;
+};
+
+/**
+ * 构造一个没有映射任何文件的对象
+ */
+inline MappedFile::MappedFile() {
+    this->_data = nullptr;
+    this->_size = 0;
+}
+
+/**
+ * 以只读的方式映射一个文件，无法打开或映射时抛出std::runtime_error
+ * 映射后提示操作系统顺序读取，使预读生效
+ * @param _path 文件的路径
+ */
+inline MappedFile::MappedFile(const std::string &_path) {
+    this->_data = nullptr;
+    this->_size = 0;
+    int fd = ::open(_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("MappedFile: cannot open '" + _path + "': " + std::strerror(errno));
+    }
+    struct stat status {};
+    if (::fstat(fd, &status) != 0) {
+        ::close(fd);
+        throw std::runtime_error("MappedFile: cannot stat '" + _path + "': " + std::strerror(errno));
+    }
+    this->_size = (size_t)status.st_size;
+    if (this->_size > 0) {
+        void* data = ::mmap(nullptr, this->_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("MappedFile: cannot map '" + _path + "': " + std::strerror(errno));
+        }
+        this->_data = data;
+        ::madvise(this->_data, this->_size, MADV_SEQUENTIAL);
+    }
+    ::close(fd); // 映射建立后不再需要文件描述符
+}
+
+inline MappedFile::MappedFile(MappedFile &&_other) noexcept {
+    this->_data = _other._data;
+    this->_size = _other._size;
+    _other._data = nullptr;
+    _other._size = 0;
+}
+
+inline MappedFile &MappedFile::operator=(MappedFile &&_other) noexcept {
+    if (this != &_other) {
+        this->_unmap();
+        this->_data = _other._data;
+        this->_size = _other._size;
+        _other._data = nullptr;
+        _other._size = 0;
+    }
+    return *this;
+}
+
+inline MappedFile::~MappedFile() {
+    this->_unmap();
+}
+
+inline void MappedFile::_unmap() {
+    if (this->_data != nullptr) {
+        ::munmap(this->_data, this->_size);
+        this->_data = nullptr;
+        this->_size = 0;
+    }
+}
+
+inline const void *MappedFile::data() const {
+    return this->_data;
+}
+
+inline size_t MappedFile::size() const {
+    return this->_size;
+}
+
+/**
+ * 告知操作系统某一段内容暂时不再使用，对应的页会从进程的常驻内存中移出，之后再次访问时会重新读入
+ * 与这一段有重叠的页都会被移出，与相邻段共用的页在下一次访问时重新读入，内容不会改变
+ * @param _offset 起始的字节偏移
+ * @param _length 字节数
+ */
+inline void MappedFile::release(size_t _offset, size_t _length) const {
+    if (this->_data == nullptr || _offset >= this->_size || _length == 0) {
+        return;
+    }
+    const size_t page = (size_t)::sysconf(_SC_PAGESIZE);
+    size_t begin = _offset / page * page;
+    size_t end = std::min(_offset + _length, this->_size);
+    if (begin < end) {
+        ::madvise((char*)this->_data + begin, end - begin, MADV_DONTNEED);
+    }
+}
+
+#endif //DESITIONTREE_MAPPED_FILE_H
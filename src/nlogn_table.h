@@ -0,0 +1,115 @@
+//
+// Created by wangsy on 2026/10/18.
+//
+
+#ifndef DESITIONTREE_NLOGN_TABLE_H
+#define DESITIONTREE_NLOGN_TABLE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * n * ln(n) 的查找表，用于在整数计数上计算熵，避免在划分属性的评分中调用对数函数
+ * 查找表在需要时按块增长，直到覆盖当前节点的数据量，已经计算好的块不会被移动，因此增长时其他线程可以继续查找
+ * 查找表最多覆盖 MAX_SIZE 个值(32MB)，更大的计数(例如长时间运行的在线训练)直接计算，进程的内存不会随着数据量无限增长
+ * 同一个计数得到的值在每次运行中都完全相同，训练结果可以精确复现
+ */
+class NLogNTable {
+private:
+    static const size_t CHUNK_BITS = 16; // 每一块包含 2^CHUNK_BITS 个值
+    static const size_t CHUNK_SIZE = (size_t)1 << CHUNK_BITS;
+    static const size_t MAX_SIZE = (size_t)1 << 22; // 查找表最多覆盖的值的数量
+    static const size_t MAX_CHUNKS = MAX_SIZE >> CHUNK_BITS;
+
+    std::vector<std::atomic<const double*>> _chunks; // 每一块的起点，尚未计算的块为空
+    std::vector<std::unique_ptr<double[]>> _storage; // 持有每一块的内存
+    std::atomic<size_t> _size; // 已经可以查找的值的数量
+    std::mutex _mutex; // 保护查找表的增长
+
+    NLogNTable();
+
+public:
+    NLogNTable(const NLogNTable&) = delete;
+
+    NLogNTable& operator=(const NLogNTable&) = delete;
+
+    /**
+     * 获取进程内共享的查找表
+     * @return 查找表
+     */
+    static NLogNTable& instance();
+
+    /**
+     * 保证查找表覆盖[0, min(_n, MAX_SIZE - 1)]，不足时按块增长
+     * @param _n 需要查找的最大计数
+     */
+    void ensure(size_t _n);
+
+    /**
+     * 查找 n * ln(n) 的值，0 对应的值为 0，调用前必须通过 ensure 保证查找表覆盖了_n
+     * @param _n 计数
+     * @return n * ln(n)
+     */
+    double operator()(uint64_t _n) const;
+};
+
+inline NLogNTable::NLogNTable(): _chunks(MAX_CHUNKS) {
+    for(std::atomic<const double*>& chunk: this->_chunks) {
+        chunk.store(nullptr, std::memory_order_relaxed);
+    }
+    this->_size.store(0);
+}
+
+/**
+ * 获取进程内共享的查找表
+ * @return 查找表
+ */
+inline NLogNTable &NLogNTable::instance() {
+    static NLogNTable table;
+    return table;
+}
+
+/**
+ * 保证查找表覆盖[0, min(_n, MAX_SIZE - 1)]，不足时按块增长
+ * 新的块在锁内计算，计算完成后才会增加 _size，因此查找时看到的块一定已经填好
+ * @param _n 需要查找的最大计数
+ */
+inline void NLogNTable::ensure(size_t _n) {
+    _n = std::min(_n, MAX_SIZE - 1);
+    if (_n < this->_size.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    size_t size = this->_size.load(std::memory_order_relaxed);
+    while (size <= _n) {
+        std::unique_ptr<double[]> chunk(new double[CHUNK_SIZE]);
+        for(size_t i = 0; i < CHUNK_SIZE; ++ i) {
+            double x = (double)(size + i);
+            chunk[i] = size + i > 0 ? x * std::log(x) : 0.0;
+        }
+        this->_chunks[size >> CHUNK_BITS].store(chunk.get(), std::memory_order_relaxed);
+        this->_storage.push_back(std::move(chunk));
+        size += CHUNK_SIZE;
+    }
+    this->_size.store(size, std::memory_order_release);
+}
+
+/**
+ * 查找 n * ln(n) 的值，0 对应的值为 0，调用前必须通过 ensure 保证查找表覆盖了_n
+ * 超出 MAX_SIZE 的计数不在查找表中，直接计算
+ * @param _n 计数
+ * @return n * ln(n)
+ */
+inline double NLogNTable::operator()(uint64_t _n) const {
+    if (_n >= MAX_SIZE) {
+        return (double)_n * std::log((double)_n);
+    }
+    return this->_chunks[_n >> CHUNK_BITS].load(std::memory_order_relaxed)[_n & (CHUNK_SIZE - 1)];
+}
+
+#endif //DESITIONTREE_NLOGN_TABLE_H
@@ -0,0 +1,226 @@
+//
+// Created by wangsy on 2026/10/18.
+//
+
+#ifndef DESITIONTREE_NODE_ARENA_H
+#define DESITIONTREE_NODE_ARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * 决策树节点的内存池，一棵决策树的所有节点都从同一个内存池中分配
+ * 节点不会被单独析构，所有节点只能通过 clear 一起释放，因此只能存放不需要析构的对象
+ * 内存块在 clear 后会保留最大的一块，重新训练时可以直接复用，不需要再向系统申请内存
+ *
+ * <p>节点通过 Local 进行分配：每一个 Local 每次从内存池中取出一整段(CHUNK_SIZE)，之后在这一段中按顺序分配，不需要加锁。
+ * 并行训练时每一个任务使用自己的 Local，同一棵子树的节点在内存中彼此相邻，不会与其他线程同时创建的兄弟子树交错</p>
+ */
+class NodeArena {
+private:
+    static const size_t MIN_BLOCK_SIZE = 4096; // 第一块内存的字节数
+    static const size_t MAX_BLOCK_SIZE = 1 << 20; // 每一块内存的字节数上限，更大的对象单独占用一块
+    static const size_t CHUNK_SIZE = 4096; // Local 每次从内存池中取出的字节数
+
+    std::vector<std::pair<std::unique_ptr<char[]>, size_t>> _blocks; // 所有的内存块及其字节数，最后一块为当前分配的块
+    size_t _used; // 当前块已经使用的字节数
+    std::mutex _mutex; // 保护分配
+
+    /**
+     * 在当前块中分配一段对齐的内存，当前块不足时申请新的内存块，调用时必须持有 _mutex
+     * @param _size 字节数
+     * @param _alignment 对齐的字节数
+     * @return 内存的起点
+     */
+    void* _allocate(size_t _size, size_t _alignment);
+
+    /**
+     * 加锁后分配一段对齐的内存，供 Local 取出新的一段或者单独存放较大的对象
+     * @param _size 字节数
+     * @param _alignment 对齐的字节数
+     * @return 内存的起点
+     */
+    void* _allocate_chunk(size_t _size, size_t _alignment);
+
+public:
+    /**
+     * 一个任务独占的分配位置，只能在一个线程中使用，在内存池 clear 或析构之后不能再使用
+     * 析构时当前段中剩余的内存不会被归还，随着内存池一起释放
+     */
+    class Local {
+    private:
+        NodeArena* _arena; // 所属的内存池
+        char* _cursor; // 当前段中下一次分配的起点
+        char* _end; // 当前段的终点
+
+        /**
+         * 在当前段中分配一段对齐的内存，当前段不足时从内存池中取出新的一段，较大的对象单独从内存池中分配
+         * @param _size 字节数
+         * @param _alignment 对齐的字节数
+         * @return 内存的起点
+         */
+        void* _allocate(size_t _size, size_t _alignment);
+
+    public:
+        explicit Local(NodeArena& _arena);
+
+        /**
+         * 在内存池中构造一个对象，对象必须不需要析构，随着内存池的 clear 或析构一起释放
+         * @param _args 构造函数的参数
+         * @return 新对象的指针
+         */
+        template<class ObjectType, class... Args>
+        ObjectType* create(Args&&... _args);
+
+        /**
+         * 在内存池中分配一个数组，数组的元素必须不需要析构(例如整数、指针)，初始值为_value
+         * @param _count 元素的个数
+         * @param _value 每一个元素的初始值
+         * @return 数组的起点，_count为0时返回空指针
+         */
+        template<class ValueType>
+        ValueType* create_array(size_t _count, const ValueType& _value);
+    };
+
+    NodeArena();
+
+    NodeArena(const NodeArena&) = delete;
+
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    /**
+     * 释放所有对象，只保留最大的一块内存用于之后的分配，之前的 Local 都不能再使用
+     */
+    void clear();
+
+    /**
+     * 获取已经向系统申请的字节数
+     * @return 所有内存块的字节数之和
+     */
+    size_t capacity() const;
+};
+
+inline NodeArena::NodeArena() {
+    this->_used = 0;
+}
+
+/**
+ * 在当前块中分配一段对齐的内存，当前块不足时申请新的内存块
+ * 新的内存块的大小是上一块的两倍，直到达到 MAX_BLOCK_SIZE
+ * @param _size 字节数
+ * @param _alignment 对齐的字节数
+ * @return 内存的起点
+ */
+inline void *NodeArena::_allocate(size_t _size, size_t _alignment) {
+    if (!this->_blocks.empty()) {
+        size_t begin = (this->_used + _alignment - 1) / _alignment * _alignment;
+        if (begin + _size <= this->_blocks.back().second) {
+            this->_used = begin + _size;
+            return this->_blocks.back().first.get() + begin;
+        }
+    }
+    size_t block_size = this->_blocks.empty() ? (size_t)MIN_BLOCK_SIZE
+            : std::min(this->_blocks.back().second * 2, (size_t)MAX_BLOCK_SIZE);
+    block_size = std::max(block_size, _size + _alignment);
+    // new char[] 返回的内存按照 max_align_t 对齐，更大的对齐要求在块内进行调整
+    this->_blocks.emplace_back(std::unique_ptr<char[]>(new char[block_size]), block_size);
+    char* data = this->_blocks.back().first.get();
+    size_t begin = (size_t)((-(uintptr_t)data) & (_alignment - 1));
+    this->_used = begin + _size;
+    return data + begin;
+}
+
+inline void *NodeArena::_allocate_chunk(size_t _size, size_t _alignment) {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    return this->_allocate(_size, _alignment);
+}
+
+/**
+ * 释放所有对象，只保留最大的一块内存用于之后的分配
+ * 所有对象都不需要析构，不需要遍历树的结构。单独存放较大对象的块之后可能还有更小的块，因此按照字节数选择保留的块
+ */
+inline void NodeArena::clear() {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    if (this->_blocks.size() > 1) { // 保留最大的一块，下一次训练时从它开始分配
+        auto largest = std::max_element(this->_blocks.begin(), this->_blocks.end(),
+                [](const std::pair<std::unique_ptr<char[]>, size_t>& _left, const std::pair<std::unique_ptr<char[]>, size_t>& _right) {
+                    return _left.second < _right.second;
+                });
+        std::swap(this->_blocks.front(), *largest);
+        this->_blocks.resize(1);
+    }
+    this->_used = 0;
+}
+
+inline size_t NodeArena::capacity() const {
+    size_t capacity = 0;
+    for(const auto& block: this->_blocks) {
+        capacity += block.second;
+    }
+    return capacity;
+}
+
+inline NodeArena::Local::Local(NodeArena &_arena) {
+    this->_arena = &_arena;
+    this->_cursor = nullptr;
+    this->_end = nullptr;
+}
+
+/**
+ * 在当前段中分配一段对齐的内存，当前段不足时从内存池中取出新的一段，较大的对象单独从内存池中分配
+ * 超过一段的四分之一的对象单独分配，避免丢弃当前段中剩余的大部分内存
+ * @param _size 字节数
+ * @param _alignment 对齐的字节数
+ * @return 内存的起点
+ */
+inline void *NodeArena::Local::_allocate(size_t _size, size_t _alignment) {
+    if (_size + _alignment > CHUNK_SIZE / 4) {
+        return this->_arena->_allocate_chunk(_size, _alignment);
+    }
+    uintptr_t begin = ((uintptr_t)this->_cursor + _alignment - 1) & ~(uintptr_t)(_alignment - 1);
+    if (this->_cursor == nullptr || begin + _size > (uintptr_t)this->_end) {
+        this->_cursor = (char*)this->_arena->_allocate_chunk(CHUNK_SIZE, alignof(std::max_align_t));
+        this->_end = this->_cursor + CHUNK_SIZE;
+        begin = ((uintptr_t)this->_cursor + _alignment - 1) & ~(uintptr_t)(_alignment - 1);
+    }
+    this->_cursor = (char*)(begin + _size);
+    return (void*)begin;
+}
+
+/**
+ * 在内存池中构造一个对象，对象必须不需要析构，随着内存池的 clear 或析构一起释放
+ * @param _args 构造函数的参数
+ * @return 新对象的指针
+ */
+template<class ObjectType, class... Args>
+ObjectType *NodeArena::Local::create(Args &&... _args) {
+    static_assert(std::is_trivially_destructible<ObjectType>::value, "NodeArena: objects must not need destruction");
+    void* memory = this->_allocate(sizeof(ObjectType), alignof(ObjectType));
+    return new (memory) ObjectType(std::forward<Args>(_args)...);
+}
+
+/**
+ * 在内存池中分配一个数组，数组的元素必须不需要析构(例如整数、指针)，初始值为_value
+ * @param _count 元素的个数
+ * @param _value 每一个元素的初始值
+ * @return 数组的起点，_count为0时返回空指针
+ */
+template<class ValueType>
+ValueType *NodeArena::Local::create_array(size_t _count, const ValueType &_value) {
+    static_assert(std::is_trivially_destructible<ValueType>::value, "NodeArena: array elements must not need destruction");
+    if (_count == 0) {
+        return nullptr;
+    }
+    ValueType* array = (ValueType*)this->_allocate(sizeof(ValueType) * _count, alignof(ValueType));
+    std::uninitialized_fill(array, array + _count, _value);
+    return array;
+}
+
+#endif //DESITIONTREE_NODE_ARENA_H
@@ -6,16 +6,23 @@
 #define DESITIONTREE_NODE_BASE_H
 
 // 决策树基类，所有决策树节点都必须集成本基类进行设计
+// 节点存放在决策树的内存池(NodeArena)中，不会被单独析构，因此节点只能包含不需要析构的成员，也不需要虚析构函数
 class NodeBase {
 protected:
     bool _is_result{}; // 标记当前节点是否是最终节点
+    bool _is_threshold{}; // 标记当前节点是否是数值型属性的阈值决策节点
 public:
-    virtual ~NodeBase();
     /**
      * 返回当前节点是否是一个结果类型的节点
      * @return 一个布尔值，表示当前的节点是否是一个结果类型的节点
      */
     inline bool is_result() const;
+
+    /**
+     * 返回当前节点是否是一个阈值决策节点(ThresholdNode)
+     * @return 一个布尔值，表示当前的节点是否是一个阈值决策节点
+     */
+    inline bool is_threshold() const;
 };
 
 /**
@@ -26,7 +33,12 @@ bool NodeBase::is_result() const {
     return this->_is_result;
 }
 
-NodeBase::~NodeBase() = default;
-
+/**
+ * 返回当前节点是否是一个阈值决策节点(ThresholdNode)
+ * @return 一个布尔值，表示当前的节点是否是一个阈值决策节点
+ */
+bool NodeBase::is_threshold() const {
+    return this->_is_threshold;
+}
 
 #endif //DESITIONTREE_NODE_BASE_H
@@ -0,0 +1,484 @@
+//
+// Created by wangsy on 2026/10/18.
+//
+
+#ifndef DESITIONTREE_RANDOM_FOREST_H
+#define DESITIONTREE_RANDOM_FOREST_H
+
+#include "decision_tree.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+/**
+ * 随机森林，由多棵在同一个编码后的数据集上训练的决策树组成，预测时按照多数投票给出结果
+ *
+ * <p>每一棵树的训练方式</p>
+ * <ul>
+ *  <li>从数据集中有放回地抽取与数据集行数相同的行(自助采样)，只保存行下标，所有的树共用同一个只读的数据集</li>
+ *  <li>每个节点只在随机选取的 max_features 个候选属性中选择划分，见 DecisionTree::set_max_features</li>
+ *  <li>训练完成后立即编译为 CompiledTree 并释放节点，森林中只保存编译后的决策树</li>
+ * </ul>
+ * 各棵树相互独立，在线程池中并行训练；每一棵树的种子只由森林的种子与树的编号决定，训练的结果与线程数无关
+ *
+ * 批量预测按照树的顺序进行：每次取出一组行，依次用每一棵树预测整组，票数累加在组内的计票缓冲区中，
+ * 一棵树的节点在处理整组期间一直留在缓存中，不会因为逐行遍历所有的树而被反复换出
+ */
+template<class AttributeType, class ResultType>
+class RandomForest {
+private:
+    std::vector<CompiledTree<ResultType>> _trees; // 编译后的每一棵树
+    std::vector<std::string> _attribute_names; // 每一列的属性名，下标为列下标
+    std::vector<Vocabulary<AttributeType>> _attribute_list; // 每一列的字典，所有的树共用同一套编码
+    std::vector<bool> _numeric_list; // 标记每一列是否为数值型
+    Vocabulary<ResultType> _result_list; // 结果的字典，投票按照结果的编码进行
+    std::shared_ptr<ThreadPool> _thread_pool; // 训练与批量预测时使用的线程池，为空时在当前线程中依次进行
+    size_t _tree_count; // 树的数量
+    size_t _max_features; // 每个节点的候选属性的个数，为0时使用属性个数的平方根
+    uint64_t _seed; // 随机数的种子
+    size_t _block_rows; // 批量预测时每一组的行数，为0时根据二级缓存的大小自动选择
+
+    /**
+     * 根据二级缓存的大小选择批量预测时每一组的行数，使组内的计票缓冲区、结果编码以及读取的列占用不超过二级缓存的一半，
+     * 另一半留给正在使用的树的节点
+     * @return 每一组的行数，是 CompiledTree::BLOCK_SIZE 的倍数
+     */
+    size_t _auto_block_rows() const;
+
+    /**
+     * 按照树的顺序预测一组行
+     * @param _columns 按照列下标排列的列指针
+     * @param _begin 组内第一行的行下标
+     * @param _row_count 组内的行数
+     * @param _results 写入每一行的预测结果编码的数组，与_columns使用相同的行下标
+     */
+    void _predict_block(const uint32_t* const* _columns, size_t _begin, size_t _row_count, uint32_t* _results) const;
+
+public:
+    /**
+     * 随机森林的构造函数，默认训练100棵树，候选属性的个数为属性个数的平方根
+     */
+    RandomForest();
+
+    /**
+     * 设置树的数量
+     * @param _tree_count 树的数量
+     */
+    void set_tree_count(size_t _tree_count);
+
+    /**
+     * 设置每个节点随机选取的候选属性的个数
+     * @param _max_features 候选属性的个数，为0时使用属性个数的平方根(至少为1)
+     */
+    void set_max_features(size_t _max_features);
+
+    /**
+     * 设置随机数的种子，相同的种子与数据得到相同的森林
+     * @param _seed 种子
+     */
+    void set_seed(uint64_t _seed);
+
+    /**
+     * 设置训练与批量预测时使用的线程数，训练时各棵树作为任务并行训练，批量预测时各组行并行预测
+     * @param _thread_count 参与训练的线程总数，为1时在当前线程中依次训练，为0时使用硬件支持的线程数
+     */
+    void set_thread_count(size_t _thread_count);
+
+    /**
+     * 设置批量预测时每一组的行数
+     * @param _block_rows 每一组的行数，为0时根据二级缓存的大小自动选择
+     */
+    void set_block_rows(size_t _block_rows);
+
+    /**
+     * 获取训练时使用的线程数
+     * @return 参与训练的线程总数
+     */
+    size_t thread_count() const;
+
+    /**
+     * 清空所有的树
+     */
+    void clear();
+
+    /**
+     * 对随机森林进行训练，原始数据只编码一次，所有的树共用编码后的数据集
+     * @param _train_x 一个map<string, vector<AttributeType>>，表示训练数据集，string代表属性的名字，相同下标的代表同一个数据
+     * @param _train_y 一个一维数组，表示_train_x的每一行的结果
+     * @param _attribute_name_list 一个一维数组，表示_train_x的每一列所属的属性名
+     */
+    void fit(const std::map<std::string, std::vector<AttributeType>>& _train_x, const std::vector<ResultType>& _train_y,
+             const std::vector<std::string>& _attribute_name_list);
+
+    /**
+     * 在编码后的数据集上对随机森林进行训练，会清空之前训练得到的所有树
+     * @param _dataset 编码后的训练数据集，训练过程中只读
+     * @param _criterion 划分准则的标签，见 split_criterion.h
+     */
+    template<class Criterion>
+    void fit(const Dataset<AttributeType, ResultType>& _dataset, const Criterion& _criterion);
+
+    /**
+     * 获取训练得到的树的数量
+     * @return 树的数量，没有训练时为0
+     */
+    size_t size() const;
+
+    /**
+     * 获取编译后的某一棵树
+     * @param _index 树的编号
+     * @return 编译后的决策树，叶子的结果编码与 result_vocabulary 一致
+     */
+    const CompiledTree<ResultType>& tree(size_t _index) const;
+
+    /**
+     * 获取结果的字典
+     * @return 结果的字典
+     */
+    const Vocabulary<ResultType>& result_vocabulary() const;
+
+    /**
+     * 使用训练时的字典对一行数据进行编码，编码后的数据按照列下标排列
+     * @param _test_x 用于预测的数据，一个map，从string映射到AttributeType
+     * @param _codes 编码的结果，缺失的属性以及训练时没有出现过的属性值编码为 CompiledTree::npos
+     */
+    void encode(const std::map<std::string, AttributeType>& _test_x, std::vector<uint32_t>& _codes) const;
+
+    /**
+     * 使用训练时的字典对某一列的一个值进行编码，数值型的列编码为所在分箱的编码
+     * @param _attribute_index 属性的列下标
+     * @param _value 属性值
+     * @return 属性值的编码，训练时没有出现过的属性值为 CompiledTree::npos
+     */
+    uint32_t encode(size_t _attribute_index, const AttributeType& _value) const;
+
+    /**
+     * 对编码后的一行数据进行预测，结果为所有能够给出预测的树中得票最多的结果，票数相同时选择编码较小的结果
+     * @param _row 按照列下标排列的属性值编码，可以通过 encode 得到
+     * @param _result 预测的结果，仅在返回true时有效
+     * @return 至少有一棵树能够给出预测时返回true
+     */
+    bool predict(const uint32_t* _row, ResultType& _result) const;
+
+    /**
+     * 对编码后的一批数据进行预测，数据按列存放，按照树的顺序逐组处理，各组在线程池中并行预测
+     * 结果与逐行调用 predict 相同
+     * @param _columns 按照列下标排列的列指针，_columns[feature][row] 为第row行在该列上的属性值编码
+     * @param _row_count 数据的行数
+     * @param _results 调用者提供的长度为_row_count的数组，写入每一行得票最多的结果编码，没有任何一棵树能够给出预测时为 npos
+     */
+    void predict(const uint32_t* const* _columns, size_t _row_count, uint32_t* _results) const;
+
+    /**
+     * 给出数据，使用当前的模型进行预测
+     * @param _test_x 用于预测的数据
+     * @param _test_y 预测的结果，直接追加到_test_y的末尾，没有任何一棵树能够给出预测时不追加
+     */
+    void transform(const std::map<std::string, AttributeType>& _test_x, std::vector<ResultType>& _test_y) const;
+};
+
+/**
+ * 随机森林的构造函数，默认训练100棵树，候选属性的个数为属性个数的平方根
+ */
+template<class AttributeType, class ResultType>
+RandomForest<AttributeType, ResultType>::RandomForest() {
+    this->_tree_count = 100;
+    this->_max_features = 0;
+    this->_seed = 0;
+    this->_block_rows = 0;
+}
+
+template<class AttributeType, class ResultType>
+void RandomForest<AttributeType, ResultType>::set_tree_count(size_t _tree_count) {
+    this->_tree_count = _tree_count;
+}
+
+template<class AttributeType, class ResultType>
+void RandomForest<AttributeType, ResultType>::set_max_features(size_t _max_features) {
+    this->_max_features = _max_features;
+}
+
+template<class AttributeType, class ResultType>
+void RandomForest<AttributeType, ResultType>::set_seed(uint64_t _seed) {
+    this->_seed = _seed;
+}
+
+/**
+ * 设置训练时使用的线程数，线程池由随机森林持有，直到下一次设置或随机森林析构
+ * @param _thread_count 参与训练的线程总数，为1时在当前线程中依次训练，为0时使用硬件支持的线程数
+ */
+template<class AttributeType, class ResultType>
+void RandomForest<AttributeType, ResultType>::set_thread_count(size_t _thread_count) {
+    if (_thread_count == 1) {
+        this->_thread_pool.reset();
+    } else {
+        this->_thread_pool = std::make_shared<ThreadPool>(_thread_count);
+    }
+}
+
+template<class AttributeType, class ResultType>
+void RandomForest<AttributeType, ResultType>::set_block_rows(size_t _block_rows) {
+    this->_block_rows = _block_rows;
+}
+
+template<class AttributeType, class ResultType>
+size_t RandomForest<AttributeType, ResultType>::thread_count() const {
+    return this->_thread_pool ? this->_thread_pool->thread_count() : 1;
+}
+
+template<class AttributeType, class ResultType>
+void RandomForest<AttributeType, ResultType>::clear() {
+    this->_trees.clear();
+}
+
+/**
+ * 对随机森林进行训练，原始数据只编码一次，所有的树共用编码后的数据集
+ * 使用信息增益作为划分准则
+ * @param _train_x 一个map<string, vector<AttributeType>>，表示训练数据集，string代表属性的名字，相同下标的代表同一个数据
+ * @param _train_y 一个一维数组，表示_train_x的每一行的结果
+ * @param _attribute_name_list 一个一维数组，表示_train_x的每一列所属的属性名
+ */
+template<class AttributeType, class ResultType>
+void RandomForest<AttributeType, ResultType>::fit(
+        const std::map<std::string, std::vector<AttributeType>> &_train_x, const std::vector<ResultType> &_train_y,
+        const std::vector<std::string> &_attribute_name_list) {
+    Dataset<AttributeType, ResultType> dataset(_train_x, _train_y, _attribute_name_list, this->_thread_pool.get());
+    this->fit(dataset, InformationGain());
+}
+
+/**
+ * 在编码后的数据集上对随机森林进行训练，会清空之前训练得到的所有树
+ * 每一棵树的种子先在当前线程中依次生成，再把各棵树作为任务提交到线程池，每个任务只持有自己的行下标与节点
+ * @param _dataset 编码后的训练数据集，训练过程中只读
+ * @param _criterion 划分准则的标签，见 split_criterion.h
+ */
+template<class AttributeType, class ResultType>
+template<class Criterion>
+void RandomForest<AttributeType, ResultType>::fit(const Dataset<AttributeType, ResultType> &_dataset,
+                                                  const Criterion &_criterion) {
+    this->clear();
+    this->_attribute_names.clear();
+    this->_attribute_list.clear();
+    this->_numeric_list.clear();
+    for(size_t index = 0; index < _dataset.attribute_count(); ++ index) {
+        this->_attribute_names.push_back(_dataset.attribute_name(index));
+        this->_attribute_list.push_back(_dataset.vocabulary(index));
+        this->_numeric_list.push_back(_dataset.is_numeric(index));
+    }
+    this->_result_list = _dataset.result_vocabulary();
+    if (_dataset.row_count() == 0 || _dataset.attribute_count() == 0) {
+        return;
+    }
+    size_t max_features = this->_max_features;
+    if (max_features == 0) {
+        max_features = std::max<size_t>(1, (size_t)std::sqrt((double)_dataset.attribute_count()));
+    }
+    std::vector<uint64_t> seeds(this->_tree_count);
+    std::mt19937_64 random(this->_seed);
+    for(uint64_t& seed: seeds) {
+        seed = random();
+    }
+    this->_trees.resize(this->_tree_count);
+    auto build = [&](size_t _index) {
+        // 自助采样，排序后按照行的顺序访问各列
+        std::mt19937_64 sample_random(seeds[_index]);
+        std::uniform_int_distribution<uint32_t> pick(0, (uint32_t)(_dataset.row_count() - 1));
+        std::vector<uint32_t> rows(_dataset.row_count());
+        for(uint32_t& row: rows) {
+            row = pick(sample_random);
+        }
+        std::sort(rows.begin(), rows.end());
+        DecisionTree<AttributeType, ResultType> tree;
+        tree.set_max_features(max_features, sample_random());
+        tree.fit(_dataset, _criterion, rows);
+        this->_trees[_index] = tree.compile();
+    };
+    if (this->_thread_pool) {
+        this->_thread_pool->parallel_for(0, this->_trees.size(), build);
+    } else {
+        for(size_t index = 0; index < this->_trees.size(); ++ index) {
+            build(index);
+        }
+    }
+}
+
+template<class AttributeType, class ResultType>
+size_t RandomForest<AttributeType, ResultType>::size() const {
+    return this->_trees.size();
+}
+
+template<class AttributeType, class ResultType>
+const CompiledTree<ResultType> &RandomForest<AttributeType, ResultType>::tree(size_t _index) const {
+    return this->_trees.at(_index);
+}
+
+template<class AttributeType, class ResultType>
+const Vocabulary<ResultType> &RandomForest<AttributeType, ResultType>::result_vocabulary() const {
+    return this->_result_list;
+}
+
+/**
+ * 使用训练时的字典对一行数据进行编码，编码后的数据按照列下标排列
+ * @param _test_x 用于预测的数据，一个map，从string映射到AttributeType
+ * @param _codes 编码的结果，缺失的属性以及训练时没有出现过的属性值编码为 CompiledTree::npos
+ */
+template<class AttributeType, class ResultType>
+void RandomForest<AttributeType, ResultType>::encode(const std::map<std::string, AttributeType> &_test_x,
+                                                     std::vector<uint32_t> &_codes) const {
+    _codes.assign(this->_attribute_names.size(), CompiledTree<ResultType>::npos);
+    for(size_t index = 0; index < this->_attribute_names.size(); ++ index) {
+        auto it = _test_x.find(this->_attribute_names[index]);
+        if (it != _test_x.end()) {
+            _codes[index] = this->encode(index, it->second);
+        }
+    }
+}
+
+/**
+ * 使用训练时的字典对某一列的一个值进行编码，数值型的列编码为所在分箱的编码
+ * @param _attribute_index 属性的列下标
+ * @param _value 属性值
+ * @return 属性值的编码，训练时没有出现过的属性值为 CompiledTree::npos
+ */
+template<class AttributeType, class ResultType>
+uint32_t RandomForest<AttributeType, ResultType>::encode(size_t _attribute_index, const AttributeType &_value) const {
+    const Vocabulary<AttributeType>& vocabulary = this->_attribute_list[_attribute_index];
+    if (this->_numeric_list[_attribute_index]) {
+        return _dataset_self_use::find_bin(vocabulary.values(), _value);
+    }
+    uint32_t code = CompiledTree<ResultType>::npos;
+    vocabulary.find(_value, code);
+    return code;
+}
+
+/**
+ * 对编码后的一行数据进行预测，结果为所有能够给出预测的树中得票最多的结果，票数相同时选择编码较小的结果
+ * @param _row 按照列下标排列的属性值编码，可以通过 encode 得到
+ * @param _result 预测的结果，仅在返回true时有效
+ * @return 至少有一棵树能够给出预测时返回true
+ */
+template<class AttributeType, class ResultType>
+bool RandomForest<AttributeType, ResultType>::predict(const uint32_t *_row, ResultType &_result) const {
+    std::vector<uint32_t> votes(this->_result_list.size(), 0);
+    bool voted = false;
+    for(const CompiledTree<ResultType>& tree: this->_trees) {
+        uint32_t code = tree.predict(_row);
+        if (code != CompiledTree<ResultType>::npos) {
+            ++ votes[code];
+            voted = true;
+        }
+    }
+    if (!voted) {
+        return false;
+    }
+    _result = this->_result_list.value((uint32_t)(std::max_element(votes.begin(), votes.end()) - votes.begin()));
+    return true;
+}
+
+/**
+ * 对编码后的一批数据进行预测，数据按列存放，按照树的顺序逐组处理，各组在线程池中并行预测
+ * 结果与逐行调用 predict 相同
+ * @param _columns 按照列下标排列的列指针，_columns[feature][row] 为第row行在该列上的属性值编码
+ * @param _row_count 数据的行数
+ * @param _results 调用者提供的长度为_row_count的数组，写入每一行得票最多的结果编码，没有任何一棵树能够给出预测时为 npos
+ */
+template<class AttributeType, class ResultType>
+void RandomForest<AttributeType, ResultType>::predict(const uint32_t *const *_columns, size_t _row_count,
+                                                      uint32_t *_results) const {
+    const size_t block_rows = this->_block_rows != 0 ? this->_block_rows : this->_auto_block_rows();
+    const size_t block_count = (_row_count + block_rows - 1) / block_rows;
+    auto predict_block = [&](size_t _block) {
+        size_t begin = _block * block_rows;
+        this->_predict_block(_columns, begin, std::min(block_rows, _row_count - begin), _results);
+    };
+    if (this->_thread_pool && block_count > 1) {
+        this->_thread_pool->parallel_for(0, block_count, predict_block);
+    } else {
+        for(size_t block = 0; block < block_count; ++ block) {
+            predict_block(block);
+        }
+    }
+}
+
+/**
+ * 按照树的顺序预测一组行，每一棵树使用 CompiledTree 的批量预测处理整组，再把结果累加到组内的计票缓冲区
+ * @param _columns 按照列下标排列的列指针
+ * @param _begin 组内第一行的行下标
+ * @param _row_count 组内的行数
+ * @param _results 写入每一行的预测结果编码的数组，与_columns使用相同的行下标
+ */
+template<class AttributeType, class ResultType>
+void RandomForest<AttributeType, ResultType>::_predict_block(const uint32_t *const *_columns, size_t _begin,
+                                                             size_t _row_count, uint32_t *_results) const {
+    const uint32_t npos = CompiledTree<ResultType>::npos;
+    const size_t class_count = this->_result_list.size();
+    std::vector<const uint32_t*> columns(this->_attribute_names.size()); // 从组内第一行开始的列指针
+    for(size_t index = 0; index < columns.size(); ++ index) {
+        columns[index] = _columns[index] + _begin;
+    }
+    std::vector<uint32_t> votes(_row_count * class_count, 0); // 每一行在每一种结果上的票数
+    std::vector<uint32_t> codes(_row_count); // 一棵树对组内每一行的预测
+    for(const CompiledTree<ResultType>& tree: this->_trees) {
+        tree.predict(columns.data(), _row_count, codes.data());
+        for(size_t row = 0; row < _row_count; ++ row) {
+            if (codes[row] != npos) {
+                ++ votes[row * class_count + codes[row]];
+            }
+        }
+    }
+    for(size_t row = 0; row < _row_count; ++ row) {
+        const uint32_t* row_votes = votes.data() + row * class_count;
+        uint32_t best = npos;
+        uint32_t best_votes = 0;
+        for(uint32_t code = 0; code < class_count; ++ code) { // 票数相同时选择编码较小的结果
+            if (row_votes[code] > best_votes) {
+                best = code;
+                best_votes = row_votes[code];
+            }
+        }
+        _results[_begin + row] = best;
+    }
+}
+
+/**
+ * 根据二级缓存的大小选择批量预测时每一组的行数，使组内的计票缓冲区、结果编码以及读取的列占用不超过二级缓存的一半，
+ * 另一半留给正在使用的树的节点；无法获取缓存大小时按照256KB计算
+ * @return 每一组的行数，是 CompiledTree::BLOCK_SIZE 的倍数
+ */
+template<class AttributeType, class ResultType>
+size_t RandomForest<AttributeType, ResultType>::_auto_block_rows() const {
+    const size_t step = CompiledTree<ResultType>::BLOCK_SIZE;
+    long cache_size = -1;
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    cache_size = ::sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+    if (cache_size <= 0) {
+        cache_size = 256 << 10;
+    }
+    const size_t row_bytes = (this->_result_list.size() + 1 + this->_attribute_names.size()) * sizeof(uint32_t);
+    const size_t rows = (size_t)cache_size / 2 / row_bytes / step * step;
+    return std::min<size_t>(std::max(rows, step), 64 * step);
+}
+
+/**
+ * 给出数据，使用当前的模型进行预测
+ * @param _test_x 用于预测的数据
+ * @param _test_y 预测的结果，直接追加到_test_y的末尾，没有任何一棵树能够给出预测时不追加
+ */
+template<class AttributeType, class ResultType>
+void RandomForest<AttributeType, ResultType>::transform(const std::map<std::string, AttributeType> &_test_x,
+                                                        std::vector<ResultType> &_test_y) const {
+    std::vector<uint32_t> codes;
+    this->encode(_test_x, codes);
+    ResultType result;
+    if (this->predict(codes.data(), result)) {
+        _test_y.push_back(result);
+    }
+}
+
+#endif //DESITIONTREE_RANDOM_FOREST_H
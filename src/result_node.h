@@ -5,43 +5,52 @@
 #ifndef DESITIONTREE_RESULT_NODE_H
 #define DESITIONTREE_RESULT_NODE_H
 #include "node_base.h"
+#include "vocabulary.h"
+#include <cstdint>
 
 /**
  * 决策树结果节点，继承于NodeBase类，是决策树上的一类点
- * 结果的类型可以进行自定义
+ * 结果的类型可以进行自定义，节点中只记录结果的编码，原始的结果保存在决策树持有的结果字典中
  * @param ResultType: 结果的类型
  */
 template<class ResultType>
 class ResultNode: NodeBase {
 private:
-    ResultType _result;
+    const Vocabulary<ResultType>* _vocabulary; // 结果的字典
+    uint32_t _result_code; // 结果的编码
 public:
     /**
      * 用于获取点的信息的函数
      * @return 返回结果点中存储的信息
      */
     ResultType get_result();
+
     /**
-     * 构造函数，用于创建一个结果点，创建过程中，需要给出一个 ResultType 类型的数据，作为当前点所代表的结果
-     * 该结果会被写入到当前点的 _result 成员变量中，写入后不可更改，仅可使用 get_result 函数进行访问
-     * @param _result 当前点所代表的结果
+     * 获取结果的编码，编码即结果在结果字典中的下标
+     * @return 结果的编码
      */
-    explicit ResultNode(ResultType _result);
+    uint32_t get_result_code() const;
+
     /**
-     * 析够函数，本节点不需要析构(使用默认的即可)，但是需要重写父类的无参析构函数
+     * 构造函数，用于创建一个结果点，创建过程中，需要给出结果的字典以及当前点所代表的结果的编码
+     * 写入后不可更改，仅可使用 get_result 函数进行访问
+     * @param _vocabulary 结果的字典，在节点被释放之前必须一直有效
+     * @param _result_code 当前点所代表的结果的编码，必须小于字典的大小
      */
-    ~ResultNode() override = default;
+    ResultNode(const Vocabulary<ResultType>* _vocabulary, uint32_t _result_code);
 };
 
 /**
- * 构造函数，用于创建一个结果点，创建过程中，需要给出一个 ResultType 类型的数据，作为当前点所代表的结果
- * 该结果会被写入到当前点的 _result 成员变量中，写入后不可更改，仅可使用 get_result 函数进行访问
- * @param _result 当前点所代表的结果
+ * 构造函数，用于创建一个结果点，创建过程中，需要给出结果的字典以及当前点所代表的结果的编码
+ * 写入后不可更改，仅可使用 get_result 函数进行访问
+ * @param _vocabulary 结果的字典，在节点被释放之前必须一直有效
+ * @param _result_code 当前点所代表的结果的编码，必须小于字典的大小
  */
 template<class ResultType>
-ResultNode<ResultType>::ResultNode(ResultType _result) {
+ResultNode<ResultType>::ResultNode(const Vocabulary<ResultType> *_vocabulary, uint32_t _result_code) {
     this->_is_result = true; // 标记当前点是结果点
-    this->_result = _result;
+    this->_vocabulary = _vocabulary;
+    this->_result_code = _result_code;
 }
 
 /**
@@ -50,7 +59,12 @@ ResultNode<ResultType>::ResultNode(ResultType _result) {
  */
 template<class ResultType>
 ResultType ResultNode<ResultType>::get_result() {
-    return this->_result;
+    return this->_vocabulary->value(this->_result_code);
+}
+
+template<class ResultType>
+uint32_t ResultNode<ResultType>::get_result_code() const {
+    return this->_result_code;
 }
 
 
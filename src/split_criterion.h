@@ -0,0 +1,81 @@
+//
+// Created by wangsy on 2026/10/18.
+//
+
+#ifndef DESITIONTREE_SPLIT_CRITERION_H
+#define DESITIONTREE_SPLIT_CRITERION_H
+
+#include "histogram.h"
+
+/**
+ * 划分准则，每一种准则都是一个策略类型，在编译期作为模板参数(或标签)传入，建树过程中不再进行字符串比较
+ * 每一种准则都必须提供：
+ * <ul>
+ *  <li>static double score(const Histogram&) 在直方图上计算一个属性的评分，评分越小越好</li>
+ *  <li>static const char* name() 准则的名称，与 decision_tree.h 中 GAIN、GAIN_RATIO、GINI_INDEX 的取值一致</li>
+ * </ul>
+ */
+
+/**
+ * 信息增益(ID3)，由于划分前的信息熵固定，信息增益最大等价于条件熵最小，因此直接使用条件熵作为评分
+ */
+struct InformationGain {
+    static double score(const Histogram& _histogram) {
+        return _histogram.conditional_entropy();
+    }
+
+    static const char* name() {
+        return "KILC";
+    }
+};
+
+/**
+ * 增益率(C4.5)，信息增益除以属性本身的熵，用于抑制取值较多的属性
+ * 评分为增益率的相反数；属性只有一种取值(固有值为0)时无法带来任何信息，评分为0
+ */
+struct GainRatio {
+    static double score(const Histogram& _histogram) {
+        double split_information = _histogram.split_information();
+        if (split_information <= 0.0) {
+            return 0.0;
+        }
+        return -(_histogram.entropy() - _histogram.conditional_entropy()) / split_information;
+    }
+
+    static const char* name() {
+        return "GAIN_RATIO";
+    }
+};
+
+/**
+ * 基尼指数(CART)，Gini(X) = sum_v (N_v / N) * (1 - sum_c (n_vc / N_v)^2) = (N - sum_v (sum_c n_vc^2) / N_v) / N
+ * 只需要整数的乘法与加法以及每一种属性值一次除法，不需要计算对数，适合作为大规模训练的默认准则
+ */
+struct GiniIndex {
+    static double score(const Histogram& _histogram) {
+        if (_histogram.total() == 0) {
+            return 0.0;
+        }
+        double purity = 0.0;
+        for(size_t value = 0; value < _histogram.value_count(); ++ value) {
+            uint32_t value_total = _histogram.value_total(value);
+            if (value_total == 0) {
+                continue;
+            }
+            const uint32_t* row = _histogram.row(value);
+            uint64_t square_sum = 0;
+            for(size_t cls = 0; cls < _histogram.class_count(); ++ cls) {
+                square_sum += (uint64_t)row[cls] * row[cls];
+            }
+            purity += (double)square_sum / value_total;
+        }
+        double total = (double)_histogram.total();
+        return (total - purity) / total;
+    }
+
+    static const char* name() {
+        return "GINI_INDEX";
+    }
+};
+
+#endif //DESITIONTREE_SPLIT_CRITERION_H
@@ -0,0 +1,420 @@
+//
+// Created by wangsy on 2026/10/18.
+//
+
+#ifndef DESITIONTREE_THREAD_POOL_H
+#define DESITIONTREE_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * 固定大小的任务窃取(work-stealing)线程池，线程在构造时创建，在析构时回收
+ *
+ * <p>每个工作线程都拥有一个自己的任务队列：</p>
+ * <ul>
+ *  <li>工作线程提交的任务放入自己队列的尾部，并且优先从尾部取出任务执行(后进先出，保证局部性)</li>
+ *  <li>自己的队列为空时，从其他线程队列的头部窃取任务(先进先出，窃取到的往往是较大的任务)</li>
+ *  <li>不属于线程池的线程提交的任务放入一个公共队列，所有工作线程都会从中领取任务</li>
+ * </ul>
+ * 等待任务完成的线程(TaskGroup::wait)先继续执行队列中的任务，所有队列都为空时才会休眠，
+ * 因此任务中可以嵌套地提交任务或调用 parallel_for，参与计算的线程总数始终不超过 thread_count()
+ */
+class ThreadPool {
+private:
+    /**
+     * 一个任务队列及保护它的锁
+     */
+    struct TaskQueue {
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+    };
+
+    std::vector<std::thread> _workers; // 工作线程
+    std::vector<std::unique_ptr<TaskQueue>> _queues; // 每个工作线程的任务队列，最后一个为公共队列
+    std::mutex _mutex; // 用于工作线程的休眠与唤醒
+    std::condition_variable _condition; // 用于唤醒工作线程
+    std::atomic<size_t> _pending; // 所有队列中尚未被领取的任务数
+    bool _stop; // 标记线程池是否正在析构
+
+    /**
+     * 获取当前线程在本线程池中对应的任务队列下标，不属于本线程池的线程对应公共队列
+     * @return 任务队列的下标
+     */
+    size_t _queue_index() const;
+
+    /**
+     * 提交一个任务，任务会被放入当前线程对应的队列中
+     * @param _task 需要执行的任务
+     */
+    void _push(std::function<void()> _task);
+
+    /**
+     * 从某一个任务队列中取出一个任务
+     * @param _index 任务队列的下标
+     * @param _from_back 为true时从尾部取出，否则从头部取出
+     * @param _task 取出的任务，仅在返回true时有效
+     * @return 队列不为空时返回true
+     */
+    bool _take(size_t _index, bool _from_back, std::function<void()>& _task);
+
+    /**
+     * 尝试领取并执行一个任务，依次查看自己的队列、公共队列以及其他线程的队列
+     * @return 如果执行了一个任务则返回true，所有队列都为空时返回false
+     */
+    bool _run_one();
+
+    /**
+     * 工作线程的主循环，不断领取任务执行，没有任务时休眠，直到线程池析构
+     * @param _index 工作线程的下标
+     */
+    void _work(size_t _index);
+
+public:
+    /**
+     * 一组任务，可以向其中提交任务并且等待它们全部完成
+     * 等待过程中当前线程会帮助执行线程池中的任务，因此可以在任务中嵌套使用
+     */
+    class TaskGroup {
+    private:
+        /**
+         * 一组任务的共享状态，由任务与 TaskGroup 共同持有
+         */
+        struct State {
+            std::atomic<size_t> unfinished {0}; // 尚未完成的任务数
+            std::mutex mutex; // 保护 exception，并且用于等待线程的休眠与唤醒
+            std::condition_variable condition; // 最后一个任务完成时唤醒等待的线程
+            std::exception_ptr exception; // 第一个抛出异常的任务的异常
+        };
+
+        ThreadPool* _pool; // 执行任务的线程池
+        std::shared_ptr<State> _state; // 共享状态
+
+        /**
+         * 等待所有已经提交的任务完成，不会抛出异常
+         */
+        void _wait_all();
+
+    public:
+        /**
+         * 构造一组任务
+         * @param _pool 执行任务的线程池，为空时所有任务都在提交时直接执行
+         */
+        explicit TaskGroup(ThreadPool* _pool);
+
+        /**
+         * 析构时会等待所有任务完成
+         */
+        ~TaskGroup();
+
+        /**
+         * 提交一个任务，任务抛出的异常会被保存下来，由 wait 重新抛出
+         * @param _task 需要执行的任务
+         */
+        void run(std::function<void()> _task);
+
+        /**
+         * 等待所有已经提交的任务完成，等待过程中会帮助执行线程池中的任务
+         * 有任务抛出了异常时，在所有任务完成后重新抛出第一个异常
+         */
+        void wait();
+    };
+
+    /**
+     * 构造一个线程池
+     * @param _thread_count 参与计算的线程总数(包括调用线程)，为0时使用硬件支持的线程数
+     */
+    explicit ThreadPool(size_t _thread_count);
+
+    /**
+     * 析构线程池，会等待所有工作线程退出
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * 获取参与计算的线程总数(包括调用线程)
+     * @return 线程总数
+     */
+    size_t thread_count() const;
+
+    /**
+     * 对[_begin, _end)中的每一个下标并行地执行_body，所有下标执行完毕后返回
+     * 调用线程也会参与计算，下标按照先到先得的方式分配给各个线程
+     * @param _begin 起始下标
+     * @param _end 结束下标(不包含)
+     * @param _body 对每一个下标执行的函数，不同下标可能在不同线程中同时执行
+     */
+    void parallel_for(size_t _begin, size_t _end, const std::function<void(size_t)>& _body);
+};
+
+namespace _thread_pool_self_use {
+    /**
+     * 当前线程所属的线程池以及在其中的下标，不属于任何线程池时为空
+     */
+    struct WorkerIdentity {
+        const ThreadPool* pool;
+        size_t index;
+    };
+
+    inline WorkerIdentity& current_worker() {
+        thread_local WorkerIdentity identity {nullptr, 0};
+        return identity;
+    }
+}
+
+/**
+ * 构造一个线程池
+ * @param _thread_count 参与计算的线程总数(包括调用线程)，为0时使用硬件支持的线程数
+ */
+inline ThreadPool::ThreadPool(size_t _thread_count) {
+    this->_stop = false;
+    this->_pending = 0;
+    if (_thread_count == 0) {
+        _thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for(size_t i = 0; i < _thread_count; ++ i) { // _thread_count - 1 个工作线程的队列以及一个公共队列
+        this->_queues.emplace_back(new TaskQueue());
+    }
+    for(size_t i = 0; i + 1 < _thread_count; ++ i) {
+        this->_workers.emplace_back(&ThreadPool::_work, this, i);
+    }
+}
+
+/**
+ * 析构线程池，会等待所有工作线程退出
+ */
+inline ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        this->_stop = true;
+    }
+    this->_condition.notify_all();
+    for(std::thread& worker: this->_workers) {
+        worker.join();
+    }
+}
+
+inline size_t ThreadPool::thread_count() const {
+    return this->_workers.size() + 1;
+}
+
+/**
+ * 获取当前线程在本线程池中对应的任务队列下标，不属于本线程池的线程对应公共队列
+ * @return 任务队列的下标
+ */
+inline size_t ThreadPool::_queue_index() const {
+    const _thread_pool_self_use::WorkerIdentity& identity = _thread_pool_self_use::current_worker();
+    if (identity.pool == this) {
+        return identity.index;
+    }
+    return this->_queues.size() - 1;
+}
+
+/**
+ * 提交一个任务，任务会被放入当前线程对应的队列中
+ * @param _task 需要执行的任务
+ */
+inline void ThreadPool::_push(std::function<void()> _task) {
+    TaskQueue& queue = *this->_queues[this->_queue_index()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(_task));
+    }
+    {
+        // 在锁内增加计数，保证正在准备休眠的工作线程不会错过这次唤醒
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        ++ this->_pending;
+    }
+    this->_condition.notify_one();
+}
+
+/**
+ * 从某一个任务队列中取出一个任务
+ * @param _index 任务队列的下标
+ * @param _from_back 为true时从尾部取出，否则从头部取出
+ * @param _task 取出的任务，仅在返回true时有效
+ * @return 队列不为空时返回true
+ */
+inline bool ThreadPool::_take(size_t _index, bool _from_back, std::function<void()> &_task) {
+    TaskQueue& queue = *this->_queues[_index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    if (_from_back) {
+        _task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+    } else {
+        _task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+    }
+    -- this->_pending;
+    return true;
+}
+
+/**
+ * 尝试领取并执行一个任务，依次查看自己的队列、公共队列以及其他线程的队列
+ * 自己的队列从尾部领取，其他队列从头部窃取
+ * @return 如果执行了一个任务则返回true，所有队列都为空时返回false
+ */
+inline bool ThreadPool::_run_one() {
+    if (this->_pending.load() == 0) {
+        return false;
+    }
+    const size_t self = this->_queue_index();
+    const size_t shared = this->_queues.size() - 1;
+    std::function<void()> task;
+    bool found = (self != shared && this->_take(self, true, task)) || this->_take(shared, false, task);
+    // 从自己的下一个工作线程开始，依次尝试窃取其他工作线程的任务
+    const size_t start = self == shared ? 0 : self + 1;
+    for(size_t offset = 0; !found && offset < shared; ++ offset) {
+        size_t index = (start + offset) % shared;
+        found = index != self && this->_take(index, false, task);
+    }
+    if (!found) {
+        return false;
+    }
+    task();
+    return true;
+}
+
+/**
+ * 工作线程的主循环，不断领取任务执行，没有任务时休眠，直到线程池析构
+ * @param _index 工作线程的下标
+ */
+inline void ThreadPool::_work(size_t _index) {
+    _thread_pool_self_use::current_worker() = {this, _index};
+    while (true) {
+        if (this->_run_one()) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(this->_mutex);
+        this->_condition.wait(lock, [this] { return this->_stop || this->_pending.load() > 0; });
+        if (this->_stop && this->_pending.load() == 0) { // 只有在析构且没有剩余任务时才会退出
+            return;
+        }
+    }
+}
+
+/**
+ * 对[_begin, _end)中的每一个下标并行地执行_body，所有下标执行完毕后返回
+ * 每个参与的线程都从一个共享的原子计数器中领取下标，调用线程在领取完所有下标后帮助执行其他任务，直到所有下标执行完毕
+ * @param _begin 起始下标
+ * @param _end 结束下标(不包含)
+ * @param _body 对每一个下标执行的函数，不同下标可能在不同线程中同时执行
+ */
+inline void ThreadPool::parallel_for(size_t _begin, size_t _end, const std::function<void(size_t)> &_body) {
+    if (_begin >= _end) {
+        return;
+    }
+    size_t helper_count = std::min(this->_workers.size(), _end - _begin - 1);
+    if (helper_count == 0) {
+        for(size_t index = _begin; index < _end; ++ index) {
+            _body(index);
+        }
+        return;
+    }
+    std::atomic<size_t> next(_begin);
+    auto run = [&next, _end, &_body]() {
+        size_t index;
+        while ((index = next.fetch_add(1)) < _end) {
+            _body(index);
+        }
+    };
+    TaskGroup group(this);
+    for(size_t i = 0; i < helper_count; ++ i) {
+        group.run(run);
+    }
+    run();
+    group.wait();
+}
+
+/**
+ * 构造一组任务
+ * @param _pool 执行任务的线程池，为空时所有任务都在提交时直接执行
+ */
+inline ThreadPool::TaskGroup::TaskGroup(ThreadPool *_pool) {
+    this->_pool = _pool;
+    this->_state = std::make_shared<State>();
+}
+
+/**
+ * 析构时会等待所有任务完成，析构时没有被 wait 取走的异常会被丢弃(例如调用线程本身正在因为异常退出)
+ */
+inline ThreadPool::TaskGroup::~TaskGroup() {
+    this->_wait_all();
+}
+
+/**
+ * 提交一个任务，任务抛出的异常会被保存下来，由 wait 重新抛出
+ * 无论任务是否抛出异常，完成后都会减少未完成的计数，异常不会离开工作线程
+ * @param _task 需要执行的任务
+ */
+inline void ThreadPool::TaskGroup::run(std::function<void()> _task) {
+    if (this->_pool == nullptr) {
+        _task();
+        return;
+    }
+    std::shared_ptr<State> state = this->_state;
+    ++ state->unfinished;
+    this->_pool->_push([state, _task]() {
+        try {
+            _task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (!state->exception) {
+                state->exception = std::current_exception();
+            }
+        }
+        // 在锁内减少计数，保证正在准备休眠的等待线程不会错过这次唤醒
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (-- state->unfinished == 0) {
+            state->condition.notify_all();
+        }
+    });
+}
+
+/**
+ * 等待所有已经提交的任务完成，不会抛出异常
+ * 先帮助执行线程池中的任务，所有队列都为空时说明剩下的任务都正在其他线程中执行，此时休眠直到最后一个任务完成
+ * 提交任务的线程在等待时总会先执行自己队列中的任务，因此休眠不会使任何任务无人执行
+ */
+inline void ThreadPool::TaskGroup::_wait_all() {
+    while (this->_state->unfinished.load() > 0) {
+        if (this->_pool->_run_one()) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(this->_state->mutex);
+        this->_state->condition.wait(lock, [this] { return this->_state->unfinished.load() == 0; });
+    }
+}
+
+/**
+ * 等待所有已经提交的任务完成，等待过程中会帮助执行线程池中的任务
+ * 有任务抛出了异常时，在所有任务完成后重新抛出第一个异常
+ */
+inline void ThreadPool::TaskGroup::wait() {
+    this->_wait_all();
+    std::exception_ptr exception;
+    {
+        std::lock_guard<std::mutex> lock(this->_state->mutex);
+        std::swap(exception, this->_state->exception);
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+#endif //DESITIONTREE_THREAD_POOL_H
@@ -0,0 +1,131 @@
+//
+// Created by wangsy on 2026/10/18.
+//
+
+#ifndef DESITIONTREE_THRESHOLD_NODE_H
+#define DESITIONTREE_THRESHOLD_NODE_H
+
+#include "node_base.h"
+#include "vocabulary.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * 阈值决策节点，用于数值型的属性(如：价格、传感器读数)，只有两个子节点
+ * 属性值不大于阈值(!(threshold < x))时选择左子节点，否则选择右子节点，AttributeType 必须重载小于比较符
+ *
+ * <p>阈值决策节点中主要包含以下数据成员</p>
+ * <ul>
+ *  <li>当前节点的属性在数据集中的列下标，属性名由决策树按照列下标保存，节点本身不需要析构</li>
+ *  <li>阈值所在分箱的编码，阈值为该列的字典(分箱的上界)中对应的值</li>
+ *  <li>左右两个子节点</li>
+ * </ul>
+ */
+template<class AttributeType>
+class ThresholdNode: NodeBase {
+private:
+    size_t _attribute_index; // 属性的列下标
+    const Vocabulary<AttributeType>* _vocabulary; // 当前列的字典，下标为分箱的编码，值为分箱的上界
+    uint32_t _threshold_code; // 阈值所在分箱的编码
+    NodeBase* _left; // 属性值不大于阈值时的选择
+    NodeBase* _right; // 属性值大于阈值时的选择
+public:
+    /**
+     * 阈值决策节点的构造函数
+     * @param _attribute_index 属性的列下标
+     * @param _vocabulary 当前列的字典，在节点被释放之前必须一直有效
+     * @param _threshold_code 阈值所在分箱的编码，阈值为字典中该编码对应的值
+     * @param _left 属性值不大于阈值时的选择
+     * @param _right 属性值大于阈值时的选择
+     */
+    ThresholdNode(size_t _attribute_index, const Vocabulary<AttributeType>* _vocabulary, uint32_t _threshold_code,
+                  NodeBase* _left, NodeBase* _right);
+
+    /**
+     * 用于进行一次决策，需要给出当前属性的值，将返回相应的决策结果
+     * @param _attribute 当前属性的值
+     * @return 决策的结果，一个节点类型的指针，指向下一个节点
+     */
+    NodeBase* do_decision(const AttributeType& _attribute) const;
+
+    /**
+     * 按照分箱编码进行一次决策
+     * @param _code 属性值所在分箱的编码
+     * @return 决策的结果，一个节点类型的指针，指向下一个节点
+     */
+    NodeBase* do_decision_code(uint32_t _code) const;
+
+    size_t get_attribute_index() const;
+
+    const AttributeType& get_threshold() const;
+
+    uint32_t get_threshold_code() const;
+
+    NodeBase* get_left() const;
+
+    NodeBase* get_right() const;
+};
+
+/**
+ * 阈值决策节点的构造函数
+ * @param _attribute_index 属性的列下标
+ * @param _vocabulary 当前列的字典，在节点被释放之前必须一直有效
+ * @param _threshold_code 阈值所在分箱的编码，阈值为字典中该编码对应的值
+ * @param _left 属性值不大于阈值时的选择
+ * @param _right 属性值大于阈值时的选择
+ */
+template<class AttributeType>
+ThresholdNode<AttributeType>::ThresholdNode(size_t _attribute_index, const Vocabulary<AttributeType> *_vocabulary,
+                                            uint32_t _threshold_code, NodeBase *_left, NodeBase *_right)
+        : _attribute_index(_attribute_index), _vocabulary(_vocabulary), _threshold_code(_threshold_code),
+          _left(_left), _right(_right) {
+    this->_is_result = false;
+    this->_is_threshold = true;
+}
+
+/**
+ * 用于进行一次决策，需要给出当前属性的值，将返回相应的决策结果
+ * @param _attribute 当前属性的值
+ * @return 决策的结果，一个节点类型的指针，指向下一个节点
+ */
+template<class AttributeType>
+NodeBase *ThresholdNode<AttributeType>::do_decision(const AttributeType &_attribute) const {
+    return this->get_threshold() < _attribute ? this->_right : this->_left;
+}
+
+/**
+ * 按照分箱编码进行一次决策，分箱编码的大小关系与属性值一致
+ * @param _code 属性值所在分箱的编码
+ * @return 决策的结果，一个节点类型的指针，指向下一个节点
+ */
+template<class AttributeType>
+NodeBase *ThresholdNode<AttributeType>::do_decision_code(uint32_t _code) const {
+    return this->_threshold_code < _code ? this->_right : this->_left;
+}
+
+template<class AttributeType>
+size_t ThresholdNode<AttributeType>::get_attribute_index() const {
+    return this->_attribute_index;
+}
+
+template<class AttributeType>
+const AttributeType &ThresholdNode<AttributeType>::get_threshold() const {
+    return this->_vocabulary->value(this->_threshold_code);
+}
+
+template<class AttributeType>
+uint32_t ThresholdNode<AttributeType>::get_threshold_code() const {
+    return this->_threshold_code;
+}
+
+template<class AttributeType>
+NodeBase *ThresholdNode<AttributeType>::get_left() const {
+    return this->_left;
+}
+
+template<class AttributeType>
+NodeBase *ThresholdNode<AttributeType>::get_right() const {
+    return this->_right;
+}
+
+#endif //DESITIONTREE_THRESHOLD_NODE_H
@@ -0,0 +1,158 @@
+//
+// Created by wangsy on 2026/10/18.
+//
+
+#ifndef DESITIONTREE_TRAIN_STATS_H
+#define DESITIONTREE_TRAIN_STATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * 训练过程的统计只在定义了 DESITIONTREE_ENABLE_STATS 时收集(例如 cmake -DDESITIONTREE_ENABLE_STATS=ON)
+ * 没有定义时 DESITIONTREE_STATS 中的语句不会被编译，训练过程没有任何额外的开销
+ */
+#ifdef DESITIONTREE_ENABLE_STATS
+#define DESITIONTREE_STATS(...) __VA_ARGS__
+#else
+#define DESITIONTREE_STATS(...)
+#endif
+
+/**
+ * 一次训练的统计结果，通过 DecisionTree::stats() 获取，没有开启统计时所有值都为0
+ *
+ * <p>各个阶段的时间是所有线程在该阶段所用时间之和，并行训练时可能大于训练的总时间</p>
+ * <ul>
+ *  <li>vocabulary_seconds: 对原始数据进行字典编码，只在使用原始数据训练时统计</li>
+ *  <li>histogram_seconds: 统计直方图以及通过相减得到直方图；数据较少的节点在统计的同时进行评分，也计入这一阶段</li>
+ *  <li>criterion_seconds: 在直方图上计算划分准则并选择划分</li>
+ *  <li>partition_seconds: 按照选择的划分重排行下标，或者将每一行移动到下一层的节点</li>
+ * </ul>
+ */
+struct TrainStats {
+    double vocabulary_seconds = 0;
+    double histogram_seconds = 0;
+    double criterion_seconds = 0;
+    double partition_seconds = 0;
+    uint64_t rows_scanned = 0; // 统计直方图与划分时读取的行数之和，同一行在每一个节点上各计一次
+    uint64_t bytes_copied = 0; // 编码与划分时写入的字节数
+    uint64_t node_count = 0; // 节点的总数，包括结果节点
+    uint64_t leaf_count = 0; // 结果节点的数量
+    size_t max_depth = 0; // 最深的结果节点的深度，只有一个结果节点时为0
+    size_t tree_bytes = 0; // 节点所在的内存池向系统申请的字节数，训练中只增不减，即训练过程的峰值
+};
+
+/**
+ * 训练过程中收集统计的计数器，所有计数都是原子的，可以在并行训练的各个线程中同时累加
+ */
+class TrainStatsCollector {
+public:
+    /**
+     * 训练的阶段
+     */
+    enum Phase {
+        VOCABULARY,
+        HISTOGRAM,
+        CRITERION,
+        PARTITION,
+        PHASE_COUNT
+    };
+
+    /**
+     * 在作用域内计时，析构时将经过的时间累加到对应的阶段
+     */
+    class Timer {
+    private:
+        TrainStatsCollector& _collector;
+        Phase _phase;
+        std::chrono::steady_clock::time_point _begin;
+
+    public:
+        Timer(TrainStatsCollector& _collector, Phase _phase);
+
+        Timer(const Timer&) = delete;
+
+        Timer& operator=(const Timer&) = delete;
+
+        ~Timer();
+    };
+
+private:
+    std::atomic<uint64_t> _nanoseconds[PHASE_COUNT]; // 每个阶段的纳秒数
+    std::atomic<uint64_t> _rows_scanned;
+    std::atomic<uint64_t> _bytes_copied;
+
+public:
+    TrainStatsCollector();
+
+    /**
+     * 清空所有计数
+     */
+    void reset();
+
+    void add_time(Phase _phase, uint64_t _nanoseconds);
+
+    void add_rows(uint64_t _rows);
+
+    void add_bytes(uint64_t _bytes);
+
+    /**
+     * 将计数写入统计结果，节点的数量、深度与内存由决策树在训练结束后填写
+     * @param _stats 统计结果
+     */
+    void collect(TrainStats& _stats) const;
+};
+
+inline TrainStatsCollector::Timer::Timer(TrainStatsCollector &_collector, Phase _phase)
+        : _collector(_collector), _phase(_phase), _begin(std::chrono::steady_clock::now()) {
+}
+
+inline TrainStatsCollector::Timer::~Timer() {
+    auto elapsed = std::chrono::steady_clock::now() - this->_begin;
+    this->_collector.add_time(this->_phase,
+                              (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+inline TrainStatsCollector::TrainStatsCollector() {
+    this->reset();
+}
+
+/**
+ * 清空所有计数
+ */
+inline void TrainStatsCollector::reset() {
+    for(std::atomic<uint64_t>& nanoseconds: this->_nanoseconds) {
+        nanoseconds.store(0, std::memory_order_relaxed);
+    }
+    this->_rows_scanned.store(0, std::memory_order_relaxed);
+    this->_bytes_copied.store(0, std::memory_order_relaxed);
+}
+
+inline void TrainStatsCollector::add_time(Phase _phase, uint64_t _nanoseconds) {
+    this->_nanoseconds[_phase].fetch_add(_nanoseconds, std::memory_order_relaxed);
+}
+
+inline void TrainStatsCollector::add_rows(uint64_t _rows) {
+    this->_rows_scanned.fetch_add(_rows, std::memory_order_relaxed);
+}
+
+inline void TrainStatsCollector::add_bytes(uint64_t _bytes) {
+    this->_bytes_copied.fetch_add(_bytes, std::memory_order_relaxed);
+}
+
+/**
+ * 将计数写入统计结果，节点的数量、深度与内存由决策树在训练结束后填写
+ * @param _stats 统计结果
+ */
+inline void TrainStatsCollector::collect(TrainStats &_stats) const {
+    _stats.vocabulary_seconds = this->_nanoseconds[VOCABULARY].load(std::memory_order_relaxed) * 1e-9;
+    _stats.histogram_seconds = this->_nanoseconds[HISTOGRAM].load(std::memory_order_relaxed) * 1e-9;
+    _stats.criterion_seconds = this->_nanoseconds[CRITERION].load(std::memory_order_relaxed) * 1e-9;
+    _stats.partition_seconds = this->_nanoseconds[PARTITION].load(std::memory_order_relaxed) * 1e-9;
+    _stats.rows_scanned = this->_rows_scanned.load(std::memory_order_relaxed);
+    _stats.bytes_copied = this->_bytes_copied.load(std::memory_order_relaxed);
+}
+
+#endif //DESITIONTREE_TRAIN_STATS_H
@@ -0,0 +1,638 @@
+//
+// Created by wangsy on 2026/10/18.
+//
+
+#ifndef DESITIONTREE_TREE_MODEL_H
+#define DESITIONTREE_TREE_MODEL_H
+
+#include "compiled_tree.h"
+#include "dataset.h"
+#include "mapped_file.h"
+#include "vocabulary.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace _tree_model_self_use {
+
+    /**
+     * 判断当前机器是否为小端字节序，模型文件统一使用小端字节序
+     * @return 小端字节序返回true
+     */
+    inline bool little_endian() {
+        const uint16_t probe = 1;
+        return *(const uint8_t*)&probe == 1;
+    }
+
+    /**
+     * 以小端字节序追加一个整数或浮点数
+     * @param _out 输出的缓冲区
+     * @param _value 需要追加的值
+     */
+    template<class ValueType>
+    void put(std::string& _out, const ValueType& _value) {
+        char bytes[sizeof(ValueType)];
+        std::memcpy(bytes, &_value, sizeof(ValueType));
+        if (!little_endian()) {
+            std::reverse(bytes, bytes + sizeof(ValueType));
+        }
+        _out.append(bytes, sizeof(ValueType));
+    }
+
+    /**
+     * 以小端字节序读取一个整数或浮点数
+     * @param _data 数据的起点
+     * @return 读取的值
+     */
+    template<class ValueType>
+    ValueType get(const char* _data) {
+        char bytes[sizeof(ValueType)];
+        std::memcpy(bytes, _data, sizeof(ValueType));
+        if (!little_endian()) {
+            std::reverse(bytes, bytes + sizeof(ValueType));
+        }
+        ValueType value;
+        std::memcpy(&value, bytes, sizeof(ValueType));
+        return value;
+    }
+
+    /**
+     * 用0将缓冲区填充到_alignment的整数倍
+     * @param _out 输出的缓冲区
+     * @param _alignment 对齐的字节数
+     */
+    inline void pad(std::string& _out, size_t _alignment) {
+        _out.append((_alignment - _out.size() % _alignment) % _alignment, '\0');
+    }
+
+    /**
+     * 值的编码方式，用于保存字典与结果，默认支持整数、浮点数以及std::string
+     * 其他类型可以特化该模板，提供 write(缓冲区, 值的数组) 与 read(起点, 字节数, 值的数组) 两个静态函数，读取失败时返回false
+     */
+    template<class ValueType, class = void>
+    struct ValueCodec;
+
+    /**
+     * 整数与浮点数：数量(uint64)之后依次存放每一个值
+     */
+    template<class ValueType>
+    struct ValueCodec<ValueType, typename std::enable_if<std::is_arithmetic<ValueType>::value>::type> {
+        static void write(std::string& _out, const std::vector<ValueType>& _values) {
+            put<uint64_t>(_out, _values.size());
+            for(const ValueType& value: _values) {
+                put<ValueType>(_out, value);
+            }
+        }
+
+        static bool read(const char* _data, size_t _size, std::vector<ValueType>& _values) {
+            if (_size < sizeof(uint64_t)) {
+                return false;
+            }
+            uint64_t count = get<uint64_t>(_data);
+            if (count > (_size - sizeof(uint64_t)) / sizeof(ValueType)) {
+                return false;
+            }
+            _values.resize((size_t)count);
+            for(size_t i = 0; i < _values.size(); ++ i) {
+                _values[i] = get<ValueType>(_data + sizeof(uint64_t) + i * sizeof(ValueType));
+            }
+            return true;
+        }
+    };
+
+    /**
+     * 字符串：数量(uint64)、count + 1 个结束位置(uint64)，之后是所有字符串连续存放的字节
+     */
+    template<>
+    struct ValueCodec<std::string> {
+        static void write(std::string& _out, const std::vector<std::string>& _values) {
+            put<uint64_t>(_out, _values.size());
+            uint64_t end = 0;
+            put<uint64_t>(_out, end);
+            for(const std::string& value: _values) {
+                end += value.size();
+                put<uint64_t>(_out, end);
+            }
+            for(const std::string& value: _values) {
+                _out.append(value);
+            }
+        }
+
+        static bool read(const char* _data, size_t _size, std::vector<std::string>& _values) {
+            if (_size < sizeof(uint64_t)) {
+                return false;
+            }
+            uint64_t count = get<uint64_t>(_data);
+            // 数量与 count + 1 个结束位置必须完整地位于数据中，即 (count + 2) * 8 <= _size
+            if (_size / sizeof(uint64_t) < 2 || count > _size / sizeof(uint64_t) - 2) {
+                return false;
+            }
+            const char* ends = _data + sizeof(uint64_t);
+            const char* bytes = ends + (count + 1) * sizeof(uint64_t);
+            const size_t byte_count = _size - (size_t)(bytes - _data);
+            _values.resize((size_t)count);
+            for(size_t i = 0; i < _values.size(); ++ i) {
+                uint64_t begin = get<uint64_t>(ends + i * sizeof(uint64_t));
+                uint64_t end = get<uint64_t>(ends + (i + 1) * sizeof(uint64_t));
+                if (begin > end || end > byte_count) {
+                    return false;
+                }
+                _values[i].assign(bytes + begin, (size_t)(end - begin));
+            }
+            return true;
+        }
+    };
+}
+
+/**
+ * 用于预测的决策树模型，包含编译后的决策树以及对输入进行编码所需的属性名、字典，可以保存为二进制文件并通过内存映射加载
+ *
+ * <p>模型文件使用小端字节序，所有段的起点都按照64字节对齐，依次为</p>
+ * <ul>
+ *  <li>文件头(64字节)：魔数 "DTMODEL\0"、版本、段的数量、文件的字节数、节点数、子节点表的长度、列数、结果的数量</li>
+ *  <li>段表：每一段的起点与字节数(各为uint64)</li>
+ *  <li>节点数组 feature、offset、child_count、threshold、children(uint32)，与 CompiledTree 的数组完全相同</li>
+ *  <li>属性名、每一列是否为数值型(uint8)、每一列的字典、结果的字典，值的编码方式见 ValueCodec</li>
+ * </ul>
+ * 在小端字节序的机器上加载时，节点数组直接指向映射的文件，不进行解析也不申请任何节点的内存，
+ * 同一个文件被多个进程加载时共享同一份页缓存；只有字典与结果需要被解码，其大小与节点数无关
+ */
+template<class AttributeType, class ResultType>
+class TreeModel {
+private:
+    CompiledTree<ResultType> _tree; // 编译后的决策树
+    std::vector<std::string> _attribute_names; // 每一列的属性名
+    std::vector<Vocabulary<AttributeType>> _vocabularies; // 每一列的字典，数值型的列为分箱的上界
+    std::vector<bool> _numeric; // 每一列是否为数值型
+
+    static const uint32_t VERSION = 1; // 文件格式的版本
+    static const size_t ALIGNMENT = 64; // 每一段的对齐字节数
+    static const size_t HEADER_SIZE = 64; // 文件头的字节数
+    static const uint32_t SECTION_COUNT = 9; // 段的数量
+
+public:
+    /**
+     * 构造一个空的模型，空模型的预测总是失败
+     */
+    TreeModel();
+
+    /**
+     * 根据编译后的决策树以及训练时的编码构造模型，通常通过 DecisionTree::export_model 得到
+     * @param _tree 编译后的决策树
+     * @param _attribute_names 每一列的属性名
+     * @param _vocabularies 每一列的字典
+     * @param _numeric 每一列是否为数值型
+     */
+    TreeModel(const CompiledTree<ResultType>& _tree, const std::vector<std::string>& _attribute_names,
+              const std::vector<Vocabulary<AttributeType>>& _vocabularies, const std::vector<bool>& _numeric);
+
+    /**
+     * 将模型保存为二进制文件，无法写入时抛出std::runtime_error
+     * @param _path 文件的路径
+     */
+    void save(const std::string& _path) const;
+
+    /**
+     * 通过内存映射加载模型文件，文件不完整、版本不支持或内容不一致时抛出std::runtime_error
+     * @param _path 文件的路径
+     * @return 加载得到的模型，节点数组直接指向映射的文件
+     */
+    static TreeModel load(const std::string& _path);
+
+    /**
+     * 获取编译后的决策树
+     * @return 编译后的决策树
+     */
+    const CompiledTree<ResultType>& tree() const;
+
+    size_t attribute_count() const;
+
+    const std::string& attribute_name(size_t _attribute_index) const;
+
+    /**
+     * 获取某一列的字典
+     * @param _attribute_index 属性的列下标
+     * @return 该列的字典，数值型的列为分箱的上界
+     */
+    const Vocabulary<AttributeType>& vocabulary(size_t _attribute_index) const;
+
+    bool is_numeric(size_t _attribute_index) const;
+
+    /**
+     * 使用训练时的字典对一行数据进行编码，编码后的数据按照列下标排列
+     * @param _test_x 用于预测的数据，一个map，从string映射到AttributeType
+     * @param _codes 编码的结果，缺失的属性以及训练时没有出现过的属性值编码为 CompiledTree::npos
+     */
+    void encode(const std::map<std::string, AttributeType>& _test_x, std::vector<uint32_t>& _codes) const;
+
+    /**
+     * 查找属性名对应的列下标，服务启动时对输入的每一列查找一次，之后直接按照列下标构造编码后的一行数据
+     * @param _attribute_name 属性名
+     * @param _attribute_index 属性的列下标，仅在返回true时有效
+     * @return 如果模型中存在该属性则返回true，否则返回false
+     */
+    bool find_attribute(const std::string& _attribute_name, size_t& _attribute_index) const;
+
+    /**
+     * 使用训练时的字典对某一列的一个值进行编码
+     * @param _attribute_index 属性的列下标
+     * @param _value 属性值
+     * @return 属性值的编码，训练时没有出现过的属性值为 CompiledTree::npos
+     */
+    uint32_t encode(size_t _attribute_index, const AttributeType& _value) const;
+
+    /**
+     * 对编码后的一行数据进行预测
+     * @param _row 按照列下标排列的属性值编码，未知的属性值使用 CompiledTree::npos 表示
+     * @param _result 预测的结果，仅在返回true时有效
+     * @return 能够给出预测时返回true
+     */
+    bool predict(const uint32_t* _row, ResultType& _result) const;
+
+    /**
+     * 对一行数据进行预测
+     * @param _test_x 用于预测的数据，一个map，从string映射到AttributeType
+     * @param _result 预测的结果，仅在返回true时有效
+     * @return 能够给出预测时返回true
+     */
+    bool predict(const std::map<std::string, AttributeType>& _test_x, ResultType& _result) const;
+};
+
+template<class AttributeType, class ResultType>
+const uint32_t TreeModel<AttributeType, ResultType>::VERSION;
+
+template<class AttributeType, class ResultType>
+const size_t TreeModel<AttributeType, ResultType>::ALIGNMENT;
+
+template<class AttributeType, class ResultType>
+const size_t TreeModel<AttributeType, ResultType>::HEADER_SIZE;
+
+template<class AttributeType, class ResultType>
+const uint32_t TreeModel<AttributeType, ResultType>::SECTION_COUNT;
+
+/**
+ * 构造一个空的模型，空模型的预测总是失败
+ */
+template<class AttributeType, class ResultType>
+TreeModel<AttributeType, ResultType>::TreeModel() = default;
+
+/**
+ * 根据编译后的决策树以及训练时的编码构造模型
+ * @param _tree 编译后的决策树
+ * @param _attribute_names 每一列的属性名
+ * @param _vocabularies 每一列的字典
+ * @param _numeric 每一列是否为数值型
+ */
+template<class AttributeType, class ResultType>
+TreeModel<AttributeType, ResultType>::TreeModel(const CompiledTree<ResultType> &_tree,
+                                                const std::vector<std::string> &_attribute_names,
+                                                const std::vector<Vocabulary<AttributeType>> &_vocabularies,
+                                                const std::vector<bool> &_numeric)
+        : _tree(_tree), _attribute_names(_attribute_names), _vocabularies(_vocabularies), _numeric(_numeric) {
+}
+
+/**
+ * 将模型保存为二进制文件，无法写入时抛出std::runtime_error
+ * 整个文件先在内存中生成，再一次性写入
+ * @param _path 文件的路径
+ */
+template<class AttributeType, class ResultType>
+void TreeModel<AttributeType, ResultType>::save(const std::string &_path) const {
+    using namespace _tree_model_self_use;
+    const typename CompiledTree<ResultType>::Arrays arrays = this->_tree.arrays();
+    std::string body; // 段表之后的所有内容，起点在文件中按照64字节对齐
+    std::vector<uint64_t> sections; // 每一段在 body 中的起点与字节数
+    auto begin_section = [&]() {
+        pad(body, ALIGNMENT);
+        sections.push_back(body.size());
+    };
+    auto end_section = [&]() {
+        sections.push_back(body.size() - sections.back());
+    };
+    const uint32_t* node_arrays[] = {arrays.feature, arrays.offset, arrays.child_count, arrays.threshold};
+    for(const uint32_t* node_array: node_arrays) {
+        begin_section();
+        for(size_t i = 0; i < arrays.node_count; ++ i) {
+            put<uint32_t>(body, node_array[i]);
+        }
+        end_section();
+    }
+    begin_section();
+    for(size_t i = 0; i < arrays.children_count; ++ i) {
+        put<uint32_t>(body, arrays.children[i]);
+    }
+    end_section();
+    begin_section();
+    ValueCodec<std::string>::write(body, this->_attribute_names);
+    end_section();
+    begin_section();
+    for(bool numeric: this->_numeric) {
+        put<uint8_t>(body, numeric ? 1 : 0);
+    }
+    end_section();
+    begin_section(); // 每一列的字典依次存放，每一个之前是它的字节数(uint64)，并且按照8字节对齐
+    for(const Vocabulary<AttributeType>& vocabulary: this->_vocabularies) {
+        pad(body, sizeof(uint64_t));
+        size_t size_position = body.size();
+        put<uint64_t>(body, 0);
+        ValueCodec<AttributeType>::write(body, vocabulary.values());
+        std::string size;
+        put<uint64_t>(size, body.size() - size_position - sizeof(uint64_t));
+        body.replace(size_position, sizeof(uint64_t), size);
+    }
+    end_section();
+    begin_section();
+    ValueCodec<ResultType>::write(body, this->_tree.leaf_values());
+    end_section();
+
+    std::string head;
+    head.append("DTMODEL", 8); // 包含结尾的 '\0'
+    put<uint32_t>(head, VERSION);
+    put<uint32_t>(head, SECTION_COUNT);
+    const size_t table_size = (SECTION_COUNT * 2 * sizeof(uint64_t) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    const uint64_t body_offset = HEADER_SIZE + table_size;
+    put<uint64_t>(head, body_offset + body.size());
+    put<uint32_t>(head, (uint32_t)arrays.node_count);
+    put<uint32_t>(head, (uint32_t)arrays.children_count);
+    put<uint32_t>(head, (uint32_t)this->_attribute_names.size());
+    put<uint32_t>(head, (uint32_t)this->_tree.leaf_values().size());
+    pad(head, HEADER_SIZE);
+    for(size_t i = 0; i < sections.size(); i += 2) {
+        put<uint64_t>(head, body_offset + sections[i]);
+        put<uint64_t>(head, sections[i + 1]);
+    }
+    pad(head, ALIGNMENT);
+
+    std::ofstream file(_path, std::ios::binary | std::ios::trunc);
+    file.write(head.data(), (std::streamsize)head.size());
+    file.write(body.data(), (std::streamsize)body.size());
+    if (!file) {
+        throw std::runtime_error("TreeModel: cannot write '" + _path + "'");
+    }
+}
+
+/**
+ * 通过内存映射加载模型文件，文件不完整、版本不支持或内容不一致时抛出std::runtime_error
+ * 小端字节序的机器上节点数组直接指向映射的文件，映射随着模型(以及它的副本)一起释放；
+ * 大端字节序的机器上节点数组会被转换到自己持有的内存中
+ * @param _path 文件的路径
+ * @return 加载得到的模型
+ */
+template<class AttributeType, class ResultType>
+TreeModel<AttributeType, ResultType> TreeModel<AttributeType, ResultType>::load(const std::string &_path) {
+    using namespace _tree_model_self_use;
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>(_path);
+    const char* data = (const char*)file->data();
+    const size_t size = file->size();
+    auto corrupted = [&_path](const std::string& _reason) {
+        return std::runtime_error("TreeModel: '" + _path + "' " + _reason);
+    };
+    if (size < HEADER_SIZE || std::memcmp(data, "DTMODEL", 8) != 0) {
+        throw corrupted("is not a model file");
+    }
+    if (get<uint32_t>(data + 8) != VERSION || get<uint32_t>(data + 12) != SECTION_COUNT) {
+        throw corrupted("has an unsupported version");
+    }
+    if (get<uint64_t>(data + 16) != size) {
+        throw corrupted("is truncated");
+    }
+    const size_t node_count = get<uint32_t>(data + 24);
+    const size_t children_count = get<uint32_t>(data + 28);
+    const size_t attribute_count = get<uint32_t>(data + 32);
+    const size_t leaf_count = get<uint32_t>(data + 36);
+    if (HEADER_SIZE + SECTION_COUNT * 2 * sizeof(uint64_t) > size) {
+        throw corrupted("is truncated");
+    }
+    std::vector<const char*> section_data;
+    std::vector<size_t> section_size;
+    for(size_t i = 0; i < SECTION_COUNT; ++ i) {
+        uint64_t offset = get<uint64_t>(data + HEADER_SIZE + i * 2 * sizeof(uint64_t));
+        uint64_t length = get<uint64_t>(data + HEADER_SIZE + (i * 2 + 1) * sizeof(uint64_t));
+        if (offset % ALIGNMENT != 0 || offset > size || length > size - offset) {
+            throw corrupted("has an invalid section table");
+        }
+        section_data.push_back(data + offset);
+        section_size.push_back((size_t)length);
+    }
+    for(size_t i = 0; i < 4; ++ i) {
+        if (section_size[i] != node_count * sizeof(uint32_t)) {
+            throw corrupted("has inconsistent node arrays");
+        }
+    }
+    if (section_size[4] != children_count * sizeof(uint32_t) || section_size[6] != attribute_count) {
+        throw corrupted("has inconsistent node arrays");
+    }
+
+    TreeModel model;
+    typename CompiledTree<ResultType>::Arrays arrays {};
+    arrays.node_count = node_count;
+    arrays.children_count = children_count;
+    std::shared_ptr<const void> owner = file;
+    if (little_endian()) { // 直接使用映射的文件
+        arrays.feature = (const uint32_t*)section_data[0];
+        arrays.offset = (const uint32_t*)section_data[1];
+        arrays.child_count = (const uint32_t*)section_data[2];
+        arrays.threshold = (const uint32_t*)section_data[3];
+        arrays.children = (const uint32_t*)section_data[4];
+    } else { // 转换字节序后存放在自己持有的内存中
+        auto converted = std::make_shared<std::vector<std::vector<uint32_t>>>(5);
+        for(size_t i = 0; i < 5; ++ i) {
+            (*converted)[i].resize(section_size[i] / sizeof(uint32_t));
+            for(size_t j = 0; j < (*converted)[i].size(); ++ j) {
+                (*converted)[i][j] = get<uint32_t>(section_data[i] + j * sizeof(uint32_t));
+            }
+        }
+        arrays.feature = (*converted)[0].data();
+        arrays.offset = (*converted)[1].data();
+        arrays.child_count = (*converted)[2].data();
+        arrays.threshold = (*converted)[3].data();
+        arrays.children = (*converted)[4].data();
+        owner = converted;
+    }
+
+    if (!ValueCodec<std::string>::read(section_data[5], section_size[5], model._attribute_names)
+        || model._attribute_names.size() != attribute_count) {
+        throw corrupted("has invalid attribute names");
+    }
+    for(size_t i = 0; i < attribute_count; ++ i) {
+        model._numeric.push_back(section_data[6][i] != 0);
+    }
+    const char* cursor = section_data[7];
+    const char* end = section_data[7] + section_size[7];
+    model._vocabularies.resize(attribute_count);
+    for(size_t i = 0; i < attribute_count; ++ i) {
+        cursor += (size_t)(cursor - section_data[7]) % sizeof(uint64_t) == 0
+                ? 0 : sizeof(uint64_t) - (size_t)(cursor - section_data[7]) % sizeof(uint64_t);
+        if (cursor > end || (size_t)(end - cursor) < sizeof(uint64_t)) {
+            throw corrupted("has invalid vocabularies");
+        }
+        uint64_t length = get<uint64_t>(cursor);
+        cursor += sizeof(uint64_t);
+        std::vector<AttributeType> values;
+        if (length > (uint64_t)(end - cursor) || !ValueCodec<AttributeType>::read(cursor, (size_t)length, values)) {
+            throw corrupted("has invalid vocabularies");
+        }
+        for(const AttributeType& value: values) {
+            model._vocabularies[i].insert(value);
+        }
+        cursor += length;
+    }
+    std::vector<ResultType> leaf_values;
+    if (!ValueCodec<ResultType>::read(section_data[8], section_size[8], leaf_values) || leaf_values.size() != leaf_count) {
+        throw corrupted("has invalid results");
+    }
+
+    // 检查每个节点都只引用数组之内的位置，并且与对应列的字典一致，之后的预测不会再进行越界检查
+    // 节点按照深度优先的顺序存放，子节点的下标一定大于父节点，因此同时保证了树中没有环
+    for(size_t node = 0; node < node_count; ++ node) {
+        const uint32_t feature = arrays.feature[node];
+        const uint32_t offset = arrays.offset[node];
+        const uint32_t child_count = arrays.child_count[node];
+        const uint32_t threshold = arrays.threshold[node];
+        if (feature == CompiledTree<ResultType>::npos) {
+            if (offset >= leaf_count) {
+                throw corrupted("has a result node out of range");
+            }
+            continue;
+        }
+        if (feature >= attribute_count || (size_t)offset + child_count > children_count) {
+            throw corrupted("has a decision node out of range");
+        }
+        const size_t vocabulary_size = model._vocabularies[feature].size();
+        if (threshold != CompiledTree<ResultType>::npos
+            ? !model._numeric[feature] || child_count != 2 || threshold >= vocabulary_size
+            : child_count > vocabulary_size) {
+            throw corrupted("has a decision node that does not match its vocabulary");
+        }
+        for(size_t i = offset; i < (size_t)offset + child_count; ++ i) {
+            if (arrays.children[i] != CompiledTree<ResultType>::npos
+                && (arrays.children[i] >= node_count || arrays.children[i] <= node)) {
+                throw corrupted("has a child out of range");
+            }
+        }
+    }
+    model._tree.attach(arrays, owner);
+    model._tree.set_leaf_values(leaf_values);
+    return model;
+}
+
+template<class AttributeType, class ResultType>
+const CompiledTree<ResultType> &TreeModel<AttributeType, ResultType>::tree() const {
+    return this->_tree;
+}
+
+template<class AttributeType, class ResultType>
+size_t TreeModel<AttributeType, ResultType>::attribute_count() const {
+    return this->_attribute_names.size();
+}
+
+template<class AttributeType, class ResultType>
+const std::string &TreeModel<AttributeType, ResultType>::attribute_name(size_t _attribute_index) const {
+    return this->_attribute_names[_attribute_index];
+}
+
+/**
+ * 获取某一列的字典
+ * @param _attribute_index 属性的列下标
+ * @return 该列的字典，数值型的列为分箱的上界
+ */
+template<class AttributeType, class ResultType>
+const Vocabulary<AttributeType> &TreeModel<AttributeType, ResultType>::vocabulary(size_t _attribute_index) const {
+    return this->_vocabularies[_attribute_index];
+}
+
+template<class AttributeType, class ResultType>
+bool TreeModel<AttributeType, ResultType>::is_numeric(size_t _attribute_index) const {
+    return this->_numeric[_attribute_index];
+}
+
+/**
+ * 使用训练时的字典对一行数据进行编码，编码后的数据按照列下标排列
+ * @param _test_x 用于预测的数据，一个map，从string映射到AttributeType
+ * @param _codes 编码的结果，缺失的属性以及训练时没有出现过的属性值编码为 CompiledTree::npos
+ */
+template<class AttributeType, class ResultType>
+void TreeModel<AttributeType, ResultType>::encode(const std::map<std::string, AttributeType> &_test_x,
+                                                  std::vector<uint32_t> &_codes) const {
+    _codes.assign(this->_attribute_names.size(), CompiledTree<ResultType>::npos);
+    for(size_t index = 0; index < this->_attribute_names.size(); ++ index) {
+        auto it = _test_x.find(this->_attribute_names[index]);
+        if (it != _test_x.end()) {
+            _codes[index] = this->encode(index, it->second);
+        }
+    }
+}
+
+/**
+ * 查找属性名对应的列下标，服务启动时对输入的每一列查找一次，之后直接按照列下标构造编码后的一行数据
+ * @param _attribute_name 属性名
+ * @param _attribute_index 属性的列下标，仅在返回true时有效
+ * @return 如果模型中存在该属性则返回true，否则返回false
+ */
+template<class AttributeType, class ResultType>
+bool TreeModel<AttributeType, ResultType>::find_attribute(const std::string &_attribute_name,
+                                                          size_t &_attribute_index) const {
+    for(size_t index = 0; index < this->_attribute_names.size(); ++ index) {
+        if (this->_attribute_names[index] == _attribute_name) {
+            _attribute_index = index;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * 使用训练时的字典对某一列的一个值进行编码，数值型的列编码为所在分箱的编码
+ * @param _attribute_index 属性的列下标
+ * @param _value 属性值
+ * @return 属性值的编码，训练时没有出现过的属性值为 CompiledTree::npos
+ */
+template<class AttributeType, class ResultType>
+uint32_t TreeModel<AttributeType, ResultType>::encode(size_t _attribute_index, const AttributeType &_value) const {
+    const Vocabulary<AttributeType>& vocabulary = this->_vocabularies[_attribute_index];
+    if (this->_numeric[_attribute_index]) {
+        return _dataset_self_use::find_bin(vocabulary.values(), _value);
+    }
+    uint32_t code = CompiledTree<ResultType>::npos;
+    vocabulary.find(_value, code);
+    return code;
+}
+
+/**
+ * 对编码后的一行数据进行预测
+ * @param _row 按照列下标排列的属性值编码，未知的属性值使用 CompiledTree::npos 表示
+ * @param _result 预测的结果，仅在返回true时有效
+ * @return 能够给出预测时返回true
+ */
+template<class AttributeType, class ResultType>
+bool TreeModel<AttributeType, ResultType>::predict(const uint32_t *_row, ResultType &_result) const {
+    uint32_t code = this->_tree.predict(_row);
+    if (code == CompiledTree<ResultType>::npos) {
+        return false;
+    }
+    _result = this->_tree.result(code);
+    return true;
+}
+
+/**
+ * 对一行数据进行预测
+ * @param _test_x 用于预测的数据，一个map，从string映射到AttributeType
+ * @param _result 预测的结果，仅在返回true时有效
+ * @return 能够给出预测时返回true
+ */
+template<class AttributeType, class ResultType>
+bool TreeModel<AttributeType, ResultType>::predict(const std::map<std::string, AttributeType> &_test_x,
+                                                   ResultType &_result) const {
+    std::vector<uint32_t> codes;
+    this->encode(_test_x, codes);
+    return this->predict(codes.data(), _result);
+}
+
+#endif //DESITIONTREE_TREE_MODEL_H
@@ -0,0 +1,143 @@
+//
+// Created by wangsy on 2026/10/18.
+//
+
+#ifndef DESITIONTREE_VOCABULARY_H
+#define DESITIONTREE_VOCABULARY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace _vocabulary_self_use {
+
+    /**
+     * 判断一个类型是否可以使用 std::hash 进行哈希
+     */
+    template<class ValueType, class = void>
+    struct is_hashable : std::false_type {};
+
+    template<class ValueType>
+    struct is_hashable<ValueType, decltype(void(std::hash<ValueType>()(std::declval<const ValueType&>())))>
+            : std::true_type {};
+
+    /**
+     * 原始值到编码的映射表的类型，可以哈希的类型使用哈希表，只提供小于比较符的类型使用红黑树
+     */
+    template<class ValueType>
+    using code_map = typename std::conditional<is_hashable<ValueType>::value,
+            std::unordered_map<ValueType, uint32_t>,
+            std::map<ValueType, uint32_t>>::type;
+}
+
+/**
+ * 字典，记录一列数据中所有不同的值，并且为每一个值分配一个从0开始的连续整数编码
+ * 编码按照值第一次被插入的顺序进行分配，训练时用于对数据进行编码，预测时用于将输入转换为训练时的编码
+ *
+ * <p>值的类型如果可以使用 std::hash 进行哈希(并且重载了等于比较符)，查找使用哈希表，期望复杂度为O(1)；
+ * 否则使用红黑树，此时必须重载该类型的小于比较符</p>
+ */
+template<class ValueType>
+class Vocabulary {
+private:
+    std::vector<ValueType> _values; // 编码到原始值的映射，下标为编码
+    _vocabulary_self_use::code_map<ValueType> _codes; // 原始值到编码的映射
+
+public:
+    /**
+     * 向字典中插入一个值，如果该值已经存在则直接返回它的编码
+     * @param _value 需要插入的值
+     * @return 该值的编码
+     */
+    uint32_t insert(const ValueType& _value);
+
+    /**
+     * 查找一个值的编码
+     * @param _value 需要查找的值
+     * @param _code 该值的编码，仅在返回true时有效
+     * @return 如果该值在字典中则返回true，否则返回false
+     */
+    bool find(const ValueType& _value, uint32_t& _code) const;
+
+    /**
+     * 获取某一个编码对应的原始值
+     * @param _code 编码，必须小于 size()
+     * @return 该编码对应的原始值
+     */
+    const ValueType& value(uint32_t _code) const;
+
+    /**
+     * 获取所有的原始值，下标为编码
+     * @return 原始值的数组
+     */
+    const std::vector<ValueType>& values() const;
+
+    /**
+     * 获取字典中不同值的数量
+     * @return 字典的大小
+     */
+    size_t size() const;
+
+    /**
+     * 清空字典
+     */
+    void clear();
+};
+
+/**
+ * 向字典中插入一个值，如果该值已经存在则直接返回它的编码
+ * @param _value 需要插入的值
+ * @return 该值的编码
+ */
+template<class ValueType>
+uint32_t Vocabulary<ValueType>::insert(const ValueType &_value) {
+    auto result = this->_codes.insert(std::make_pair(_value, (uint32_t)this->_values.size()));
+    if (result.second) { // 第一次出现的值，分配一个新的编码
+        this->_values.push_back(_value);
+    }
+    return result.first->second;
+}
+
+/**
+ * 查找一个值的编码
+ * @param _value 需要查找的值
+ * @param _code 该值的编码，仅在返回true时有效
+ * @return 如果该值在字典中则返回true，否则返回false
+ */
+template<class ValueType>
+bool Vocabulary<ValueType>::find(const ValueType &_value, uint32_t &_code) const {
+    auto it = this->_codes.find(_value);
+    if (it == this->_codes.end()) {
+        return false;
+    }
+    _code = it->second;
+    return true;
+}
+
+template<class ValueType>
+const ValueType &Vocabulary<ValueType>::value(uint32_t _code) const {
+    return this->_values[_code];
+}
+
+template<class ValueType>
+const std::vector<ValueType> &Vocabulary<ValueType>::values() const {
+    return this->_values;
+}
+
+template<class ValueType>
+size_t Vocabulary<ValueType>::size() const {
+    return this->_values.size();
+}
+
+template<class ValueType>
+void Vocabulary<ValueType>::clear() {
+    this->_values.clear();
+    this->_codes.clear();
+}
+
+#endif //DESITIONTREE_VOCABULARY_H
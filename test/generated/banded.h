@@ -0,0 +1,39 @@
+// Generated from a trained decision tree, do not edit.
+
+#ifndef GENERATED_BANDED_GENERATED_H
+#define GENERATED_BANDED_GENERATED_H
+
+#include <cstddef>
+#include <limits>
+#include <string>
+
+static const std::size_t generated_banded_attribute_count = 2;
+
+static const char* const generated_banded_attribute_names[] = {
+    "color",
+    "x",
+};
+
+inline bool generated_banded(const double* _row, int& _result) {
+    if (static_cast<double>(3.0) < _row[1]) {
+        if (static_cast<double>(7.0) < _row[1]) {
+            _result = static_cast<int>(2ULL);
+            return true;
+        } else {
+            if (_row[0] == static_cast<double>(0.0)) {
+                _result = static_cast<int>(1ULL);
+                return true;
+            }
+            if (_row[0] == static_cast<double>(1.0)) {
+                _result = static_cast<int>(2ULL);
+                return true;
+            }
+            return false;
+        }
+    } else {
+        _result = static_cast<int>(0ULL);
+        return true;
+    }
+}
+
+#endif // GENERATED_BANDED_GENERATED_H
@@ -0,0 +1,36 @@
+// Generated from a trained decision tree, do not edit.
+
+#ifndef GENERATED_CLASSIFY_GENERATED_H
+#define GENERATED_CLASSIFY_GENERATED_H
+
+#include <cstddef>
+#include <limits>
+#include <string>
+
+static const std::size_t generated_classify_attribute_count = 2;
+
+static const char* const generated_classify_attribute_names[] = {
+    "handsome",
+    "height",
+};
+
+inline bool generated_classify(const int* _row, int& _result) {
+    switch (_row[1]) {
+    case static_cast<int>(0ULL): {
+        _result = static_cast<int>(0ULL);
+        return true;
+    }
+    case static_cast<int>(2ULL): {
+        _result = static_cast<int>(1ULL);
+        return true;
+    }
+    case static_cast<int>(1ULL): {
+        _result = static_cast<int>(1ULL);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+#endif // GENERATED_CLASSIFY_GENERATED_H
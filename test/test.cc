@@ -4,8 +4,24 @@
 
 #include "../src/decision_tree.h"
 #include "../src/decision_methods.h"
+#include "../src/code_generator.h"
+#include "../src/random_forest.h"
+#include "../src/gradient_boosting.h"
+#include "../src/hoeffding_tree.h"
+#include "generated/classify.h"
+#include "generated/banded.h"
 #include <map>
+#include <set>
+#include <sstream>
 #include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <unistd.h>
 using namespace std;
 
 // ·ݼ https://zhuanlan.zhihu.com/p/26596036
@@ -43,7 +59,11 @@ void test_decision_tree() {
     vector<string> _attribute_name_list = {"handsome", "height"};
     string temp1 = "prev";
     string temp2 = "KILC";
+    // ɵѵӿȻʹã֦
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
     temp.fit(_train_x, y, _attribute_name_list,false, temp1, temp2);
+#pragma GCC diagnostic pop
 
     std::map<string, int> test_x;
     vector<int> test_y;
@@ -51,11 +71,1120 @@ void test_decision_tree() {
     test_x["height"] = 0;
     temp.transform(test_x, test_y);
     cout << test_y[0] << endl;
+    // ѵʱûгֵֹӽڵûжӦѡ񣬲Ԥ
+    test_x["height"] = 5;
+    temp.transform(test_x, test_y);
+    assert(test_y.size() == 1);
+    // ȱʧԲᱻ뵽
+    test_x.erase("height");
+    temp.transform(test_x, test_y);
+    assert(test_x.size() == 1);
+    // ʹĬϵļ֦ʽѡ񷽷
+    temp.fit(_train_x, y, _attribute_name_list);
+    test_y.clear();
+    test_x["height"] = 0;
+    temp.transform(test_x, test_y);
+    assert(test_y.size() == 1 && test_y[0] == 0);
+    // ֻ֦صľɽӿڣĬϵѵͬ
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    temp.fit(_train_x, y, _attribute_name_list, true);
+    temp.fit(Dataset<int, int>(_train_x, y, _attribute_name_list), false);
+#pragma GCC diagnostic pop
+    test_y.clear();
+    temp.transform(test_x, test_y);
+    assert(test_y.size() == 1 && test_y[0] == 0);
+
+    // ظѵֵ׷ظ
+    map<string, vector<int>> refit_x = {{"a0", {0, 1, 2, 3}}, {"a1", {1, 1, 0, 0}}};
+    vector<int> refit_y = {0, 0, 1, 1};
+    vector<string> refit_names = {"a0", "a1"};
+    DecisionTree<int, int> refit;
+    refit.fit(refit_x, refit_y, refit_names);
+    size_t first_nodes = refit.compile().node_count();
+    refit.fit(refit_x, refit_y, refit_names);
+    size_t index;
+    assert(refit.find_attribute("a1", index) && index == 1 && !refit.find_attribute("a2", index));
+    assert(refit.compile().node_count() == first_nodes);
+    assert(refit.compile().leaf_values().size() == 2);
+}
+
+// ֱͼ(../src/histogram.h)
+void test_histogram() {
+    vector<uint32_t> x {0,0,0,2,0,0,2,1,1,2,0,0};
+    vector<uint32_t> y {0,0,1,1,0,0,1,1,1,1,0,0};
+    vector<uint32_t> rows {3,4,5,6,7};
+    Histogram histogram(3, 2);
+    histogram.build(x.data(), y.data(), rows.data(), rows.size());
+    assert(histogram.total() == 5 && histogram.count(0, 0) == 2 && histogram.count(2, 1) == 2);
+    assert(histogram.value_total(1) == 1 && histogram.class_total(1) == 3);
+    histogram.reset(3, 2);
+    histogram.build(x.data(), y.data(), x.size());
+    assert(fabs(histogram.conditional_entropy() - 0.103898) < 0.000001);
+    // ڵֱͼȥһӽڵֱͼһӽڵֱͼ
+    Histogram left(3, 2), right(3, 2);
+    vector<uint32_t> left_rows {0,1,2,3,4}, right_rows {5,6,7,8,9,10,11};
+    left.build(x.data(), y.data(), left_rows.data(), left_rows.size());
+    right.build(x.data(), y.data(), right_rows.data(), right_rows.size());
+    histogram.subtract(left);
+    assert(histogram.total() == right.total() && histogram.class_total(0) == right.class_total(0));
+    for(size_t value = 0; value < 3; ++ value) {
+        assert(histogram.value_total(value) == right.value_total(value));
+        assert(histogram.count(value, 0) == right.count(value, 0) && histogram.count(value, 1) == right.count(value, 1));
+    }
+    // мﵽ uint32_t ʱм룬֮ճ
+    Histogram online(2, 2);
+    uint32_t large[2] = {3000000000u, 1294967295u};
+    online.add(0, large);
+    online.increment(1, 1);
+    assert(online.count(0, 0) == 1500000000u && online.count(0, 1) == 647483647u && online.count(1, 1) == 1);
+    assert(online.total() == 2147483648u && online.value_total(0) == 2147483647u && online.class_total(1) == 647483648u);
+}
+
+// ֵ(../src/vocabulary.h)ֻṩСڱȽϷҲʹ
+struct Grade {
+    int level;
+    bool operator<(const Grade& other) const { return level < other.level; }
+};
+
+void test_vocabulary() {
+    Vocabulary<string> names;
+    assert(names.insert("b") == 0 && names.insert("a") == 1 && names.insert("b") == 0);
+    uint32_t code;
+    assert(names.find("a", code) && code == 1 && !names.find("c", code));
+    assert(names.size() == 2 && names.value(0) == "b");
+    Vocabulary<Grade> grades;
+    assert(grades.insert(Grade{3}) == 0 && grades.insert(Grade{1}) == 1 && grades.insert(Grade{3}) == 0);
+    assert(grades.find(Grade{1}, code) && code == 1);
+}
+
+//  n * ln(n) Ĳұ(../src/nlogn_table.h)Խ
+void test_nlogn_table() {
+    NLogNTable& table = NLogNTable::instance();
+    table.ensure(200000);
+    assert(table(0) == 0.0 && table(1) == 0.0);
+    assert(fabs(table(10) - 10 * log(10.0)) < 1e-9);
+    assert(fabs(table(199999) - 199999 * log(199999.0)) < 1e-6);
+    // ұ֮ļֱӼ n * ln(n)ұ
+    table.ensure((size_t)1 << 33);
+    const double large = 5e9;
+    assert(fabs(table((uint64_t)large) - large * log(large)) < 1e-6 * large);
+}
+
+// Աݼ(../src/dataset.h)
+void test_dataset() {
+    vector<int> handsome {1,0,1,0,1,1,1,0,1,0,1,1};
+    vector<int> height   {0,0,0,2,0,0,2,1,1,2,0,0};
+    vector<int> y        {0,0,1,1,0,0,1,1,1,1,0,0};
+    map<string, vector<int>> _train_x;
+    _train_x["handsome"] = handsome;
+    _train_x["height" ]  = height;
+    vector<string> _attribute_name_list = {"handsome", "height"};
+    Dataset<int, int> dataset(_train_x, y, _attribute_name_list);
+    assert(dataset.row_count() == 12);
+    assert(dataset.attribute_index("height") == 1);
+    assert(dataset.cardinality(1) == 3 && dataset.class_count() == 2);
+    // 밴յһγֵ˳з
+    assert(dataset.attribute_values(1)[1] == 2 && dataset.column(1)[3] == 1);
+    uint32_t code;
+    assert(dataset.encode_attribute(0, 0, code) && code == 1);
+    assert(!dataset.encode_attribute(0, 5, code));
+    vector<size_t> _attribute_index_list = {0, 1};
+    vector<uint32_t> rows;
+    for(uint32_t i = 0; i < 12; ++ i) rows.push_back(i);
+    assert(KILC_method(dataset, rows.data(), rows.size(), _attribute_index_list) == 1);
+    // ظᱻܾйͬһ
+    vector<string> duplicate_name_list = {"height", "handsome", "height"};
+    bool thrown = false;
+    try {
+        Dataset<int, int> duplicate(_train_x, y, duplicate_name_list);
+    } catch (const invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+// ԶľѵϵԤӦǩһ
+void test_decision_tree_depth() {
+    vector<int> a {0,0,0,0,1,1,1,1};
+    vector<int> b {0,0,1,1,0,0,1,1};
+    vector<int> c {0,1,0,1,0,1,0,1};
+    vector<int> y {0,0,0,0,0,0,1,1};
+    map<string, vector<int>> _train_x;
+    _train_x["a"] = a;
+    _train_x["b"] = b;
+    _train_x["c"] = c;
+    vector<string> _attribute_name_list = {"a", "b", "c"};
+    DecisionTree<int, int> tree;
+    tree.fit(Dataset<int, int>(_train_x, y, _attribute_name_list));
+    for(size_t i = 0; i < y.size(); ++ i) {
+        map<string, int> test_x {{"a", a[i]}, {"b", b[i]}, {"c", c[i]}};
+        vector<int> test_y;
+        tree.transform(test_x, test_y);
+        assert(test_y.size() == 1 && test_y[0] == y[i]);
+    }
+}
+
+// Զ߳ѵӦ뵥߳ѵͬ
+void test_parallel_fit() {
+    vector<int> a {0,0,0,0,1,1,1,1,0,1,1,0};
+    vector<int> b {0,0,1,1,0,0,1,1,1,0,1,0};
+    vector<int> c {0,1,0,1,0,1,0,1,1,1,0,0};
+    vector<int> y {0,0,0,0,0,0,1,1,0,0,1,0};
+    map<string, vector<int>> _train_x {{"a", a}, {"b", b}, {"c", c}};
+    vector<string> _attribute_name_list = {"a", "b", "c"};
+    Dataset<int, int> dataset(_train_x, y, _attribute_name_list);
+    vector<uint32_t> rows;
+    for(uint32_t i = 0; i < y.size(); ++ i) rows.push_back(i);
+    vector<size_t> _attribute_index_list = {0, 1, 2};
+    ThreadPool pool(4);
+    size_t serial = KILC_method(dataset, rows.data(), rows.size(), _attribute_index_list);
+    assert(KILC_method(dataset, rows.data(), rows.size(), _attribute_index_list, &pool) == serial);
+
+    DecisionTree<int, int> tree;
+    tree.set_thread_count(4);
+    tree.set_parallel_cutoff(1); // ÿһڵ㶼Ϊִ
+    assert(tree.thread_count() == 4);
+    tree.fit(dataset);
+    for(size_t i = 0; i < y.size(); ++ i) {
+        map<string, int> test_x {{"a", a[i]}, {"b", b[i]}, {"c", c[i]}};
+        vector<int> test_y;
+        tree.transform(test_x, test_y);
+        assert(test_y.size() == 1 && test_y[0] == y[i]);
+    }
+
+    // ׳쳣뿪̣߳ɺ wait ׳̳߳ȻԼʹ
+    std::atomic<size_t> finished(0);
+    bool thrown = false;
+    try {
+        ThreadPool::TaskGroup group(&pool);
+        for(int i = 0; i < 16; ++ i) {
+            group.run([i, &finished]() {
+                if (i % 4 == 1) {
+                    throw std::runtime_error("task failed");
+                }
+                ++ finished;
+            });
+        }
+        group.wait();
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown && finished.load() == 12);
+    std::atomic<size_t> sum(0);
+    pool.parallel_for(0, 100, [&sum](size_t index) { sum += index; });
+    assert(sum.load() == 4950);
+}
+
+// Աľ(../src/compiled_tree.h)ԤӦ transform ͬ
+void test_compiled_tree() {
+    vector<int> a {0,0,0,0,1,1,1,1,0,1,1,0};
+    vector<int> b {0,0,1,1,0,0,1,1,1,0,1,0};
+    vector<int> c {0,1,0,1,0,1,0,1,1,1,0,0};
+    vector<int> y {0,0,0,0,0,0,1,1,0,0,1,0};
+    map<string, vector<int>> _train_x {{"a", a}, {"b", b}, {"c", c}};
+    vector<string> _attribute_name_list = {"a", "b", "c"};
+    DecisionTree<int, int> tree;
+    tree.fit(Dataset<int, int>(_train_x, y, _attribute_name_list));
+    CompiledTree<int> compiled = tree.compile();
+    assert(compiled.node_count() > 1);
+    vector<uint32_t> codes;
+    for(size_t i = 0; i < y.size(); ++ i) {
+        map<string, int> test_x {{"a", a[i]}, {"b", b[i]}, {"c", c[i]}};
+        vector<int> test_y;
+        tree.transform(test_x, test_y);
+        tree.encode(test_x, codes);
+        uint32_t result = compiled.predict(codes.data());
+        assert(result != CompiledTree<int>::npos && compiled.result(result) == test_y[0]);
+    }
+    // ѵʱûгֵֹ޷Ԥ
+    map<string, int> unknown {{"a", 7}, {"b", 7}, {"c", 7}};
+    tree.encode(unknown, codes);
+    assert(compiled.predict(codes.data()) == CompiledTree<int>::npos);
+
+    // Ԥ⣬һ飬ӦԤͬ
+    map<string, vector<int>> _test_x;
+    for(size_t i = 0; i < 600; ++ i) {
+        _test_x["a"].push_back(a[i % 12]);
+        _test_x["b"].push_back(b[i % 12]);
+        _test_x["c"].push_back(i % 97 == 0 ? 7 : c[i % 12]);
+    }
+    vector<vector<uint32_t>> columns;
+    tree.encode(_test_x, columns);
+    vector<const uint32_t*> column_ptrs {columns[0].data(), columns[1].data(), columns[2].data()};
+    vector<uint32_t> results(600);
+    compiled.predict(column_ptrs.data(), results.size(), results.data());
+    for(size_t i = 0; i < 600; ++ i) {
+        uint32_t row[3] = {columns[0][i], columns[1][i], columns[2][i]};
+        assert(results[i] == compiled.predict(row));
+    }
+}
+
+// Ի׼(../src/split_criterion.h)Լʹòͬ׼ѵľ
+void test_split_criterion() {
+    vector<uint32_t> column {0,0,0,0,1,1,1,1};
+    vector<uint32_t> labels {0,0,0,1,1,1,1,1};
+    Histogram histogram(2, 2);
+    histogram.build(column.data(), labels.data(), column.size());
+    // ֵ0: (3, 1)ֵ1: (0, 4)
+    assert(fabs(GiniIndex::score(histogram) - 0.1875) < 1e-9);
+    double entropy = -(3.0 / 8 * log10(3.0 / 8) + 5.0 / 8 * log10(5.0 / 8));
+    double conditional_entropy = -0.5 * (3.0 / 4 * log10(3.0 / 4) + 1.0 / 4 * log10(1.0 / 4));
+    assert(fabs(InformationGain::score(histogram) - conditional_entropy) < 1e-9);
+    assert(fabs(GainRatio::score(histogram) + (entropy - conditional_entropy) / log10(2.0)) < 1e-9);
+
+    vector<int> a {0,0,0,0,1,1,1,1};
+    vector<int> b {0,0,1,1,0,0,1,1};
+    vector<int> c {0,1,0,1,0,1,0,1};
+    vector<int> y {0,0,0,0,0,0,1,1};
+    map<string, vector<int>> _train_x;
+    _train_x["a"] = a;
+    _train_x["b"] = b;
+    _train_x["c"] = c;
+    vector<string> _attribute_name_list = {"a", "b", "c"};
+    Dataset<int, int> dataset(_train_x, y, _attribute_name_list);
+    DecisionTree<int, int> gini_tree, ratio_tree, named_tree;
+    gini_tree.fit(dataset, GiniIndex());
+    ratio_tree.fit(dataset, GainRatio());
+    named_tree.fit(dataset, GINI_INDEX);
+    for(size_t i = 0; i < y.size(); ++ i) {
+        map<string, int> test_x {{"a", a[i]}, {"b", b[i]}, {"c", c[i]}};
+        vector<int> test_y;
+        gini_tree.transform(test_x, test_y);
+        ratio_tree.transform(test_x, test_y);
+        named_tree.transform(test_x, test_y);
+        assert(test_y.size() == 3 && test_y[0] == y[i] && test_y[1] == y[i] && test_y[2] == y[i]);
+    }
+    bool thrown = false;
+    try {
+        named_tree.fit(dataset, "UNKNOWN");
+    } catch (const invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+// ֵ͵ԣշλʹֵл
+void test_numeric_attribute() {
+    // ֵͬʱÿһֵԳΪһ䣬䰴ֵС
+    map<string, vector<double>> small_x {{"x", {3, 1, 2, 1}}};
+    vector<int> small_y {1, 0, 0, 0};
+    vector<string> small_name_list {"x"};
+    Dataset<double, int> small(small_x, small_y, small_name_list, set<string>{"x"});
+    assert(small.is_numeric(0) && small.cardinality(0) == 3);
+    assert(small.attribute_values(0)[0] == 1 && small.attribute_values(0)[2] == 3);
+    assert(small.bin_column(0)[0] == 2 && small.bin_column(0)[1] == 0 && small.bin_column(0)[2] == 1);
+    uint32_t code;
+    assert(small.encode_attribute(0, 2.5, code) && code == 2);
+    assert(small.encode_attribute(0, 100, code) && code == 2);
+    // Ԥʱ NaN ڵһ䣬ѵе NaN ޷򣬻ᱻܾ
+    assert(small.encode_attribute(0, NAN, code) && code == 0);
+    map<string, vector<double>> nan_x {{"x", {3, NAN, 2, 1}}};
+    bool thrown = false;
+    try {
+        Dataset<double, int> nan_dataset(nan_x, small_y, small_name_list, set<string>{"x"});
+    } catch (const invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    vector<double> x, color;
+    vector<int> y;
+    for(int i = 0; i < 1000; ++ i) {
+        double value = (i * 7919 % 1000) * 0.5;
+        x.push_back(value);
+        color.push_back(i % 3);
+        y.push_back(value <= 123.0 ? 0 : 1);
+    }
+    map<string, vector<double>> _train_x {{"x", x}, {"color", color}};
+    vector<string> _attribute_name_list = {"color", "x"};
+    Dataset<double, int> coarse(_train_x, y, _attribute_name_list, set<string>{"x"}, nullptr, 4);
+    assert(coarse.cardinality(1) == 4 && !coarse.is_numeric(0));
+    Dataset<double, int> dataset(_train_x, y, _attribute_name_list, set<string>{"x"});
+    assert((dataset.cardinality(1) <= Dataset<double, int>::MAX_BIN_COUNT && dataset.cardinality(1) > 200));
+    for(size_t i = 1; i < x.size(); ++ i) { // ֵĴСϵһ
+        assert((x[i - 1] < x[i]) == (dataset.bin_column(1)[i - 1] < dataset.bin_column(1)[i])
+               || dataset.bin_column(1)[i - 1] == dataset.bin_column(1)[i]);
+    }
+    DecisionTree<double, int> tree;
+    tree.fit(dataset, GiniIndex());
+    CompiledTree<int> compiled = tree.compile();
+    // ֻڿʼʱһΣ֮±깹һ
+    size_t x_index, color_index;
+    assert(tree.find_attribute("x", x_index) && tree.find_attribute("color", color_index));
+    assert(!tree.find_attribute("size", x_index) && x_index == 1 && color_index == 0);
+    size_t correct = 0;
+    for(size_t i = 0; i < x.size(); ++ i) {
+        map<string, double> test_x {{"x", x[i]}, {"color", color[i]}};
+        vector<int> test_y;
+        tree.transform(test_x, test_y);
+        vector<uint32_t> codes;
+        tree.encode(test_x, codes);
+        assert(compiled.result(compiled.predict(codes.data())) == test_y[0]);
+        uint32_t row[2];
+        row[x_index] = tree.encode(x_index, x[i]);
+        row[color_index] = tree.encode(color_index, color[i]);
+        int result;
+        assert(tree.predict(row, result) && result == test_y[0]);
+        correct += test_y[0] == y[i];
+    }
+    assert(correct >= 990);
+}
+
+// ڴϵʽݼѵ(../src/column_store.h)Ӧڴѵͬ
+void test_column_store_fit() {
+    char directory[] = "/tmp/decision_tree_test_XXXXXX";
+    assert(mkdtemp(directory) != nullptr);
+    vector<string> _attribute_name_list;
+    map<string, vector<int>> _train_x;
+    vector<int> y;
+    unsigned int seed = 7;
+    for(int j = 0; j < 6; ++ j) {
+        _attribute_name_list.push_back("f" + to_string(j));
+    }
+    for(int i = 0; i < 3000; ++ i) {
+        for(int j = 0; j < 6; ++ j) {
+            seed = seed * 1103515245u + 12345u;
+            _train_x["f" + to_string(j)].push_back((int)((seed >> 16) % (2 + j)));
+        }
+        seed = seed * 1103515245u + 12345u;
+        y.push_back((_train_x["f0"][i] + _train_x["f2"][i] + ((seed >> 16) % 8 == 0)) % 3);
+    }
+    {
+        ColumnStoreWriter<int, int> writer(directory, _attribute_name_list);
+        for(int begin = 0; begin < 3000; begin += 1000) { // д
+            map<string, vector<int>> batch_x;
+            for(const string& name: _attribute_name_list) {
+                batch_x[name].assign(_train_x[name].begin() + begin, _train_x[name].begin() + begin + 1000);
+            }
+            writer.append(batch_x, vector<int>(y.begin() + begin, y.begin() + begin + 1000));
+        }
+        writer.close();
+        ColumnStore store(directory);
+        assert(store.row_count() == 3000 && store.attribute_count() == 6 && store.cardinality(5) == 7);
+        DecisionTree<int, int> memory_tree, store_tree;
+        memory_tree.fit(Dataset<int, int>(_train_x, y, _attribute_name_list), InformationGain());
+        store_tree.set_thread_count(4);
+        store_tree.set_parallel_cutoff(1);
+        // СԤʹÿһ㱻ΪԼڵ
+        store_tree.fit(store, writer.vocabularies(), writer.result_vocabulary(), InformationGain(), 4096);
+        assert(memory_tree.compile().node_count() == store_tree.compile().node_count());
+        for(size_t i = 0; i < y.size(); ++ i) {
+            map<string, int> test_x;
+            for(const string& name: _attribute_name_list) {
+                test_x[name] = _train_x[name][i];
+            }
+            vector<int> memory_y, store_y;
+            memory_tree.transform(test_x, memory_y);
+            store_tree.transform(test_x, store_y);
+            assert(memory_y == store_y);
+        }
+
+        // Ԥ֦ѵʽͬ
+        size_t full_node_count = memory_tree.compile().node_count();
+        for(DecisionTree<int, int>* tree: {&memory_tree, &store_tree}) {
+            tree->set_max_depth(3);
+            tree->set_min_child_rows(20);
+            tree->set_min_improvement(0.001);
+        }
+        memory_tree.fit(Dataset<int, int>(_train_x, y, _attribute_name_list), InformationGain());
+        store_tree.fit(store, writer.vocabularies(), writer.result_vocabulary(), InformationGain(), 4096);
+        assert(memory_tree.compile().node_count() == store_tree.compile().node_count());
+        assert(memory_tree.compile().node_count() < full_node_count);
+
+        // ֵ뱣ͬһĿ¼УֻƾĿ¼ѵõͬģ
+        vector<Vocabulary<int>> vocabularies = store.vocabularies<int>();
+        assert(vocabularies.size() == 6);
+        for(int j = 0; j < 6; ++ j) {
+            assert(vocabularies[j].values() == writer.vocabularies()[j].values());
+        }
+        assert(store.result_vocabulary<int>().values() == writer.result_vocabulary().values());
+        DecisionTree<int, int> directory_tree;
+        directory_tree.fit(store, InformationGain(), 4096);
+        assert(directory_tree.compile().node_count() == full_node_count);
+    }
+
+    // ֵСıѵʱ֣дֱͼ֮
+    FILE* column = fopen((string(directory) + "/3.col").c_str(), "r+b");
+    uint32_t code = 1000;
+    fseek(column, 1500 * sizeof(uint32_t), SEEK_SET);
+    fwrite(&code, sizeof(code), 1, column);
+    fclose(column);
+    {
+        ColumnStore store(directory);
+        DecisionTree<int, int> tree;
+        bool thrown = false;
+        try {
+            tree.fit(store, InformationGain(), 4096);
+        } catch (const runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    for(int j = 0; j < 6; ++ j) {
+        remove((string(directory) + "/" + to_string(j) + ".col").c_str());
+    }
+    remove((string(directory) + "/labels.col").c_str());
+    remove((string(directory) + "/columns.meta").c_str());
+    remove((string(directory) + "/vocabularies.bin").c_str());
+    rmdir(directory);
+}
+
+// Խڵڴ(../src/node_arena.h)
+struct ArenaNode {
+    uint32_t _value;
+    ArenaNode* _next;
+    explicit ArenaNode(uint32_t _value): _value(_value), _next(nullptr) {}
+};
+
+void test_node_arena() {
+    NodeArena arena;
+    {
+        // λý(ͬ߳ͬʱֵ)ԵĶڴȻ
+        NodeArena::Local first(arena), second(arena);
+        ArenaNode* previous = nullptr;
+        size_t adjacent = 0;
+        for(uint32_t i = 0; i < 10000; ++ i) {
+            ArenaNode* node = first.create<ArenaNode>(i);
+            ArenaNode* other = second.create<ArenaNode>(i);
+            assert(((uintptr_t)node) % alignof(ArenaNode) == 0 && node->_value == i && other->_value == i);
+            adjacent += previous != nullptr && node == previous + 1;
+            previous = node;
+        }
+        assert(adjacent > 9800);
+        size_t* small = first.create_array<size_t>(3, 42);
+        size_t* large = first.create_array<size_t>(10000, 7); // һε鵥
+        assert(small[2] == 42 && large[0] == 7 && large[9999] == 7);
+        assert(first.create_array<size_t>(0, 0) == nullptr);
+    }
+    size_t capacity = arena.capacity();
+    arena.clear();
+    assert(arena.capacity() > 0 && arena.capacity() < capacity);
+    size_t retained = arena.capacity();
+    NodeArena::Local local(arena);
+    local.create<ArenaNode>(1);
+    assert(arena.capacity() == retained); // պñڴ
+    {
+        // ŵĴ֮ٷһθСĿ飬ʱĿһ
+        NodeArena oversized;
+        NodeArena::Local first(oversized), second(oversized);
+        first.create_array<size_t>(1 << 19, 0);
+        for(uint32_t i = 0; i < 1000; ++ i) {
+            second.create<ArenaNode>(i);
+        }
+        oversized.clear();
+        assert(oversized.capacity() >= (1 << 19) * sizeof(size_t));
+    }
+
+    // ѵͬһþڵÿһѵͷ
+    vector<int> a {0,0,0,0,1,1,1,1};
+    vector<int> b {0,0,1,1,0,0,1,1};
+    vector<int> y {0,0,0,1,0,1,1,1};
+    map<string, vector<int>> _train_x {{"a", a}, {"b", b}};
+    vector<string> _attribute_name_list = {"a", "b"};
+    Dataset<int, int> dataset(_train_x, y, _attribute_name_list);
+    DecisionTree<int, int> tree;
+    for(int round = 0; round < 3; ++ round) {
+        tree.fit(dataset, InformationGain());
+        vector<int> test_y;
+        map<string, int> test_x {{"a", 1}, {"b", 1}};
+        tree.transform(test_x, test_y);
+        assert(test_y.size() == 1 && test_y[0] == 1);
+    }
+    tree.clear();
+    assert(tree.compile().node_count() == 0);
+}
+
+// ԽģΪC++(../src/code_generator.h)
+void test_code_generator() {
+    vector<int> handsome {1,0,1,0,1,1,1,0,1,0,1,1};
+    vector<int> height   {0,0,0,2,0,0,2,1,1,2,0,0};
+    vector<int> y        {0,0,1,1,0,0,1,1,1,1,0,0};
+    map<string, vector<int>> _train_x {{"handsome", handsome}, {"height", height}};
+    vector<string> _attribute_name_list = {"handsome", "height"};
+    DecisionTree<int, int> tree;
+    tree.fit(Dataset<int, int>(_train_x, y, _attribute_name_list), InformationGain());
+    ostringstream code;
+    generate_code(tree.export_model(), "classify", code);
+    const string text = code.str();
+    assert(text.find("#ifndef CLASSIFY_GENERATED_H") != string::npos);
+    assert(text.find("inline bool classify(const int* _row, int& _result)") != string::npos);
+    assert(text.find("switch (_row[") != string::npos); // ʹ switch о
+    assert(text.find("\"height\",") != string::npos);
+
+    map<string, vector<double>> numeric_x {{"x", {1.5, 2.5, 3.5, 4.5}}};
+    vector<int> numeric_y {0, 0, 1, 1};
+    vector<string> numeric_name_list = {"x"};
+    DecisionTree<double, int> numeric_tree;
+    numeric_tree.fit(Dataset<double, int>(numeric_x, numeric_y, numeric_name_list, set<string>{"x"}), GiniIndex());
+    code.str("");
+    generate_code(numeric_tree.export_model(), "numeric", code);
+    // ֵ͵ֱֵӱȽϣֵΪѵʱķϽ
+    assert(code.str().find("if (static_cast<double>(2.5) < _row[0]) {") != string::npos);
+
+    // ûԵģͲɳΪ0
+    code.str("");
+    generate_code(TreeModel<int, int>(), "empty", code);
+    assert(code.str().find("empty_attribute_count = 0;") != string::npos);
+    assert(code.str().find("empty_attribute_names[] = {\n    nullptr,\n};") != string::npos);
+
+    // ./generated еͷļ generate_code ͬģɣԳԤӦģһ£
+    // ѵʱûгֵֹ(һ)
+    TreeModel<int, int> model = tree.export_model();
+    for(size_t i = 0; i <= y.size(); ++ i) {
+        int row[2] = {i < y.size() ? handsome[i] : 1, i < y.size() ? height[i] : 5};
+        map<string, int> test_x {{"handsome", row[0]}, {"height", row[1]}};
+        vector<int> test_y;
+        tree.transform(test_x, test_y);
+        int expected = -1, result = -1;
+        bool found = model.predict(test_x, expected);
+        assert(found == !test_y.empty() && (!found || expected == test_y[0]));
+        assert(generated_classify(row, result) == found && (!found || result == expected));
+    }
+    assert(generated_classify_attribute_count == 2 && string(generated_classify_attribute_names[1]) == "height");
+
+    // ֵ͵ÿһϽ缰ֵģһ£ɫ 0.5 ѵʱûгֹ
+    vector<double> band_x, band_color;
+    vector<int> band_y;
+    for(int i = 0; i < 40; ++ i) {
+        band_x.push_back(i * 0.5);
+        band_color.push_back(i % 2);
+        band_y.push_back(i * 0.5 <= 3.0 ? 0 : i * 0.5 <= 7.5 ? 1 + i % 2 : 2);
+    }
+    map<string, vector<double>> band_train_x {{"x", band_x}, {"color", band_color}};
+    vector<string> band_name_list = {"color", "x"};
+    Dataset<double, int> band_dataset(band_train_x, band_y, band_name_list, set<string>{"x"}, nullptr, 16);
+    DecisionTree<double, int> band_tree;
+    band_tree.fit(band_dataset, GiniIndex());
+    TreeModel<double, int> band_model = band_tree.export_model();
+    vector<double> probes {-1.0, 100.0};
+    for(double upper_bound: band_dataset.attribute_values(1)) {
+        probes.push_back(upper_bound);
+        probes.push_back(nextafter(upper_bound, -HUGE_VAL));
+        probes.push_back(nextafter(upper_bound, HUGE_VAL));
+    }
+    for(double probe: probes) {
+        for(double color: {0.0, 1.0, 0.5}) {
+            double row[2] = {color, probe};
+            map<string, double> test_x {{"color", color}, {"x", probe}};
+            vector<int> test_y;
+            band_tree.transform(test_x, test_y);
+            int expected = -1, result = -1;
+            bool found = band_model.predict(test_x, expected);
+            assert(found == !test_y.empty() && (!found || expected == test_y[0]));
+            assert(generated_banded(row, result) == found && (!found || result == expected));
+        }
+    }
+
+    bool thrown = false;
+    try {
+        generate_code(tree.export_model(), "not a name", code);
+    } catch (const invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+// ģ͵ı(../src/tree_model.h)غģӦԭľͬԤ
+void test_tree_model() {
+    char directory[] = "/tmp/decision_tree_test_XXXXXX";
+    assert(mkdtemp(directory) != nullptr);
+    const string numeric_path = string(directory) + "/numeric.model";
+    const string string_path = string(directory) + "/string.model";
+    const string broken_path = string(directory) + "/broken.model";
+
+    vector<double> x, color;
+    vector<int> y;
+    for(int i = 0; i < 500; ++ i) {
+        double value = (i * 7919 % 500) * 0.25;
+        x.push_back(value);
+        color.push_back(i % 3);
+        y.push_back(value <= 40.0 && i % 3 != 2 ? 0 : 1);
+    }
+    map<string, vector<double>> numeric_x {{"x", x}, {"color", color}};
+    vector<string> numeric_name_list = {"color", "x"};
+    DecisionTree<double, int> numeric_tree;
+    numeric_tree.fit(Dataset<double, int>(numeric_x, y, numeric_name_list, set<string>{"x"}), InformationGain());
+    numeric_tree.export_model().save(numeric_path);
+    TreeModel<double, int> numeric_model = TreeModel<double, int>::load(numeric_path);
+    assert(numeric_model.tree().node_count() == numeric_tree.compile().node_count());
+    for(size_t i = 0; i < x.size(); ++ i) {
+        map<string, double> test_x {{"x", x[i]}, {"color", color[i]}};
+        vector<int> test_y;
+        numeric_tree.transform(test_x, test_y);
+        int result;
+        assert(numeric_model.predict(test_x, result) && result == test_y[0]);
+    }
+
+    vector<string> outlook {"sunny", "sunny", "overcast", "rain", "rain", "rain", "overcast", "sunny"};
+    vector<string> windy {"false", "true", "false", "false", "true", "true", "true", "false"};
+    vector<string> play {"no", "no", "yes", "yes", "no", "no", "yes", "no"};
+    map<string, vector<string>> string_x {{"outlook", outlook}, {"windy", windy}};
+    vector<string> string_name_list = {"outlook", "windy"};
+    DecisionTree<string, string> string_tree;
+    string_tree.fit(Dataset<string, string>(string_x, play, string_name_list), InformationGain());
+    string_tree.export_model().save(string_path);
+    {
+        TreeModel<string, string> string_model = TreeModel<string, string>::load(string_path);
+        assert(string_model.attribute_count() == 2 && string_model.attribute_name(0) == "outlook");
+        for(size_t i = 0; i < play.size(); ++ i) {
+            map<string, string> test_x {{"outlook", outlook[i]}, {"windy", windy[i]}};
+            vector<string> test_y;
+            string_tree.transform(test_x, test_y);
+            string result;
+            assert(string_model.predict(test_x, result) && result == test_y[0]);
+        }
+        string result;
+        assert(!string_model.predict({{"outlook", "snow"}, {"windy", "true"}}, result));
+    }
+
+    // ضϵļ޷
+    FILE* source = fopen(string_path.c_str(), "rb");
+    FILE* broken = fopen(broken_path.c_str(), "wb");
+    char buffer[100];
+    fwrite(buffer, 1, fread(buffer, 1, sizeof(buffer), source), broken);
+    fclose(source);
+    fclose(broken);
+    bool thrown = false;
+    try {
+        TreeModel<string, string>::load(broken_path);
+    } catch (const runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // α볤ȶȷԽļͬ޷
+    ifstream numeric_file(numeric_path, ios::binary);
+    const string original((istreambuf_iterator<char>(numeric_file)), istreambuf_iterator<char>());
+    auto section_offset = [&original](size_t _section) {
+        uint64_t offset;
+        memcpy(&offset, original.data() + 64 + _section * 16, sizeof(offset));
+        return (size_t)offset;
+    };
+    auto rejected = [&](size_t _position, uint64_t _value, size_t _bytes) {
+        string content = original;
+        memcpy(&content[_position], &_value, _bytes);
+        ofstream file(broken_path, ios::binary | ios::trunc);
+        file.write(content.data(), (streamsize)content.size());
+        file.close();
+        try {
+            TreeModel<double, int>::load(broken_path);
+        } catch (const runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+    const size_t node_count = numeric_model.tree().node_count();
+    assert(rejected(section_offset(0), 7, sizeof(uint32_t))); // ڵߵв
+    assert(rejected(section_offset(1), 1u << 30, sizeof(uint32_t))); // ӽڵԽ
+    assert(rejected(section_offset(4), node_count, sizeof(uint32_t))); // ӽڵԽ
+    assert(rejected(section_offset(4), 0, sizeof(uint32_t))); // ӽڵָڵγɻ
+    for(size_t node = 0; node < node_count; ++ node) {
+        size_t position = section_offset(3) + node * sizeof(uint32_t);
+        if (original.compare(position, sizeof(uint32_t), string(sizeof(uint32_t), '\xff')) != 0) {
+            assert(rejected(position, 1000, sizeof(uint32_t))); // ֵ
+            break;
+        }
+    }
+    for(size_t node = 0; node < node_count; ++ node) {
+        if (numeric_model.tree().arrays().feature[node] == CompiledTree<int>::npos) {
+            assert(rejected(section_offset(1) + node * sizeof(uint32_t), 2, sizeof(uint32_t))); // Խ
+            break;
+        }
+    }
+    uint64_t name_bytes;
+    memcpy(&name_bytes, original.data() + 64 + 5 * 16 + 8, sizeof(name_bytes));
+    assert(rejected(section_offset(5), name_bytes / 8 - 1, sizeof(uint64_t))); // λóεĳ
+    assert(!rejected(section_offset(0), 0, 0));
+
+    remove(numeric_path.c_str());
+    remove(string_path.c_str());
+    remove(broken_path.c_str());
+    rmdir(directory);
+}
+
+// ѵ̵ͳ(../src/train_stats.h)ûпͳʱֵΪ0
+void test_train_stats() {
+    vector<int> handsome {1,0,1,0,1,1,1,0,1,0,1,1};
+    vector<int> height   {0,0,0,2,0,0,2,1,1,2,0,0};
+    vector<int> y        {0,0,1,1,0,0,1,1,1,1,0,0};
+    map<string, vector<int>> _train_x {{"handsome", handsome}, {"height", height}};
+    vector<string> _attribute_name_list = {"handsome", "height"};
+    DecisionTree<int, int> tree;
+    tree.fit(_train_x, y, _attribute_name_list);
+    const TrainStats& stats = tree.stats();
+#ifdef DESITIONTREE_ENABLE_STATS
+    assert(stats.node_count == tree.compile().node_count());
+    assert(stats.leaf_count > 0 && stats.leaf_count < stats.node_count);
+    assert(stats.max_depth >= 1 && stats.max_depth <= 2);
+    assert(stats.rows_scanned >= y.size());
+    assert(stats.bytes_copied > 0 && stats.tree_bytes > 0);
+#else
+    assert(stats.node_count == 0 && stats.leaf_count == 0 && stats.rows_scanned == 0 && stats.tree_bytes == 0);
+#endif
+    tree.clear();
+    assert(tree.stats().node_count == 0);
+}
+
+// ɭ(../src/random_forest.h)ͬӵõ߳޹صɭ֣ͶƱܹѵ
+void test_random_forest() {
+    map<string, vector<int>> _train_x;
+    vector<string> _attribute_name_list;
+    for(int j = 0; j < 6; ++ j) {
+        _attribute_name_list.push_back("a" + to_string(j));
+        vector<int>& column = _train_x[_attribute_name_list.back()];
+        for(int i = 0; i < 600; ++ i) {
+            column.push_back((i * (j + 3) + i / (j + 1)) % 4);
+        }
+    }
+    vector<int> y;
+    for(int i = 0; i < 600; ++ i) {
+        y.push_back((_train_x["a0"][i] + _train_x["a1"][i]) % 3 == 0 ? 1 : 0);
+    }
+    Dataset<int, int> dataset(_train_x, y, _attribute_name_list);
+    RandomForest<int, int> serial, parallel;
+    serial.set_tree_count(16);
+    serial.set_seed(7);
+    serial.fit(dataset, InformationGain());
+    parallel.set_tree_count(16);
+    parallel.set_seed(7);
+    parallel.set_thread_count(4);
+    parallel.fit(_train_x, y, _attribute_name_list);
+    assert(serial.size() == 16 && parallel.size() == 16);
+    for(size_t index = 0; index < serial.size(); ++ index) {
+        assert(serial.tree(index).node_count() == parallel.tree(index).node_count());
+    }
+    size_t correct = 0;
+    for(size_t i = 0; i < y.size(); ++ i) {
+        map<string, int> test_x;
+        for(const string& name: _attribute_name_list) {
+            test_x[name] = _train_x[name][i];
+        }
+        vector<int> serial_y, parallel_y;
+        serial.transform(test_x, serial_y);
+        parallel.transform(test_x, parallel_y);
+        assert(serial_y.size() == 1 && serial_y == parallel_y);
+        correct += serial_y[0] == y[i];
+    }
+    assert(correct * 10 >= y.size() * 9);
+
+    // ÿһֻʹУͬӵõͬ
+    RandomForest<int, int> other;
+    other.set_tree_count(16);
+    other.set_seed(8);
+    other.fit(dataset, InformationGain());
+    bool different = false;
+    for(size_t index = 0; index < other.size(); ++ index) {
+        different = different || other.tree(index).node_count() != serial.tree(index).node_count();
+    }
+    assert(different);
+
+    // ˳ԤԤͬĴСԼ߳޹
+    vector<vector<uint32_t>> codes(_attribute_name_list.size(), vector<uint32_t>(y.size()));
+    vector<uint32_t> row;
+    vector<int> expected(y.size());
+    for(size_t i = 0; i < y.size(); ++ i) {
+        map<string, int> test_x;
+        for(const string& name: _attribute_name_list) {
+            test_x[name] = _train_x[name][i];
+        }
+        serial.encode(test_x, row);
+        for(size_t j = 0; j < row.size(); ++ j) {
+            codes[j][i] = row[j];
+        }
+        assert(serial.predict(row.data(), expected[i]));
+    }
+    codes[0][5] = CompiledTree<int>::npos; // δֵ֪
+    row.clear();
+    for(size_t j = 0; j < codes.size(); ++ j) {
+        row.push_back(codes[j][5]);
+    }
+    bool predicted = serial.predict(row.data(), expected[5]);
+    vector<const uint32_t*> columns;
+    for(const vector<uint32_t>& column: codes) {
+        columns.push_back(column.data());
+    }
+    vector<uint32_t> results(y.size());
+    parallel.predict(columns.data(), y.size(), results.data());
+    parallel.set_block_rows(256);
+    vector<uint32_t> block_results(y.size());
+    parallel.predict(columns.data(), y.size(), block_results.data());
+    assert(results == block_results);
+    assert(predicted == (results[5] != CompiledTree<int>::npos));
+    for(size_t i = 0; i < y.size(); ++ i) {
+        assert(results[i] == CompiledTree<int>::npos ? i == 5 : parallel.result_vocabulary().value(results[i]) == expected[i]);
+    }
+
+    vector<int> unknown_y;
+    serial.transform({{"a0", 9}, {"a1", 9}, {"a2", 9}, {"a3", 9}, {"a4", 9}, {"a5", 9}}, unknown_y);
+    assert(unknown_y.empty());
+}
+
+// ݶ(../src/gradient_boosting.h)ƽϷֶγĿ꣬ʧϿɷֵĶ
+void test_gradient_boosting() {
+    vector<double> x, color, target, label;
+    for(int i = 0; i < 1000; ++ i) {
+        x.push_back((i * 7919 % 1000) * 0.1);
+        color.push_back(i % 3);
+        target.push_back((x.back() < 30.0 ? 1.0 : x.back() < 70.0 ? 5.0 : 2.0) + (color.back() == 1 ? 3.0 : 0.0));
+        label.push_back(x.back() > 50.0 ? 1.0 : 0.0);
+    }
+    map<string, vector<double>> _train_x {{"x", x}, {"color", color}};
+    vector<string> _attribute_name_list = {"x", "color"};
+    GradientBoosting<double, double> serial, parallel;
+    serial.set_tree_count(60);
+    serial.set_learning_rate(0.3);
+    serial.fit(_train_x, target, _attribute_name_list, set<string>{"x"});
+    parallel.set_tree_count(60);
+    parallel.set_learning_rate(0.3);
+    parallel.set_thread_count(3);
+    parallel.fit(_train_x, target, _attribute_name_list, set<string>{"x"});
+    assert(serial.size() == 60 && serial.node_count() == parallel.node_count());
+    assert(sizeof(BoostedNode) == 16);
+
+    vector<vector<uint32_t>> codes(2, vector<uint32_t>(x.size()));
+    vector<uint32_t> row;
+    double error = 0.0;
+    for(size_t i = 0; i < x.size(); ++ i) {
+        serial.encode({{"x", x[i]}, {"color", color[i]}}, row);
+        codes[0][i] = row[0];
+        codes[1][i] = row[1];
+        double prediction = serial.predict(row.data());
+        assert(prediction == parallel.predict(row.data()));
+        error += (prediction - target[i]) * (prediction - target[i]);
+    }
+    assert(error / x.size() < 0.05);
+    // ˳ԤԤͬ
+    const uint32_t* columns[] = {codes[0].data(), codes[1].data()};
+    vector<double> results(x.size());
+    parallel.predict(columns, x.size(), results.data());
+    for(size_t i = 0; i < x.size(); ++ i) {
+        row = {codes[0][i], codes[1][i]};
+        assert(fabs(results[i] - serial.predict(row.data())) < 1e-9);
+    }
+    // ȱʧֵҲܸԤ
+    vector<double> missing_y;
+    serial.transform({{"x", 10.0}}, missing_y);
+    assert(missing_y.size() == 1);
+
+    GradientBoosting<double, double, LogisticLoss> classifier;
+    classifier.set_tree_count(30);
+    classifier.fit(_train_x, label, _attribute_name_list, set<string>{"x"});
+    size_t correct = 0;
+    for(size_t i = 0; i < x.size(); ++ i) {
+        vector<double> probability;
+        classifier.transform({{"x", x[i]}, {"color", color[i]}}, probability);
+        assert(probability[0] > 0.0 && probability[0] < 1.0);
+        correct += (probability[0] > 0.5) == (label[i] == 1.0);
+    }
+    assert(correct == x.size());
+    bool thrown = false;
+    try {
+        classifier.fit(_train_x, target, _attribute_name_list, set<string>{"x"});
+    } catch (const invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void test_hoeffding_tree() {
+    vector<string> _attribute_name_list = {"a0", "a1", "a2", "a3"};
+    uint32_t state = 12345;
+    auto next = [&state]() {
+        state = state * 1103515245u + 12345u;
+        return (int)((state >> 16) % 4);
+    };
+    auto make_batch = [&](size_t _row_count, map<string, vector<int>>& _batch_x, vector<int>& _batch_y) {
+        _batch_x.clear();
+        _batch_y.clear();
+        for(size_t i = 0; i < _row_count; ++ i) {
+            for(const string& name: _attribute_name_list) {
+                _batch_x[name].push_back(next());
+            }
+            int a0 = _batch_x["a0"].back(), a1 = _batch_x["a1"].back();
+            _batch_y.push_back(a0 < 2 ? a1 % 2 : 2);
+        }
+    };
+    HoeffdingTree<int, int> tree(_attribute_name_list);
+    map<string, vector<int>> batch_x;
+    vector<int> batch_y;
+    for(int batch = 0; batch < 20; ++ batch) {
+        make_batch(500, batch_x, batch_y);
+        tree.partial_fit(batch_x, batch_y);
+    }
+    assert(tree.row_count() == 10000);
+    assert(tree.leaf_count() > 1 && tree.node_count() > tree.leaf_count());
+    make_batch(1000, batch_x, batch_y);
+    size_t correct = 0;
+    for(size_t i = 0; i < batch_y.size(); ++ i) {
+        map<string, int> test_x;
+        for(const string& name: _attribute_name_list) {
+            test_x[name] = batch_x[name][i];
+        }
+        vector<int> test_y;
+        tree.transform(test_x, test_y);
+        assert(test_y.size() == 1);
+        correct += test_y[0] == batch_y[i];
+    }
+    assert(correct * 100 >= batch_y.size() * 95);
+
+    // ڵﵽ޺ֻ¼ٻ
+    HoeffdingTree<int, int, GiniIndex> bounded(_attribute_name_list);
+    bounded.set_max_leaves(4);
+    bounded.set_grace_period(50);
+    for(int batch = 0; batch < 20; ++ batch) {
+        make_batch(500, batch_x, batch_y);
+        bounded.partial_fit(batch_x, batch_y);
+        assert(bounded.leaf_count() <= 4);
+    }
+    // ﵽ޺ֱͼȫͷţ֮(³ֵֵ)ڴ
+    size_t memory = bounded.memory_bytes();
+    assert(bounded.leaf_count() == 4 && memory < bounded.node_count() * 1024);
+    for(int batch = 0; batch < 40; ++ batch) {
+        make_batch(500, batch_x, batch_y);
+        if (batch % 2 == 1) {
+            for(int& value: batch_x["a2"]) {
+                value += 4 * batch; // ÿһµֵ
+            }
+        }
+        bounded.partial_fit(batch_x, batch_y);
+        assert(bounded.leaf_count() == 4 && bounded.memory_bytes() == memory);
+    }
+    assert(bounded.row_count() == 30000);
+
+    bool thrown = false;
+    try {
+        batch_x.erase("a3");
+        tree.partial_fit(batch_x, batch_y);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void test_pre_pruning() {
+    vector<string> _attribute_name_list;
+    map<string, vector<int>> _train_x;
+    vector<int> y;
+    unsigned int seed = 11;
+    for(int j = 0; j < 6; ++ j) {
+        _attribute_name_list.push_back("a" + to_string(j));
+    }
+    for(int i = 0; i < 2000; ++ i) {
+        for(const string& name: _attribute_name_list) {
+            seed = seed * 1103515245u + 12345u;
+            _train_x[name].push_back((int)((seed >> 16) % 4));
+        }
+        seed = seed * 1103515245u + 12345u;
+        y.push_back((_train_x["a0"][i] + _train_x["a1"][i] + ((seed >> 16) % 5 == 0)) % 3); // 
+    }
+    Dataset<int, int> dataset(_train_x, y, _attribute_name_list);
+    // ľõڵԼÿڵӵеѵݵ
+    auto inspect = [&](const DecisionTree<int, int>& _tree, size_t& _leaves, size_t& _max_depth, size_t& _min_rows) {
+        CompiledTree<int> compiled = _tree.compile();
+        typename CompiledTree<int>::Arrays arrays = compiled.arrays();
+        const uint32_t npos = CompiledTree<int>::npos;
+        _leaves = 0;
+        _max_depth = 0;
+        vector<pair<uint32_t, size_t>> stack {{0, 0}};
+        while (!stack.empty()) {
+            uint32_t node = stack.back().first;
+            size_t depth = stack.back().second;
+            stack.pop_back();
+            if (arrays.feature[node] == npos) {
+                ++ _leaves;
+                _max_depth = max(_max_depth, depth);
+                continue;
+            }
+            for(uint32_t code = 0; code < arrays.child_count[node]; ++ code) {
+                if (arrays.children[arrays.offset[node] + code] != npos) {
+                    stack.emplace_back(arrays.children[arrays.offset[node] + code], depth + 1);
+                }
+            }
+        }
+        map<uint32_t, size_t> rows_of_leaf;
+        vector<uint32_t> row(_attribute_name_list.size());
+        for(size_t i = 0; i < y.size(); ++ i) {
+            for(size_t j = 0; j < row.size(); ++ j) {
+                row[j] = dataset.column(j)[i];
+            }
+            uint32_t node = 0;
+            while (arrays.feature[node] != npos) {
+                node = arrays.children[arrays.offset[node] + row[arrays.feature[node]]];
+            }
+            ++ rows_of_leaf[node];
+        }
+        _min_rows = y.size();
+        for(const pair<const uint32_t, size_t>& leaf: rows_of_leaf) {
+            _min_rows = min(_min_rows, leaf.second);
+        }
+    };
+    size_t leaves, depth, min_rows;
+    DecisionTree<int, int> full;
+    full.fit(dataset, InformationGain());
+    size_t full_leaves;
+    inspect(full, full_leaves, depth, min_rows);
+    assert(depth > 2 && min_rows < 20);
+
+    DecisionTree<int, int> shallow;
+    shallow.set_max_depth(2);
+    shallow.fit(dataset, InformationGain());
+    inspect(shallow, leaves, depth, min_rows);
+    assert(depth == 2 && leaves < full_leaves);
+
+    DecisionTree<int, int> wide;
+    wide.set_min_child_rows(20);
+    wide.fit(dataset, GiniIndex());
+    inspect(wide, leaves, depth, min_rows);
+    assert(min_rows >= 20 && leaves < full_leaves);
+
+    DecisionTree<int, int> stump;
+    stump.set_min_split_rows(y.size() + 1);
+    stump.fit(dataset, InformationGain());
+    assert(stump.compile().node_count() == 1);
+    stump.set_min_split_rows(0);
+    stump.set_min_improvement(1.0); // 10Ϊ׵زlog10(3)
+    stump.fit(dataset, InformationGain());
+    assert(stump.compile().node_count() == 1);
+    stump.set_min_improvement(0.01);
+    stump.fit(dataset, InformationGain());
+    inspect(stump, leaves, depth, min_rows);
+    assert(leaves > 1 && leaves < full_leaves);
+
+    // ڵޣ߳޹
+    DecisionTree<int, int> serial, parallel;
+    serial.set_max_leaves(12);
+    serial.fit(dataset, InformationGain());
+    parallel.set_max_leaves(12);
+    parallel.set_thread_count(4);
+    parallel.set_parallel_cutoff(1);
+    parallel.fit(dataset, InformationGain());
+    inspect(serial, leaves, depth, min_rows);
+    assert(leaves <= 12 && leaves > 4);
+    assert(serial.compile().node_count() == parallel.compile().node_count());
 }
 
 int main () {
     test_gain();
+    test_histogram();
+    test_nlogn_table();
+    test_vocabulary();
+    test_dataset();
     test_KILC_method();
+    test_split_criterion();
     test_decision_tree();
+    test_decision_tree_depth();
+    test_parallel_fit();
+    test_node_arena();
+    test_compiled_tree();
+    test_numeric_attribute();
+    test_column_store_fit();
+    test_tree_model();
+    test_code_generator();
+    test_train_stats();
+    test_random_forest();
+    test_gradient_boosting();
+    test_hoeffding_tree();
+    test_pre_pruning();
     return 0;
 }
\ No newline at end of file